@@ -0,0 +1,105 @@
+#include <random>
+#include <set>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "business_calendar.h"
+
+// 2000-2049年每年10个随机节假日
+static const std::vector<datetime::date>& holidays() {
+  static std::vector<datetime::date> data = [] {
+    std::vector<datetime::date> v;
+    std::mt19937 rng(42);
+    int first = datetime::date(2000, 1, 1).toordinal();
+    int last = datetime::date(2049, 12, 31).toordinal();
+    std::uniform_int_distribution<int> ord(first, last);
+    for (int i = 0; i < 500; ++i) {
+      v.push_back(datetime::date::fromordinal(ord(rng)));
+    }
+    return v;
+  }();
+  return data;
+}
+
+// 跨度不超过state.range(0)年的随机区间
+static std::vector<std::pair<datetime::date, datetime::date>> ranges(int years) {
+  std::vector<std::pair<datetime::date, datetime::date>> v;
+  std::mt19937 rng(7);
+  int first = datetime::date(2000, 1, 1).toordinal();
+  std::uniform_int_distribution<int> begin(first, first + 365 * 5);
+  std::uniform_int_distribution<int> span(0, years * 365);
+  for (int i = 0; i < 1024; ++i) {
+    int b = begin(rng);
+    v.emplace_back(datetime::date::fromordinal(b), datetime::date::fromordinal(b + span(rng)));
+  }
+  return v;
+}
+
+static void BM_BusinessDaysBetween(benchmark::State& state) {
+  datetime::business_calendar cal(holidays());
+  auto data = ranges(state.range(0));
+  for (auto _ : state) {
+    long total = 0;
+    for (const auto& [b, e] : data) {
+      total += cal.business_days_between(b, e);
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_BusinessDaysBetween)->Arg(1)->Arg(10)->Arg(40);
+
+// weekday() + std::set<date>逐日判断
+static void BM_BusinessDaysBetweenSet(benchmark::State& state) {
+  std::set<datetime::date> hs(holidays().begin(), holidays().end());
+  auto data = ranges(state.range(0));
+  data.erase(data.begin() + 64, data.end());
+  for (auto _ : state) {
+    long total = 0;
+    for (const auto& [b, e] : data) {
+      for (auto d = b; d < e; d += datetime::timedelta(1)) {
+        total += d.weekday() < 5 && hs.count(d) == 0;
+      }
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_BusinessDaysBetweenSet)->Arg(1)->Arg(10)->Arg(40);
+
+static void BM_IsBusinessDay(benchmark::State& state) {
+  datetime::business_calendar cal(holidays());
+  auto data = ranges(1);
+  for (auto _ : state) {
+    long total = 0;
+    for (const auto& [b, e] : data) {
+      total += cal.is_business_day(b);
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_IsBusinessDay);
+
+static void BM_AddBusinessDays(benchmark::State& state) {
+  datetime::business_calendar cal(holidays());
+  auto data = ranges(1);
+  int n = state.range(0);
+  for (auto _ : state) {
+    int total = 0;
+    for (const auto& [b, e] : data) {
+      total += cal.add_business_days(b, n).day();
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_AddBusinessDays)->Arg(-5)->Arg(1)->Arg(250)->Arg(2500);
+
+static void BM_BusinessCalendarConstruct(benchmark::State& state) {
+  for (auto _ : state) {
+    datetime::business_calendar cal(holidays());
+    benchmark::DoNotOptimize(cal);
+  }
+}
+BENCHMARK(BM_BusinessCalendarConstruct);
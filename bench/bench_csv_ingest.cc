@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "benchmark/benchmark.h"
+#include "csv_ingest.h"
+#include "datetime.h"
+
+static constexpr std::size_t kNumRows = 1 << 20;
+static const char* kFormat = "%Y-%m-%d %H:%M:%S.%f";
+
+// 约1M行、60MB的成交数据：时间,代码,价格,数量
+static const std::string& csv() {
+  static std::string data = [] {
+    std::string s = "time,symbol,price,volume\n";
+    std::mt19937_64 rng(1);
+    long long t = datetime::datetime(2024, 1, 2, 9, 30).utctimestamp().count();
+    for (std::size_t i = 0; i < kNumRows; ++i) {
+      t += static_cast<long long>(rng() % 2000);
+      auto dt = datetime::datetime::utcfromtimestamp(std::chrono::microseconds{t});
+      s += dt.strftime(kFormat);
+      s += ",600000.SH,10.25,";
+      s += std::to_string(rng() % 10000);
+      s += '\n';
+    }
+    return s;
+  }();
+  return data;
+}
+
+static void BM_CsvIngest(benchmark::State& state) {
+  const auto& data = csv();
+  datetime::csv_ingest ingest({{0, kFormat}}, ',', true, static_cast<unsigned>(state.range(0)));
+  for (auto _ : state) {
+    auto result = ingest.parse(data);
+    benchmark::DoNotOptimize(result.timestamps.data());
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+BENCHMARK(BM_CsvIngest)
+    ->RangeMultiplier(2)
+    ->Range(1, std::max(4u, std::thread::hardware_concurrency()))
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/* 对照：逐行拷贝出时间字段并调用datetime::strptime */
+static void BM_CsvStrptimePerRow(benchmark::State& state) {
+  const auto& data = csv();
+  std::vector<long long> out(kNumRows);
+  for (auto _ : state) {
+    std::size_t pos = data.find('\n') + 1;
+    std::size_t row = 0;
+    while (pos < data.size()) {
+      std::size_t eol = data.find('\n', pos);
+      std::string line = data.substr(pos, eol - pos);
+      std::string field = line.substr(0, line.find(','));
+      out[row++] = datetime::datetime::strptime(field, kFormat).utctimestamp().count();
+      pos = eol + 1;
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+BENCHMARK(BM_CsvStrptimePerRow)->Unit(benchmark::kMillisecond);
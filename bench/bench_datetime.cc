@@ -0,0 +1,781 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "datetime.h"
+#include "perf_counters.h"
+
+static constexpr std::size_t kDataSize = 4096;
+static constexpr std::size_t kMask = kDataSize - 1;
+
+// 1970-2050年之间均匀分布的datetime，约一半的微秒数为0
+static const std::vector<datetime::datetime>& datetimes() {
+  static std::vector<datetime::datetime> data = [] {
+    std::vector<datetime::datetime> v;
+    std::mt19937_64 rng(42);
+    long long first = datetime::datetime(1970, 1, 2).utctimestamp().count();
+    long long last = datetime::datetime(2050, 1, 1).utctimestamp().count();
+    std::uniform_int_distribution<long long> us(first, last);
+    for (std::size_t i = 0; i < kDataSize; ++i) {
+      long long t = us(rng);
+      if (i % 2) {
+        t -= t % 1000000;
+      }
+      v.push_back(datetime::datetime::utcfromtimestamp(std::chrono::microseconds{t}));
+    }
+    return v;
+  }();
+  return data;
+}
+
+static const std::vector<datetime::date>& dates() {
+  static std::vector<datetime::date> data = [] {
+    std::vector<datetime::date> v;
+    for (const auto& dt : datetimes()) {
+      v.push_back(dt.date());
+    }
+    return v;
+  }();
+  return data;
+}
+
+static const std::vector<datetime::time>& times() {
+  static std::vector<datetime::time> data = [] {
+    std::vector<datetime::time> v;
+    for (const auto& dt : datetimes()) {
+      v.push_back(dt.time());
+    }
+    return v;
+  }();
+  return data;
+}
+
+// 从1us到数千天不等的间隔，正负各半
+static const std::vector<datetime::timedelta>& timedeltas() {
+  static std::vector<datetime::timedelta> data = [] {
+    std::vector<datetime::timedelta> v;
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<int> exp(0, 38);
+    for (std::size_t i = 0; i < kDataSize; ++i) {
+      long long us = static_cast<long long>(rng() % (1ULL << exp(rng))) + 1;
+      v.emplace_back(std::chrono::microseconds{i % 2 ? us : -us});
+    }
+    return v;
+  }();
+  return data;
+}
+
+static std::vector<std::string> formatted(const char* fmt) {
+  std::vector<std::string> v;
+  for (const auto& dt : datetimes()) {
+    v.push_back(dt.strftime(fmt));
+  }
+  return v;
+}
+
+/* ---------------------------------------------------------------------------
+ * Construction
+ */
+
+static void BM_DateConstruct(benchmark::State& state) {
+  const auto& data = dates();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const auto& d = data[i++ & kMask];
+    benchmark::DoNotOptimize(datetime::date(d.year(), d.month(), d.day()));
+  }
+}
+BENCHMARK(BM_DateConstruct);
+
+static void BM_TimeConstruct(benchmark::State& state) {
+  const auto& data = times();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const auto& t = data[i++ & kMask];
+    benchmark::DoNotOptimize(datetime::time(t.hour(), t.minute(), t.second(), t.microsecond()));
+  }
+}
+BENCHMARK(BM_TimeConstruct);
+
+static void BM_DatetimeConstruct(benchmark::State& state) {
+  const auto& data = datetimes();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const auto& dt = data[i++ & kMask];
+    benchmark::DoNotOptimize(datetime::datetime(dt.year(), dt.month(), dt.day(), dt.hour(),
+                                                dt.minute(), dt.second(), dt.microsecond()));
+  }
+}
+BENCHMARK(BM_DatetimeConstruct);
+
+static void BM_DatetimeConstructInvalid(benchmark::State& state) {
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    try {
+      benchmark::DoNotOptimize(datetime::datetime(2021, 2, 29));
+    } catch (const std::out_of_range&) {
+    }
+  }
+}
+BENCHMARK(BM_DatetimeConstructInvalid);
+
+/* 列式的字段，由datetimes()重复得到，约1%的行有一个字段超出范围(包括平年的2月29日) */
+struct Columns {
+  std::vector<int> fields[7];
+  std::size_t rows() const { return fields[0].size(); }
+};
+
+static Columns columns(std::size_t rows) {
+  Columns c;
+  const auto& data = datetimes();
+  std::mt19937_64 rng(3);
+  for (auto& f : c.fields) {
+    f.reserve(rows);
+  }
+  for (std::size_t i = 0; i < rows; ++i) {
+    const auto& dt = data[i & kMask];
+    int f[7] = {dt.year(),   dt.month(),  dt.day(),        dt.hour(),
+                dt.minute(), dt.second(), dt.microsecond()};
+    if (rng() % 100 == 0) {
+      switch (rng() % 4) {
+        case 0:
+          f[0] = 2021;
+          f[1] = 2;
+          f[2] = 29;
+          break;
+        case 1:
+          f[1] = 13;
+          break;
+        case 2:
+          f[3] = 24;
+          break;
+        default:
+          f[6] = -1;
+          break;
+      }
+    }
+    for (int k = 0; k < 7; ++k) {
+      c.fields[k].push_back(f[k]);
+    }
+  }
+  return c;
+}
+
+/* 逐行构造，不合法的行抛出异常。items_per_second为每秒处理的行数 */
+static void BM_DatetimeConstructColumns(benchmark::State& state) {
+  auto c = columns(state.range(0));
+  std::vector<datetime::datetime> out(c.rows(), datetime::datetime::min());
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < c.rows(); ++i) {
+      try {
+        out[i] = datetime::datetime(c.fields[0][i], c.fields[1][i], c.fields[2][i], c.fields[3][i],
+                                    c.fields[4][i], c.fields[5][i], c.fields[6][i]);
+      } catch (const std::out_of_range&) {
+        out[i] = datetime::datetime::min();
+      }
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * c.rows());
+}
+BENCHMARK(BM_DatetimeConstructColumns)->Arg(1 << 20)->Arg(1 << 24);
+
+static void BM_DatetimeValidateAndBuild(benchmark::State& state) {
+  auto c = columns(state.range(0));
+  std::vector<datetime::datetime> out(c.rows(), datetime::datetime::min());
+  std::vector<uint8_t> valid((c.rows() + 7) / 8);
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::validate_and_build(
+        c.fields[0].data(), c.fields[1].data(), c.fields[2].data(), c.fields[3].data(),
+        c.fields[4].data(), c.fields[5].data(), c.fields[6].data(), c.rows(), out.data(),
+        valid.data()));
+  }
+  state.SetItemsProcessed(state.iterations() * c.rows());
+}
+BENCHMARK(BM_DatetimeValidateAndBuild)->Arg(1 << 20)->Arg(1 << 24);
+
+static void BM_TimedeltaConstruct(benchmark::State& state) {
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    int n = static_cast<int>(i++ & kMask);
+    benchmark::DoNotOptimize(datetime::timedelta(n, n * 37, n * 1013, n * 7, n, n, 1));
+  }
+}
+BENCHMARK(BM_TimedeltaConstruct);
+
+static void BM_DateFromordinal(benchmark::State& state) {
+  const auto& data = dates();
+  std::vector<int> ordinals;
+  for (const auto& d : data) {
+    ordinals.push_back(d.toordinal());
+  }
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::date::fromordinal(ordinals[i++ & kMask]));
+  }
+}
+BENCHMARK(BM_DateFromordinal);
+
+static void BM_DatetimeCombine(benchmark::State& state) {
+  const auto& ds = dates();
+  const auto& ts = times();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    std::size_t k = i++ & kMask;
+    benchmark::DoNotOptimize(datetime::datetime::combine(ds[k], ts[k]));
+  }
+}
+BENCHMARK(BM_DatetimeCombine);
+
+/* ---------------------------------------------------------------------------
+ * Parsing
+ */
+
+static void BM_DatetimeStrptime(benchmark::State& state) {
+  auto data = formatted("%Y-%m-%d %H:%M:%S.%f");
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        datetime::datetime::strptime(data[i++ & kMask], "%Y-%m-%d %H:%M:%S.%f"));
+  }
+}
+BENCHMARK(BM_DatetimeStrptime);
+
+static void BM_DatetimeStrptimeDate(benchmark::State& state) {
+  auto data = formatted("%Y%m%d");
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::datetime::strptime(data[i++ & kMask], "%Y%m%d"));
+  }
+}
+BENCHMARK(BM_DatetimeStrptimeDate);
+
+/* 同一个字段重复8次，后面的覆盖前面的，用于比较不同宽度的字段：2为%H，4为%Y，6为%f。
+ * items_per_second为每秒解析的字段数(不含前面的日期)
+ */
+static void BM_StrptimeField(benchmark::State& state) {
+  const char* field = state.range(0) == 2 ? "%H" : state.range(0) == 4 ? "%Y" : "%f";
+  std::string fmt = "%Y-%m-%d ";
+  for (int k = 0; k < 8; ++k) {
+    fmt += field;
+  }
+  auto data = formatted(fmt.c_str());
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  long long ts;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::strptime_timestamp(data[i++ & kMask], fmt, &ts));
+  }
+  state.SetItemsProcessed(state.iterations() * 8);
+}
+BENCHMARK(BM_StrptimeField)->Arg(2)->Arg(4)->Arg(6);
+
+static void BM_DateFromisoformat(benchmark::State& state) {
+  auto data = formatted("%Y-%m-%d");
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::date::fromisoformat(data[i++ & kMask]));
+  }
+}
+BENCHMARK(BM_DateFromisoformat);
+
+static void BM_TimeFromisoformat(benchmark::State& state) {
+  auto data = formatted("%H:%M:%S.%f");
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::time::fromisoformat(data[i++ & kMask]));
+  }
+}
+BENCHMARK(BM_TimeFromisoformat);
+
+/* ---------------------------------------------------------------------------
+ * Formatting
+ */
+
+static void BM_DatetimeStrftime(benchmark::State& state) {
+  const auto& data = datetimes();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].strftime("%Y-%m-%d %H:%M:%S.%f"));
+  }
+}
+BENCHMARK(BM_DatetimeStrftime);
+
+static void BM_DatetimeStrftimeNames(benchmark::State& state) {
+  const auto& data = datetimes();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].strftime("%a %d %b %Y %I:%M %p %j %U %W"));
+  }
+}
+BENCHMARK(BM_DatetimeStrftimeNames);
+
+static void BM_DatetimeStrftimeWeek(benchmark::State& state) {
+  const auto& data = datetimes();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].strftime("%j %U %W"));
+  }
+}
+BENCHMARK(BM_DatetimeStrftimeWeek);
+
+static void BM_DatetimeStr(benchmark::State& state) {
+  const auto& data = datetimes();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].str());
+  }
+}
+BENCHMARK(BM_DatetimeStr);
+
+/* 写入栈上的缓冲区，不分配内存 */
+static void BM_DatetimeStrBuffer(benchmark::State& state) {
+  const auto& data = datetimes();
+  char buf[datetime::datetime::kMaxStrSize];
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].str(buf));
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_DatetimeStrBuffer);
+
+static void BM_DatetimeCtime(benchmark::State& state) {
+  const auto& data = datetimes();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].ctime());
+  }
+}
+BENCHMARK(BM_DatetimeCtime);
+
+static void BM_DateIsoformat(benchmark::State& state) {
+  const auto& data = dates();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].isoformat());
+  }
+}
+BENCHMARK(BM_DateIsoformat);
+
+static void BM_TimeIsoformat(benchmark::State& state) {
+  const auto& data = times();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].isoformat());
+  }
+}
+BENCHMARK(BM_TimeIsoformat);
+
+static void BM_TimedeltaStr(benchmark::State& state) {
+  const auto& data = timedeltas();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].str());
+  }
+}
+BENCHMARK(BM_TimedeltaStr);
+
+/* ---------------------------------------------------------------------------
+ * Timestamps
+ */
+
+static void BM_DatetimeNow(benchmark::State& state) {
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::datetime::now());
+  }
+}
+BENCHMARK(BM_DatetimeNow);
+
+static void BM_DateToday(benchmark::State& state) {
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::date::today());
+  }
+}
+BENCHMARK(BM_DateToday);
+
+static void BM_DatetimeFromtimestamp(benchmark::State& state) {
+  std::vector<std::chrono::microseconds> data;
+  for (const auto& dt : datetimes()) {
+    data.push_back(dt.utctimestamp());
+  }
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::datetime::fromtimestamp(data[i++ & kMask]));
+  }
+}
+BENCHMARK(BM_DatetimeFromtimestamp);
+
+static void BM_DatetimeTimestamp(benchmark::State& state) {
+  const auto& data = datetimes();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].timestamp());
+  }
+}
+BENCHMARK(BM_DatetimeTimestamp);
+
+static void BM_DatetimeUtcfromtimestamp(benchmark::State& state) {
+  std::vector<std::chrono::microseconds> data;
+  for (const auto& dt : datetimes()) {
+    data.push_back(dt.utctimestamp());
+  }
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::datetime::utcfromtimestamp(data[i++ & kMask]));
+  }
+}
+BENCHMARK(BM_DatetimeUtcfromtimestamp);
+
+static void BM_DatetimeUtctimestamp(benchmark::State& state) {
+  const auto& data = datetimes();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].utctimestamp());
+  }
+}
+BENCHMARK(BM_DatetimeUtctimestamp);
+
+/* ---------------------------------------------------------------------------
+ * std::chrono
+ */
+
+static void BM_DatetimeFromSysTime(benchmark::State& state) {
+  std::vector<std::chrono::sys_time<std::chrono::microseconds>> data;
+  for (const auto& dt : datetimes()) {
+    data.emplace_back(dt.utctimestamp());
+  }
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::datetime(data[i++ & kMask]));
+  }
+}
+BENCHMARK(BM_DatetimeFromSysTime);
+
+static void BM_DatetimeToSysTime(benchmark::State& state) {
+  const auto& data = datetimes();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        static_cast<std::chrono::sys_time<std::chrono::microseconds>>(data[i++ & kMask]));
+  }
+}
+BENCHMARK(BM_DatetimeToSysTime);
+
+static void BM_DatetimeSysTimeRoundTrip(benchmark::State& state) {
+  const auto& data = datetimes();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    std::chrono::sys_time<std::chrono::microseconds> tp = data[i++ & kMask];
+    benchmark::DoNotOptimize(datetime::datetime(tp));
+  }
+}
+BENCHMARK(BM_DatetimeSysTimeRoundTrip);
+
+static void BM_DateSysDaysRoundTrip(benchmark::State& state) {
+  const auto& data = dates();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    std::chrono::sys_days days = data[i++ & kMask];
+    benchmark::DoNotOptimize(datetime::date(days));
+  }
+}
+BENCHMARK(BM_DateSysDaysRoundTrip);
+
+static void BM_TimedeltaToMicroseconds(benchmark::State& state) {
+  const auto& data = timedeltas();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(static_cast<std::chrono::microseconds>(data[i++ & kMask]));
+  }
+}
+BENCHMARK(BM_TimedeltaToMicroseconds);
+
+/* ---------------------------------------------------------------------------
+ * Arithmetic
+ */
+
+static void BM_TimedeltaAdd(benchmark::State& state) {
+  const auto& data = timedeltas();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    std::size_t k = i++;
+    benchmark::DoNotOptimize(data[k & kMask] + data[(k + 1) & kMask]);
+  }
+}
+BENCHMARK(BM_TimedeltaAdd);
+
+static void BM_TimedeltaSub(benchmark::State& state) {
+  const auto& data = timedeltas();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    std::size_t k = i++;
+    benchmark::DoNotOptimize(data[k & kMask] - data[(k + 1) & kMask]);
+  }
+}
+BENCHMARK(BM_TimedeltaSub);
+
+static void BM_TimedeltaMul(benchmark::State& state) {
+  const auto& data = timedeltas();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask] * 3);
+  }
+}
+BENCHMARK(BM_TimedeltaMul);
+
+static void BM_TimedeltaDiv(benchmark::State& state) {
+  const auto& data = timedeltas();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask] / 3);
+  }
+}
+BENCHMARK(BM_TimedeltaDiv);
+
+static void BM_TimedeltaTotalSeconds(benchmark::State& state) {
+  const auto& data = timedeltas();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].total_seconds());
+  }
+}
+BENCHMARK(BM_TimedeltaTotalSeconds);
+
+static void BM_DateAddTimedelta(benchmark::State& state) {
+  const auto& data = dates();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    std::size_t k = i++ & kMask;
+    benchmark::DoNotOptimize(data[k] + datetime::timedelta(static_cast<int>(k)));
+  }
+}
+BENCHMARK(BM_DateAddTimedelta);
+
+static void BM_DateSubDate(benchmark::State& state) {
+  const auto& data = dates();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    std::size_t k = i++;
+    benchmark::DoNotOptimize(data[k & kMask] - data[(k + 1) & kMask]);
+  }
+}
+BENCHMARK(BM_DateSubDate);
+
+static void BM_DatetimeAddTimedelta(benchmark::State& state) {
+  const auto& data = datetimes();
+  const auto& deltas = timedeltas();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    std::size_t k = i++ & kMask;
+    benchmark::DoNotOptimize(data[k] + deltas[k]);
+  }
+}
+BENCHMARK(BM_DatetimeAddTimedelta);
+
+static void BM_DatetimeAddSmallTimedelta(benchmark::State& state) {
+  const auto& data = datetimes();
+  datetime::timedelta delta(0, 0, 500);
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask] + delta);
+  }
+}
+BENCHMARK(BM_DatetimeAddSmallTimedelta);
+
+static void BM_DatetimeSubTimedelta(benchmark::State& state) {
+  const auto& data = datetimes();
+  const auto& deltas = timedeltas();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    std::size_t k = i++ & kMask;
+    benchmark::DoNotOptimize(data[k] - deltas[k]);
+  }
+}
+BENCHMARK(BM_DatetimeSubTimedelta);
+
+static void BM_DatetimeSubDatetime(benchmark::State& state) {
+  const auto& data = datetimes();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    std::size_t k = i++;
+    benchmark::DoNotOptimize(data[k & kMask] - data[(k + 1) & kMask]);
+  }
+}
+BENCHMARK(BM_DatetimeSubDatetime);
+
+/* ---------------------------------------------------------------------------
+ * Calendar
+ */
+
+static void BM_DateToordinal(benchmark::State& state) {
+  const auto& data = dates();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].toordinal());
+  }
+}
+BENCHMARK(BM_DateToordinal);
+
+static void BM_DateWeekday(benchmark::State& state) {
+  const auto& data = dates();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].weekday());
+  }
+}
+BENCHMARK(BM_DateWeekday);
+
+static void BM_DateIsocalendar(benchmark::State& state) {
+  const auto& data = dates();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].isocalendar());
+  }
+}
+BENCHMARK(BM_DateIsocalendar);
+
+/* 一次计算kDataSize个序数，items_per_second为每秒计算的日期数 */
+static void BM_DateIsocalendarBatch(benchmark::State& state) {
+  std::vector<int> ordinals;
+  for (const auto& d : dates()) {
+    ordinals.push_back(d.toordinal());
+  }
+  std::vector<datetime::IsoCalendarDate> out(ordinals.size());
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    datetime::isocalendar(ordinals.data(), ordinals.size(), out.data());
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ordinals.size());
+}
+BENCHMARK(BM_DateIsocalendarBatch);
+
+static void BM_DateFromisocalendar(benchmark::State& state) {
+  std::vector<datetime::IsoCalendarDate> data;
+  for (const auto& d : dates()) {
+    data.push_back(d.isocalendar());
+  }
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::date::fromisocalendar(data[i++ & kMask]));
+  }
+}
+BENCHMARK(BM_DateFromisocalendar);
+
+/* ---------------------------------------------------------------------------
+ * Comparison, hashing and sorting
+ */
+
+static void BM_DatetimeCompare(benchmark::State& state) {
+  const auto& data = datetimes();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    std::size_t k = i++;
+    benchmark::DoNotOptimize(data[k & kMask] < data[(k + 1) & kMask]);
+  }
+}
+BENCHMARK(BM_DatetimeCompare);
+
+static void BM_DateHash(benchmark::State& state) {
+  const auto& data = dates();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::hash<datetime::date>{}(data[i++ & kMask]));
+  }
+}
+BENCHMARK(BM_DateHash);
+
+static void BM_TimeHash(benchmark::State& state) {
+  const auto& data = times();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::hash<datetime::time>{}(data[i++ & kMask]));
+  }
+}
+BENCHMARK(BM_TimeHash);
+
+static void BM_DatetimeHash(benchmark::State& state) {
+  const auto& data = datetimes();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::hash<datetime::datetime>{}(data[i++ & kMask]));
+  }
+}
+BENCHMARK(BM_DatetimeHash);
+
+static void BM_TimedeltaHash(benchmark::State& state) {
+  const auto& data = timedeltas();
+  PerfCounters perf(state);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::hash<datetime::timedelta>{}(data[i++ & kMask]));
+  }
+}
+BENCHMARK(BM_TimedeltaHash);
+
+static void BM_DatetimeSort(benchmark::State& state) {
+  const auto& data = datetimes();
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto v = data;
+    state.ResumeTiming();
+    std::sort(v.begin(), v.end());
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_DatetimeSort);
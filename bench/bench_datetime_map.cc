@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "datetime.h"
+#include "datetime_flat_map.h"
+#include "datetime_hash_map.h"
+
+static constexpr std::size_t kNumTicks = 1 << 16;
+static constexpr std::size_t kMask = kNumTicks - 1;
+
+using StdMap = std::map<datetime::datetime, double>;
+using StdHashMap = std::unordered_map<datetime::datetime, double>;
+using FlatMap = datetime::datetime_flat_map<datetime::datetime, double>;
+using HashMap = datetime::datetime_hash_map<datetime::datetime, double>;
+
+// 按时间递增的tick时间，间隔1us~2ms
+static const std::vector<datetime::datetime>& ticks() {
+  static std::vector<datetime::datetime> v = [] {
+    std::vector<datetime::datetime> v;
+    std::mt19937_64 rng(1);
+    long long t = datetime::datetime(2024, 1, 2, 9, 30).utctimestamp().count();
+    for (std::size_t i = 0; i < kNumTicks; ++i) {
+      t += 1 + static_cast<long long>(rng() % 2000);
+      v.push_back(datetime::datetime::utcfromtimestamp(std::chrono::microseconds{t}));
+    }
+    return v;
+  }();
+  return v;
+}
+
+/* 按时间顺序插入 */
+template <class Map>
+static void BM_MapInsertMonotonic(benchmark::State& state) {
+  const auto& data = ticks();
+  for (auto _ : state) {
+    Map map;
+    for (const auto& dt : data) {
+      map[dt] = 1.0;
+    }
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK_TEMPLATE(BM_MapInsertMonotonic, StdMap);
+BENCHMARK_TEMPLATE(BM_MapInsertMonotonic, StdHashMap);
+BENCHMARK_TEMPLATE(BM_MapInsertMonotonic, FlatMap);
+BENCHMARK_TEMPLATE(BM_MapInsertMonotonic, HashMap);
+
+/* 乱序插入，flat_map需要移动元素 */
+template <class Map>
+static void BM_MapInsertRandom(benchmark::State& state) {
+  auto data = ticks();
+  std::shuffle(data.begin(), data.end(), std::mt19937_64(2));
+  for (auto _ : state) {
+    Map map;
+    for (const auto& dt : data) {
+      map[dt] = 1.0;
+    }
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK_TEMPLATE(BM_MapInsertRandom, StdMap);
+BENCHMARK_TEMPLATE(BM_MapInsertRandom, StdHashMap);
+BENCHMARK_TEMPLATE(BM_MapInsertRandom, FlatMap);
+BENCHMARK_TEMPLATE(BM_MapInsertRandom, HashMap);
+
+/* 随机查找已存在的key */
+template <class Map>
+static void BM_MapLookup(benchmark::State& state) {
+  const auto& data = ticks();
+  Map map;
+  for (const auto& dt : data) {
+    map[dt] = 1.0;
+  }
+  std::vector<datetime::datetime> keys = data;
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(3));
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.contains(keys[i++ & kMask]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_MapLookup, StdMap);
+BENCHMARK_TEMPLATE(BM_MapLookup, StdHashMap);
+BENCHMARK_TEMPLATE(BM_MapLookup, FlatMap);
+BENCHMARK_TEMPLATE(BM_MapLookup, HashMap);
+
+/* 把tick按秒聚合为bar，同一个key被连续访问 */
+template <class Map>
+static void BM_MapBarAccumulate(benchmark::State& state) {
+  std::vector<datetime::datetime> bars;
+  for (const auto& dt : ticks()) {
+    bars.push_back(datetime::datetime(dt.year(), dt.month(), dt.day(), dt.hour(), dt.minute(),
+                                      dt.second()));
+  }
+  for (auto _ : state) {
+    Map map;
+    for (const auto& bar : bars) {
+      map[bar] += 1.0;
+    }
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * bars.size());
+}
+BENCHMARK_TEMPLATE(BM_MapBarAccumulate, StdMap);
+BENCHMARK_TEMPLATE(BM_MapBarAccumulate, StdHashMap);
+BENCHMARK_TEMPLATE(BM_MapBarAccumulate, FlatMap);
+BENCHMARK_TEMPLATE(BM_MapBarAccumulate, HashMap);
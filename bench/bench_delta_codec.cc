@@ -0,0 +1,91 @@
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "datetime.h"
+#include "delta_codec.h"
+
+static constexpr std::size_t kNumTicks = 1 << 20;
+
+// 0: 固定间隔1ms的tick
+// 1: 间隔1ms，带±100us的抖动
+// 2: 间隔为指数分布、平均1ms的tick，相当于成交数据
+static const std::vector<long long>& ticks(int kind) {
+  static std::vector<long long> data[3];
+  auto& v = data[kind];
+  if (v.empty()) {
+    std::mt19937_64 rng(kind);
+    std::uniform_int_distribution<long long> jitter(-100, 100);
+    std::exponential_distribution<double> gap(1.0 / 1000);
+    long long t = datetime::datetime(2024, 1, 2, 9, 30).utctimestamp().count();
+    for (std::size_t i = 0; i < kNumTicks; ++i) {
+      v.push_back(t);
+      if (kind == 0) {
+        t += 1000;
+      } else if (kind == 1) {
+        t += 1000 + jitter(rng);
+      } else {
+        t += 1 + static_cast<long long>(gap(rng));
+      }
+    }
+  }
+  return v;
+}
+
+static const char* kKindNames[] = {"regular", "jittered", "poisson"};
+
+/* ratio: 相对于8字节epoch-us的压缩比，bytes_per_second按未压缩的8字节计算 */
+static void set_counters(benchmark::State& state, std::size_t encoded_size) {
+  state.SetLabel(kKindNames[state.range(0)]);
+  state.SetBytesProcessed(state.iterations() * kNumTicks * sizeof(long long));
+  state.counters["bytes/value"] = static_cast<double>(encoded_size) / kNumTicks;
+  state.counters["ratio"] = static_cast<double>(kNumTicks * sizeof(long long)) / encoded_size;
+}
+
+static void BM_DeltaEncode(benchmark::State& state) {
+  const auto& data = ticks(static_cast<int>(state.range(0)));
+  datetime::delta_encoder enc;
+  std::size_t encoded_size = 0;
+  for (auto _ : state) {
+    enc.clear();
+    enc.append(data.data(), data.size());
+    encoded_size = enc.finish().size();
+    benchmark::DoNotOptimize(encoded_size);
+  }
+  set_counters(state, encoded_size);
+}
+BENCHMARK(BM_DeltaEncode)->DenseRange(0, 2);
+
+static void BM_DeltaDecode(benchmark::State& state) {
+  const auto& data = ticks(static_cast<int>(state.range(0)));
+  datetime::delta_encoder enc;
+  enc.append(data.data(), data.size());
+  const auto& bytes = enc.finish();
+  std::vector<long long> out(data.size());
+  for (auto _ : state) {
+    datetime::delta_decoder dec(bytes);
+    benchmark::DoNotOptimize(dec.next(out.data(), out.size()));
+    benchmark::ClobberMemory();
+  }
+  set_counters(state, bytes.size());
+}
+BENCHMARK(BM_DeltaDecode)->DenseRange(0, 2);
+
+/* 对照：把datetime逐个转换为epoch-us再编码 */
+static void BM_DeltaEncodeDatetime(benchmark::State& state) {
+  const auto& data = ticks(1);
+  std::vector<datetime::datetime> dts;
+  for (auto t : data) {
+    dts.push_back(datetime::datetime::utcfromtimestamp(std::chrono::microseconds{t}));
+  }
+  datetime::delta_encoder enc;
+  for (auto _ : state) {
+    enc.clear();
+    for (const auto& dt : dts) {
+      enc.append(dt);
+    }
+    benchmark::DoNotOptimize(enc.finish().size());
+  }
+  state.SetItemsProcessed(state.iterations() * dts.size());
+}
+BENCHMARK(BM_DeltaEncodeDatetime);
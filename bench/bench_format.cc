@@ -0,0 +1,152 @@
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "datetime.h"
+#include "perf_counters.h"
+
+static constexpr std::size_t kNumRows = 1 << 16;
+static const char* kFormat = "%Y-%m-%d %H:%M:%S.%f";
+
+// 1970-2050年之间均匀分布的datetime，约一半的微秒数为0
+static const std::vector<datetime::datetime>& rows() {
+  static std::vector<datetime::datetime> data = [] {
+    std::vector<datetime::datetime> v;
+    std::mt19937_64 rng(49);
+    long long first = datetime::datetime(1970, 1, 2).utctimestamp().count();
+    long long last = datetime::datetime(2050, 1, 1).utctimestamp().count();
+    std::uniform_int_distribution<long long> us(first, last);
+    for (std::size_t i = 0; i < kNumRows; ++i) {
+      long long t = us(rng);
+      if (i % 2) {
+        t -= t % 1000000;
+      }
+      v.push_back(datetime::datetime::utcfromtimestamp(std::chrono::microseconds{t}));
+    }
+    return v;
+  }();
+  return data;
+}
+
+/* 记录分配次数，其余转发给upstream */
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+      : upstream_(upstream) {}
+
+  std::size_t allocations() const { return allocations_; }
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations_;
+    return upstream_->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+    upstream_->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource* upstream_;
+  std::size_t allocations_ = 0;
+};
+
+/* 每次迭代格式化全部kNumRows行，items_per_second为每秒格式化的行数，allocs_per_item为每行的分配次数 */
+static void set_counters(benchmark::State& state, std::size_t allocations) {
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+  state.counters["allocs_per_item"] =
+      static_cast<double>(allocations) / static_cast<double>(state.iterations() * kNumRows);
+}
+
+/* 以下benchmark的参数：0为str()，1为strftime(kFormat) */
+
+/* 逐个调用，每个结果是一个std::string。结果超过SSO的长度，每行分配一次 */
+static void BM_FormatPerCallString(benchmark::State& state) {
+  const auto& data = rows();
+  std::vector<std::string> out(kNumRows);
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < kNumRows; ++i) {
+      out[i] = state.range(0) == 0 ? data[i].str() : data[i].strftime(kFormat);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+BENCHMARK(BM_FormatPerCallString)->Arg(0)->Arg(1);
+
+/* 逐个调用pmr重载，resource为new_delete_resource时与std::string相同，用于统计分配次数 */
+static void BM_FormatPerCallPmr(benchmark::State& state) {
+  const auto& data = rows();
+  CountingResource counting;
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    std::pmr::vector<std::pmr::string> out(&counting);
+    out.reserve(kNumRows);
+    for (std::size_t i = 0; i < kNumRows; ++i) {
+      out.push_back(state.range(0) == 0 ? data[i].str(&counting)
+                                        : data[i].strftime(kFormat, &counting));
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  set_counters(state, counting.allocations());
+}
+BENCHMARK(BM_FormatPerCallPmr)->Arg(0)->Arg(1);
+
+/* 逐个调用pmr重载，所有结果从同一个monotonic_buffer_resource分配 */
+static void BM_FormatPerCallArena(benchmark::State& state) {
+  const auto& data = rows();
+  CountingResource counting;
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    std::pmr::monotonic_buffer_resource arena(kNumRows * 64, &counting);
+    std::pmr::vector<std::pmr::string> out(&arena);
+    out.reserve(kNumRows);
+    for (std::size_t i = 0; i < kNumRows; ++i) {
+      out.push_back(state.range(0) == 0 ? data[i].str(&arena) : data[i].strftime(kFormat, &arena));
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  set_counters(state, counting.allocations());
+}
+BENCHMARK(BM_FormatPerCallArena)->Arg(0)->Arg(1);
+
+/* 批量格式化到新的StringColumn */
+static void BM_FormatColumn(benchmark::State& state) {
+  const auto& data = rows();
+  CountingResource counting;
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    datetime::StringColumn out(&counting);
+    if (state.range(0) == 0) {
+      datetime::str(data.data(), kNumRows, &out);
+    } else {
+      datetime::strftime(data.data(), kNumRows, kFormat, &out);
+    }
+    benchmark::DoNotOptimize(out.chars.data());
+  }
+  set_counters(state, counting.allocations());
+}
+BENCHMARK(BM_FormatColumn)->Arg(0)->Arg(1);
+
+/* 批量格式化，clear()后重复使用同一个StringColumn，稳定后不再分配 */
+static void BM_FormatColumnReuse(benchmark::State& state) {
+  const auto& data = rows();
+  CountingResource counting;
+  datetime::StringColumn out(&counting);
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    out.clear();
+    if (state.range(0) == 0) {
+      datetime::str(data.data(), kNumRows, &out);
+    } else {
+      datetime::strftime(data.data(), kNumRows, kFormat, &out);
+    }
+    benchmark::DoNotOptimize(out.chars.data());
+  }
+  set_counters(state, counting.allocations());
+}
+BENCHMARK(BM_FormatColumnReuse)->Arg(0)->Arg(1);
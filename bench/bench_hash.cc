@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "datetime.h"
+#include "wire_format.h"
+
+static constexpr std::size_t kNumTicks = 1 << 18;
+
+// 连续的成交时间：间隔约1ms的tick，与毫秒对齐的bar时间
+static const std::vector<datetime::datetime>& ticks(int kind) {
+  static std::vector<datetime::datetime> data[2];
+  auto& v = data[kind];
+  if (v.empty()) {
+    std::mt19937_64 rng(kind);
+    long long t = datetime::datetime(2024, 1, 2, 9, 30).utctimestamp().count();
+    for (std::size_t i = 0; i < kNumTicks; ++i) {
+      t += kind == 0 ? 1 + static_cast<long long>(rng() % 2000) : 1000;
+      v.push_back(datetime::datetime::utcfromtimestamp(std::chrono::microseconds{t}));
+    }
+  }
+  return v;
+}
+
+static const char* kKindNames[] = {"ticks", "ms_bars"};
+
+/* 与以前的实现相同，把字节序列当作字符串求hash，用于对照；这里用8字节的wire格式代替内部数据 */
+struct StringViewHash {
+  std::size_t operator()(const datetime::datetime& dt) const {
+    uint8_t bytes[datetime::kWireSize<datetime::datetime>];
+    datetime::to_bytes(dt, bytes);
+    return std::hash<std::string_view>{}(std::string_view(reinterpret_cast<char*>(bytes), 8));
+  }
+};
+
+/* 2的幂大小的开放寻址表中，落到已占用槽位的key的比例，以及按泊松分布的期望值 */
+template <class Hash>
+static void set_collision_counters(benchmark::State& state,
+                                   const std::vector<datetime::datetime>& keys) {
+  std::size_t slots = 1;
+  while (slots < keys.size() * 2) {
+    slots <<= 1;
+  }
+  std::vector<uint8_t> used(slots);
+  std::size_t collisions = 0;
+  for (const auto& k : keys) {
+    auto& u = used[Hash{}(k) & (slots - 1)];
+    collisions += u;
+    u = 1;
+  }
+  double load = static_cast<double>(keys.size()) / slots;
+  state.counters["pow2_collisions"] = static_cast<double>(collisions) / keys.size();
+  state.counters["expected"] = 1 - (1 - std::exp(-load)) / load;
+}
+
+template <class Hash>
+static void BM_HashMapInsert(benchmark::State& state) {
+  const auto& data = ticks(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    std::unordered_map<datetime::datetime, int, Hash> map;
+    map.reserve(data.size());
+    for (std::size_t i = 0; i < data.size(); ++i) {
+      map.emplace(data[i], static_cast<int>(i));
+    }
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetLabel(kKindNames[state.range(0)]);
+  state.SetItemsProcessed(state.iterations() * data.size());
+  set_collision_counters<Hash>(state, data);
+}
+BENCHMARK_TEMPLATE(BM_HashMapInsert, std::hash<datetime::datetime>)->DenseRange(0, 1);
+BENCHMARK_TEMPLATE(BM_HashMapInsert, StringViewHash)->DenseRange(0, 1);
+
+template <class Hash>
+static void BM_HashMapLookup(benchmark::State& state) {
+  const auto& data = ticks(static_cast<int>(state.range(0)));
+  std::unordered_map<datetime::datetime, int, Hash> map;
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    map.emplace(data[i], static_cast<int>(i));
+  }
+  std::vector<datetime::datetime> keys = data;
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(3));
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(keys[i++ % keys.size()]));
+  }
+  state.SetLabel(kKindNames[state.range(0)]);
+  state.SetItemsProcessed(state.iterations());
+  std::size_t max_bucket = 0;
+  for (std::size_t b = 0; b < map.bucket_count(); ++b) {
+    max_bucket = std::max(max_bucket, map.bucket_size(b));
+  }
+  state.counters["max_bucket"] = static_cast<double>(max_bucket);
+}
+BENCHMARK_TEMPLATE(BM_HashMapLookup, std::hash<datetime::datetime>)->DenseRange(0, 1);
+BENCHMARK_TEMPLATE(BM_HashMapLookup, StringViewHash)->DenseRange(0, 1);
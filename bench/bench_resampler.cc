@@ -0,0 +1,81 @@
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "resampler.h"
+
+struct Tick {
+  long long timestamp;
+  double price;
+};
+
+// 一个交易日内约每100us一个tick，价格随机游走
+static const std::vector<Tick>& ticks() {
+  static std::vector<Tick> data = [] {
+    std::vector<Tick> v;
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<long long> gap(1, 200);
+    std::normal_distribution<double> step(0.0, 0.01);
+    long long ts = datetime::datetime(2021, 8, 31, 9, 30).utctimestamp().count();
+    double price = 100.0;
+    for (int i = 0; i < 1 << 20; ++i) {
+      ts += gap(rng);
+      price += step(rng);
+      v.push_back(Tick{ts, price});
+    }
+    return v;
+  }();
+  return data;
+}
+
+static void BM_ResamplerUpdate(benchmark::State& state) {
+  const auto& data = ticks();
+  for (auto _ : state) {
+    datetime::resampler r(datetime::timedelta(0, state.range(0)));
+    long bars = 0;
+    for (const auto& t : data) {
+      bars += r.update(t.timestamp, t.price);
+    }
+    bars += r.flush();
+    benchmark::DoNotOptimize(bars);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ResamplerUpdate)->Arg(1)->Arg(60)->Arg(3600);
+
+static void BM_ResamplerUpdateSessions(benchmark::State& state) {
+  const auto& data = ticks();
+  for (auto _ : state) {
+    datetime::resampler r(datetime::timedelta(0, state.range(0)));
+    r.add_session(datetime::time(9, 30), datetime::time(9, 31));
+    r.add_session(datetime::time(9, 31), datetime::time(11, 30));
+    r.add_session(datetime::time(13), datetime::time(15));
+    long bars = 0;
+    for (const auto& t : data) {
+      bars += r.update(t.timestamp, t.price);
+    }
+    bars += r.flush();
+    benchmark::DoNotOptimize(bars);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ResamplerUpdateSessions)->Arg(1)->Arg(60);
+
+static void BM_ResamplerUpdateDatetime(benchmark::State& state) {
+  const auto& data = ticks();
+  std::vector<datetime::datetime> dts;
+  for (const auto& t : data) {
+    dts.push_back(datetime::datetime::utcfromtimestamp(std::chrono::microseconds{t.timestamp}));
+  }
+  for (auto _ : state) {
+    datetime::resampler r(datetime::timedelta(0, 60));
+    long bars = 0;
+    for (std::size_t i = 0; i < dts.size(); ++i) {
+      bars += r.update(dts[i], data[i].price);
+    }
+    bars += r.flush();
+    benchmark::DoNotOptimize(bars);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ResamplerUpdateDatetime);
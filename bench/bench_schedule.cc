@@ -0,0 +1,74 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "schedule.h"
+
+static const char* kExprs[] = {
+    "*/5 * * * *",      "0 9-15 * * MON-FRI", "30 2 1 * *",    "0 0 * * SUN",
+    "15,45 */2 * * *",  "0 0 1 1 *",          "0 12 15 * 1-5", "*/10 9-11,13-15 * * 1-5",
+    "59 23 31 12 *",    "0 0 29 2 *",
+};
+
+static std::vector<datetime::schedule> schedules(std::size_t n) {
+  std::vector<datetime::schedule> v;
+  for (std::size_t i = 0; i < n; ++i) {
+    v.emplace_back(kExprs[i % (sizeof(kExprs) / sizeof(kExprs[0]))]);
+  }
+  return v;
+}
+
+static void BM_ScheduleParse(benchmark::State& state) {
+  std::size_t i = 0;
+  for (auto _ : state) {
+    datetime::schedule s(kExprs[i++ % (sizeof(kExprs) / sizeof(kExprs[0]))]);
+    benchmark::DoNotOptimize(s);
+  }
+}
+BENCHMARK(BM_ScheduleParse);
+
+static void BM_ScheduleNextAfter(benchmark::State& state) {
+  auto data = schedules(10000);
+  datetime::datetime now(2021, 8, 31, 15, 59, 55);
+  for (auto _ : state) {
+    int n = 0;
+    for (const auto& s : data) {
+      n += s.next_after(now).minute();
+    }
+    benchmark::DoNotOptimize(n);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ScheduleNextAfter);
+
+static void BM_ScheduleNextAfterBatch(benchmark::State& state) {
+  auto data = schedules(10000);
+  datetime::datetime now(2021, 8, 31, 15, 59, 55);
+  for (auto _ : state) {
+    auto next = datetime::schedule::next_after(data, now);
+    benchmark::DoNotOptimize(next.data());
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ScheduleNextAfterBatch);
+
+// 逐分钟步进直到匹配
+static void BM_ScheduleNextAfterBruteForce(benchmark::State& state) {
+  auto data = schedules(9);
+  datetime::datetime now(2021, 8, 31, 15, 59);
+  datetime::timedelta minute(0, 60);
+  for (auto _ : state) {
+    int n = 0;
+    for (const auto& s : data) {
+      auto dt = now + minute;
+      while (!s.matches(dt)) {
+        dt += minute;
+      }
+      n += dt.minute();
+    }
+    benchmark::DoNotOptimize(n);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ScheduleNextAfterBruteForce);
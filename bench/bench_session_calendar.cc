@@ -0,0 +1,73 @@
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "session_calendar.h"
+
+// 夜盘 + 日盘三个时段，2011-2030年的所有工作日
+static const datetime::session_calendar& calendar() {
+  static datetime::session_calendar cal(datetime::date(2011, 1, 1), datetime::date(2030, 12, 31),
+                                        {{datetime::time(21), datetime::time(2, 30)},
+                                         {datetime::time(9), datetime::time(10, 15)},
+                                         {datetime::time(10, 30), datetime::time(11, 30)},
+                                         {datetime::time(13, 30), datetime::time(15)}},
+                                        datetime::business_calendar());
+  return cal;
+}
+
+static const std::vector<datetime::datetime>& datetimes() {
+  static std::vector<datetime::datetime> data = [] {
+    std::vector<datetime::datetime> v;
+    std::mt19937_64 rng(42);
+    long long first = datetime::datetime(2012, 1, 1).utctimestamp().count();
+    long long last = datetime::datetime(2029, 12, 31).utctimestamp().count();
+    std::uniform_int_distribution<long long> us(first, last);
+    for (int i = 0; i < 1024; ++i) {
+      v.push_back(datetime::datetime::utcfromtimestamp(std::chrono::microseconds{us(rng)}));
+    }
+    return v;
+  }();
+  return data;
+}
+
+static void BM_InSession(benchmark::State& state) {
+  const auto& cal = calendar();
+  const auto& data = datetimes();
+  for (auto _ : state) {
+    int n = 0;
+    for (const auto& dt : data) {
+      n += cal.in_session(dt);
+    }
+    benchmark::DoNotOptimize(n);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_InSession);
+
+static void BM_NextOpen(benchmark::State& state) {
+  const auto& cal = calendar();
+  const auto& data = datetimes();
+  for (auto _ : state) {
+    int n = 0;
+    for (const auto& dt : data) {
+      n += cal.next_open(dt).hour();
+    }
+    benchmark::DoNotOptimize(n);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_NextOpen);
+
+static void BM_TradingTimeBetween(benchmark::State& state) {
+  const auto& cal = calendar();
+  const auto& data = datetimes();
+  for (auto _ : state) {
+    long n = 0;
+    for (std::size_t i = 1; i < data.size(); ++i) {
+      n += cal.trading_time_between(data[i - 1], data[i]).days();
+    }
+    benchmark::DoNotOptimize(n);
+  }
+  state.SetItemsProcessed(state.iterations() * (data.size() - 1));
+}
+BENCHMARK(BM_TradingTimeBetween);
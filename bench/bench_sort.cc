@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "datetime.h"
+#include "datetime_sort.h"
+#include "perf_counters.h"
+
+static constexpr std::size_t kNumRows = 1 << 20;
+
+// 1970-2050年之间均匀分布的UTC微秒时间戳，乱序
+static const std::vector<long long>& timestamps() {
+  static std::vector<long long> data = [] {
+    std::vector<long long> v;
+    std::mt19937_64 rng(50);
+    long long first = datetime::datetime(1970, 1, 2).utctimestamp().count();
+    long long last = datetime::datetime(2050, 1, 1).utctimestamp().count();
+    std::uniform_int_distribution<long long> us(first, last);
+    for (std::size_t i = 0; i < kNumRows; ++i) {
+      v.push_back(us(rng));
+    }
+    return v;
+  }();
+  return data;
+}
+
+static const std::vector<datetime::datetime>& datetimes() {
+  static std::vector<datetime::datetime> data = [] {
+    std::vector<datetime::datetime> v;
+    for (long long t : timestamps()) {
+      v.push_back(datetime::datetime::utcfromtimestamp(std::chrono::microseconds{t}));
+    }
+    return v;
+  }();
+  return data;
+}
+
+/* k个交易所同一天的成交时间，每个序列按时间递增，共kNumRows个 */
+static std::vector<std::vector<datetime::datetime>> venues(std::size_t k) {
+  std::vector<std::vector<datetime::datetime>> runs(k);
+  std::mt19937_64 rng(k);
+  long long open = datetime::datetime(2024, 1, 2, 9, 30).utctimestamp().count();
+  for (auto& run : runs) {
+    long long t = open;
+    /* 6.5小时的交易时段内平均分布 */
+    long long mean_gap = 23'400'000'000LL / static_cast<long long>(kNumRows / k);
+    for (std::size_t i = 0; i < kNumRows / k; ++i) {
+      t += static_cast<long long>(rng() % static_cast<unsigned long long>(2 * mean_gap + 1));
+      run.push_back(datetime::datetime::utcfromtimestamp(std::chrono::microseconds{t}));
+    }
+  }
+  return runs;
+}
+
+/* ---------------------------------------------------------------------------
+ * Sort，每次迭代排序kNumRows个元素，复制原始数据的时间不计入。
+ * 多线程的版本在其他线程上运行，所以都按实际经过的时间计时
+ */
+
+static void BM_SortStdSort(benchmark::State& state) {
+  std::vector<datetime::datetime> v = datetimes();
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    v = datetimes();
+    state.ResumeTiming();
+    std::sort(v.begin(), v.end());
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+BENCHMARK(BM_SortStdSort)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/* 参数为线程数 */
+static void BM_SortRadix(benchmark::State& state) {
+  std::vector<datetime::datetime> v = datetimes();
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    v = datetimes();
+    state.ResumeTiming();
+    datetime::radix_sort(v.data(), v.size(), static_cast<unsigned>(state.range(0)));
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+BENCHMARK(BM_SortRadix)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_SortTimestampStdSort(benchmark::State& state) {
+  std::vector<long long> v = timestamps();
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    v = timestamps();
+    state.ResumeTiming();
+    std::sort(v.begin(), v.end());
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+BENCHMARK(BM_SortTimestampStdSort)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_SortTimestampRadix(benchmark::State& state) {
+  std::vector<long long> v = timestamps();
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    v = timestamps();
+    state.ResumeTiming();
+    datetime::radix_sort(v.data(), v.size(), static_cast<unsigned>(state.range(0)));
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+BENCHMARK(BM_SortTimestampRadix)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/* ---------------------------------------------------------------------------
+ * Merge，每次迭代把k个序列合并成kNumRows个元素，参数为k
+ */
+
+/* 拼接后用std::sort排序 */
+static void BM_MergeStdSort(benchmark::State& state) {
+  auto runs = venues(state.range(0));
+  std::vector<datetime::datetime> out;
+  out.reserve(kNumRows);
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    out.clear();
+    for (const auto& run : runs) {
+      out.insert(out.end(), run.begin(), run.end());
+    }
+    std::sort(out.begin(), out.end());
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+BENCHMARK(BM_MergeStdSort)->Arg(8)->Arg(64)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/* 以各序列的当前元素为堆的std::priority_queue */
+static void BM_MergeHeap(benchmark::State& state) {
+  auto runs = venues(state.range(0));
+  std::vector<datetime::datetime> out(kNumRows, datetime::datetime::min());
+  using Head = std::pair<datetime::datetime, std::size_t>;
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heap;
+    std::vector<std::size_t> pos(runs.size());
+    for (std::size_t r = 0; r < runs.size(); ++r) {
+      heap.emplace(runs[r][0], r);
+    }
+    for (std::size_t n = 0; !heap.empty(); ++n) {
+      auto [dt, r] = heap.top();
+      heap.pop();
+      out[n] = dt;
+      if (++pos[r] < runs[r].size()) {
+        heap.emplace(runs[r][pos[r]], r);
+      }
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+BENCHMARK(BM_MergeHeap)->Arg(8)->Arg(64)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/* 参数为k和线程数 */
+static void BM_MergeLoserTree(benchmark::State& state) {
+  auto runs = venues(state.range(0));
+  std::vector<datetime::SortedRun<datetime::datetime>> sorted_runs;
+  for (const auto& run : runs) {
+    sorted_runs.push_back({run.data(), run.size()});
+  }
+  std::vector<datetime::datetime> out(kNumRows, datetime::datetime::min());
+  std::vector<uint32_t> sources(kNumRows);
+  PerfCounters perf(state);
+  for (auto _ : state) {
+    datetime::merge_sorted(sorted_runs, out.data(), sources.data(),
+                           static_cast<unsigned>(state.range(1)));
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+BENCHMARK(BM_MergeLoserTree)
+    ->Args({8, 1})
+    ->Args({64, 1})
+    ->Args({8, 4})
+    ->Args({64, 4})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
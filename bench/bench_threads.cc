@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "datetime.h"
+
+// 多线程扩展性：同一个操作从1个线程到N个线程并发执行，items_per_second是所有线程的总吞吐量。
+// 吞吐量不再随线程数增长的操作依赖了共享状态，如localtime_r内部的全局锁、全局locale的引用计数。
+
+static constexpr std::size_t kDataSize = 4096;
+static constexpr std::size_t kMask = kDataSize - 1;
+
+static int max_threads() {
+  return static_cast<int>(std::max(4u, std::thread::hardware_concurrency()));
+}
+
+static const std::vector<std::chrono::microseconds>& timestamps() {
+  static std::vector<std::chrono::microseconds> data = [] {
+    std::vector<std::chrono::microseconds> v;
+    std::mt19937_64 rng(42);
+    long long first = datetime::datetime(1970, 1, 2).utctimestamp().count();
+    long long last = datetime::datetime(2050, 1, 1).utctimestamp().count();
+    std::uniform_int_distribution<long long> us(first, last);
+    for (std::size_t i = 0; i < kDataSize; ++i) {
+      v.emplace_back(us(rng));
+    }
+    return v;
+  }();
+  return data;
+}
+
+static const std::vector<datetime::datetime>& local_datetimes() {
+  static std::vector<datetime::datetime> data = [] {
+    std::vector<datetime::datetime> v;
+    for (auto ts : timestamps()) {
+      v.push_back(datetime::datetime::fromtimestamp(ts));
+    }
+    return v;
+  }();
+  return data;
+}
+
+/* 每个线程从不同的位置开始遍历，避免所有线程同时访问同一个元素 */
+static std::size_t start_index(const benchmark::State& state) {
+  return static_cast<std::size_t>(state.thread_index()) * 997;
+}
+
+static void BM_ParallelNow(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::datetime::now());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParallelNow)->ThreadRange(1, max_threads())->UseRealTime();
+
+static void BM_ParallelToday(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::date::today());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParallelToday)->ThreadRange(1, max_threads())->UseRealTime();
+
+static void BM_ParallelFromtimestamp(benchmark::State& state) {
+  const auto& data = timestamps();
+  std::size_t i = start_index(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::datetime::fromtimestamp(data[i++ & kMask]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParallelFromtimestamp)->ThreadRange(1, max_threads())->UseRealTime();
+
+static void BM_ParallelTimestamp(benchmark::State& state) {
+  const auto& data = local_datetimes();
+  std::size_t i = start_index(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].timestamp());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParallelTimestamp)->ThreadRange(1, max_threads())->UseRealTime();
+
+/* 不依赖共享状态，作为对照 */
+static void BM_ParallelUtcfromtimestamp(benchmark::State& state) {
+  const auto& data = timestamps();
+  std::size_t i = start_index(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(datetime::datetime::utcfromtimestamp(data[i++ & kMask]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParallelUtcfromtimestamp)->ThreadRange(1, max_threads())->UseRealTime();
+
+static void BM_ParallelStrftime(benchmark::State& state) {
+  const auto& data = local_datetimes();
+  std::size_t i = start_index(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(data[i++ & kMask].strftime("%Y-%m-%d %H:%M:%S.%f"));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParallelStrftime)->ThreadRange(1, max_threads())->UseRealTime();
+
+static void BM_ParallelStrptime(benchmark::State& state) {
+  static const std::vector<std::string> data = [] {
+    std::vector<std::string> v;
+    for (const auto& dt : local_datetimes()) {
+      v.push_back(dt.strftime("%Y-%m-%d %H:%M:%S.%f"));
+    }
+    return v;
+  }();
+  std::size_t i = start_index(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        datetime::datetime::strptime(data[i++ & kMask], "%Y-%m-%d %H:%M:%S.%f"));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParallelStrptime)->ThreadRange(1, max_threads())->UseRealTime();
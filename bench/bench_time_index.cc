@@ -0,0 +1,113 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "datetime.h"
+#include "time_index.h"
+
+static constexpr std::size_t kNumEntries = 1 << 20;
+static constexpr std::size_t kNumTargets = 4096;
+static constexpr std::size_t kMask = kNumTargets - 1;
+
+// 约1M个索引项(16MB)，相当于64GB的数据文件：每个交易日09:30-16:00，
+// 块之间的间隔随机，收盘后到下一个交易日开盘之间没有数据
+static const std::string& index_path() {
+  static std::string path = [] {
+    auto p = std::filesystem::temp_directory_path() / "datetime_bench_time_index.idx";
+    datetime::time_index_writer writer(p.string());
+    std::mt19937_64 rng(1);
+    std::exponential_distribution<double> gap(1.0 / 20000);
+    long long day = datetime::datetime(2010, 1, 4).utctimestamp().count();
+    long long open = 9 * 3600LL * 1000000 + 30 * 60LL * 1000000;
+    long long close = 16 * 3600LL * 1000000;
+    long long t = day + open;
+    for (std::size_t i = 0; i < kNumEntries; ++i) {
+      writer.add(t, i * datetime::time_index_writer::kDefaultBlockSize);
+      t += 1 + static_cast<long long>(gap(rng));
+      if (t >= day + close) {
+        day += 86400LL * 1000000;
+        t = day + open;
+      }
+    }
+    return p.string();
+  }();
+  return path;
+}
+
+static std::vector<long long> targets(const datetime::time_index& index) {
+  std::vector<long long> v;
+  std::mt19937_64 rng(2);
+  std::uniform_int_distribution<long long> us(index.timestamp(0), index.timestamp(index.size() - 1));
+  for (std::size_t i = 0; i < kNumTargets; ++i) {
+    v.push_back(us(rng));
+  }
+  return v;
+}
+
+/* 页缓存中仍然存在的比例，用于确认冷启动的benchmark确实从磁盘读取 */
+static double cached_fraction(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  off_t size = ::lseek(fd, 0, SEEK_END);
+  void* map = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  long page = ::sysconf(_SC_PAGESIZE);
+  std::vector<unsigned char> residency((size + page - 1) / page);
+  ::mincore(map, size, residency.data());
+  ::munmap(map, size);
+  ::close(fd);
+  std::size_t cached = 0;
+  for (auto r : residency) {
+    cached += r & 1;
+  }
+  return static_cast<double>(cached) / residency.size();
+}
+
+static void BM_TimeIndexSeekWarm(benchmark::State& state) {
+  datetime::time_index index(index_path());
+  auto data = targets(index);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(index.seek(data[i++ & kMask]));
+  }
+}
+BENCHMARK(BM_TimeIndexSeekWarm);
+
+/* 每次查找前把索引文件从页缓存中清除并重新打开，查找的耗时包括缺页时从磁盘读取 */
+static void BM_TimeIndexSeekCold(benchmark::State& state) {
+  const std::string& path = index_path();
+  auto data = targets(datetime::time_index(path));
+  std::unique_ptr<datetime::time_index> index;
+  double cached = 0;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    index.reset();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    ::fdatasync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+    cached += cached_fraction(path);
+    index = std::make_unique<datetime::time_index>(path);
+    state.ResumeTiming();
+
+    benchmark::DoNotOptimize(index->seek(data[i++ & kMask]));
+  }
+  /* tmpfs等文件系统无法清除页缓存，此时接近1 */
+  state.counters["cached_fraction"] = cached / state.iterations();
+}
+BENCHMARK(BM_TimeIndexSeekCold)->Iterations(200)->UseRealTime();
+
+static void BM_TimeIndexOpen(benchmark::State& state) {
+  const std::string& path = index_path();
+  for (auto _ : state) {
+    datetime::time_index index(path);
+    benchmark::DoNotOptimize(index.size());
+  }
+}
+BENCHMARK(BM_TimeIndexOpen);
@@ -0,0 +1,83 @@
+#include <queue>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "timer_wheel.h"
+
+static const datetime::datetime kStart(2021, 8, 31, 9, 30);
+
+// 1M个在10分钟内随机到期的定时器，单位为微秒
+static const std::vector<long long>& timeouts() {
+  static std::vector<long long> data = [] {
+    std::vector<long long> v;
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<long long> us(1, 600LL * 1000000);
+    for (int i = 0; i < 1000000; ++i) {
+      v.push_back(us(rng));
+    }
+    return v;
+  }();
+  return data;
+}
+
+// 插入所有定时器，取消一半，然后以1ms的步长推进直到全部到期
+static void BM_TimerWheel(benchmark::State& state) {
+  const auto& data = timeouts();
+  std::vector<datetime::timer_wheel::timer_id> ids(data.size());
+  std::vector<uint64_t> expired;
+  expired.reserve(data.size());
+  for (auto _ : state) {
+    datetime::timer_wheel wheel(kStart);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+      ids[i] = wheel.add(datetime::timedelta(0, 0, data[i]), i);
+    }
+    for (std::size_t i = 0; i < data.size(); i += 2) {
+      wheel.cancel(ids[i]);
+    }
+    expired.clear();
+    auto now = kStart;
+    while (!wheel.empty()) {
+      now += datetime::timedelta(0, 0, 1000);
+      wheel.advance(now, &expired);
+    }
+    benchmark::DoNotOptimize(expired.data());
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_TimerWheel)->Unit(benchmark::kMillisecond);
+
+// 二叉堆，取消通过惰性删除实现
+static void BM_TimerBinaryHeap(benchmark::State& state) {
+  const auto& data = timeouts();
+  std::vector<uint64_t> expired;
+  expired.reserve(data.size());
+  long long start = kStart.utctimestamp().count();
+  using Entry = std::pair<long long, uint64_t>;
+  for (auto _ : state) {
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    std::unordered_set<uint64_t> cancelled;
+    for (std::size_t i = 0; i < data.size(); ++i) {
+      heap.emplace(start + data[i], i);
+    }
+    for (std::size_t i = 0; i < data.size(); i += 2) {
+      cancelled.insert(i);
+    }
+    expired.clear();
+    auto now = kStart;
+    while (!heap.empty()) {
+      now += datetime::timedelta(0, 0, 1000);
+      long long us = now.utctimestamp().count();
+      while (!heap.empty() && heap.top().first <= us) {
+        if (!cancelled.erase(heap.top().second)) {
+          expired.push_back(heap.top().second);
+        }
+        heap.pop();
+      }
+    }
+    benchmark::DoNotOptimize(expired.data());
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_TimerBinaryHeap)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "datetime.h"
+#include "wire_format.h"
+
+static constexpr std::size_t kDataSize = 4096;
+static constexpr std::size_t kMask = kDataSize - 1;
+static constexpr std::size_t kSize = datetime::kWireSize<datetime::datetime>;
+
+static const std::vector<datetime::datetime>& datetimes() {
+  static std::vector<datetime::datetime> data = [] {
+    std::vector<datetime::datetime> v;
+    std::mt19937_64 rng(42);
+    long long first = datetime::datetime(1970, 1, 2).utctimestamp().count();
+    long long last = datetime::datetime(2050, 1, 1).utctimestamp().count();
+    std::uniform_int_distribution<long long> us(first, last);
+    for (std::size_t i = 0; i < kDataSize; ++i) {
+      v.push_back(datetime::datetime::utcfromtimestamp(std::chrono::microseconds{us(rng)}));
+    }
+    return v;
+  }();
+  return data;
+}
+
+/* 连续存放的datetime编码，相当于共享内存队列中的数据 */
+static const std::vector<uint8_t>& encoded() {
+  static std::vector<uint8_t> data = [] {
+    std::vector<uint8_t> v(kDataSize * kSize);
+    for (std::size_t i = 0; i < kDataSize; ++i) {
+      datetime::to_bytes(datetimes()[i], &v[i * kSize]);
+    }
+    return v;
+  }();
+  return data;
+}
+
+static void BM_WireDatetimeToBytes(benchmark::State& state) {
+  const auto& data = datetimes();
+  uint8_t buf[kSize];
+  std::size_t i = 0;
+  for (auto _ : state) {
+    datetime::to_bytes(data[i++ & kMask], buf);
+    benchmark::DoNotOptimize(buf);
+  }
+}
+BENCHMARK(BM_WireDatetimeToBytes);
+
+static void BM_WireDatetimeFromBytes(benchmark::State& state) {
+  const auto& data = encoded();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        datetime::from_bytes<datetime::datetime>(&data[(i++ & kMask) * kSize]));
+  }
+}
+BENCHMARK(BM_WireDatetimeFromBytes);
+
+/* 视图之间的比较只读取时间戳 */
+static void BM_WireViewCompare(benchmark::State& state) {
+  const auto& data = encoded();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    std::size_t k = i++;
+    datetime::datetime_view lhs(&data[(k & kMask) * kSize]);
+    datetime::datetime_view rhs(&data[((k + 1) & kMask) * kSize]);
+    benchmark::DoNotOptimize(lhs < rhs);
+  }
+}
+BENCHMARK(BM_WireViewCompare);
+
+/* 查找第一个不早于deadline的记录 */
+static void BM_WireViewLowerBound(benchmark::State& state) {
+  std::vector<datetime::datetime> sorted = datetimes();
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<uint8_t> buf(kDataSize * kSize);
+  for (std::size_t i = 0; i < kDataSize; ++i) {
+    datetime::to_bytes(sorted[i], &buf[i * kSize]);
+  }
+  const auto& targets = datetimes();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const auto& deadline = targets[i++ & kMask];
+    std::size_t lo = 0;
+    std::size_t hi = kDataSize;
+    while (lo < hi) {
+      std::size_t mid = (lo + hi) / 2;
+      if (datetime::datetime_view(&buf[mid * kSize]) < deadline) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    benchmark::DoNotOptimize(lo);
+  }
+}
+BENCHMARK(BM_WireViewLowerBound);
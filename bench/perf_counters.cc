@@ -0,0 +1,107 @@
+#include "perf_counters.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+static const uint64_t kEvents[] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                   PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES};
+
+static int open_event(uint64_t config, int group_fd) {
+  struct perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = group_fd == -1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+#endif
+
+bool PerfCounters::available() {
+  static const bool kAvailable = [] {
+#ifdef __linux__
+    int fd = open_event(PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (fd < 0) {
+      benchmark::AddCustomContext("perf_counters",
+                                  std::string("unavailable: perf_event_open: ") +
+                                      std::strerror(errno));
+      return false;
+    }
+    close(fd);
+    benchmark::AddCustomContext("perf_counters",
+                                "cycles,instructions,branch-misses,cache-misses (user)");
+    return true;
+#else
+    benchmark::AddCustomContext("perf_counters", "unavailable: not supported on this platform");
+    return false;
+#endif
+  }();
+  return kAvailable;
+}
+
+/* 在benchmark开始之前探测，使上下文信息出现在输出的头部 */
+[[maybe_unused]] static const bool kProbed = PerfCounters::available();
+
+PerfCounters::PerfCounters(benchmark::State& state) : state_(state) {
+  for (auto& fd : fds_) {
+    fd = -1;
+  }
+#ifdef __linux__
+  if (!available()) {
+    return;
+  }
+  fds_[0] = open_event(kEvents[0], -1);
+  if (fds_[0] < 0) {
+    return;
+  }
+  /* 虚拟机等环境下部分事件可能不支持，跳过即可 */
+  for (int i = 1; i < kNumEvents; ++i) {
+    fds_[i] = open_event(kEvents[i], fds_[0]);
+  }
+  ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  if (fds_[0] < 0) {
+    return;
+  }
+  ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+  uint64_t values[kNumEvents];
+  bool valid[kNumEvents];
+  for (int i = 0; i < kNumEvents; ++i) {
+    valid[i] = fds_[i] >= 0 && read(fds_[i], &values[i], sizeof(values[i])) == sizeof(values[i]);
+  }
+  for (int i = kNumEvents - 1; i >= 0; --i) {
+    if (fds_[i] >= 0) {
+      close(fds_[i]);
+    }
+  }
+
+  double iterations = state_.iterations() > 0 ? static_cast<double>(state_.iterations()) : 1.0;
+  static const char* kNames[] = {"cycles/op", "instructions/op", "branch-misses/op",
+                                 "cache-misses/op"};
+  for (int i = 0; i < kNumEvents; ++i) {
+    if (valid[i]) {
+      state_.counters[kNames[i]] = values[i] / iterations;
+    }
+  }
+  if (valid[0] && valid[1] && values[0] != 0) {
+    state_.counters["IPC"] = static_cast<double>(values[1]) / values[0];
+  }
+#endif
+}
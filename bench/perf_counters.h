@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+/**
+ * @brief 基于perf_event_open的硬件计数器
+ * 在构造时开始计数(用户态)，析构时把每次迭代的cycles、instructions、branch-misses、
+ * cache-misses以及IPC写入state.counters。应在准备完数据、进入计时循环之前构造：
+ *
+ *    static void BM_Foo(benchmark::State& state) {
+ *      auto data = prepare();
+ *      PerfCounters perf(state);
+ *      for (auto _ : state) {
+ *        ...
+ *      }
+ *    }
+ *
+ * 计数器不可用时(非Linux、perf_event_paranoid限制、容器或虚拟机不支持)不输出任何计数，
+ * 原因记录在benchmark上下文的perf_counters字段中。
+ */
+class PerfCounters {
+ public:
+  explicit PerfCounters(benchmark::State& state);
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  /**
+   * @brief 当前环境是否可以使用硬件计数器，第一次调用时探测
+   */
+  static bool available();
+
+ private:
+  static constexpr int kNumEvents = 4;
+
+  benchmark::State& state_;
+  int fds_[kNumEvents];
+};
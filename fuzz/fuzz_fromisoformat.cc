@@ -0,0 +1,40 @@
+// date::fromisoformat和time::fromisoformat的fuzz测试
+// 解析成功时，isoformat()的结果必须能被解析回同一个值。
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include "datetime.h"
+
+static void check_date(const std::string& str) {
+  try {
+    auto d = datetime::date::fromisoformat(str);
+    /* YYYY-MM-DD是唯一接受的格式，所以格式化的结果必须与输入完全一致 */
+    if (d.isoformat() != str || datetime::date::fromisoformat(d.isoformat()) != d) {
+      std::abort();
+    }
+  } catch (const std::invalid_argument&) {
+  } catch (const std::out_of_range&) {
+  }
+}
+
+static void check_time(const std::string& str) {
+  try {
+    auto t = datetime::time::fromisoformat(str);
+    if (datetime::time::fromisoformat(t.isoformat()) != t) {
+      std::abort();
+    }
+  } catch (const std::invalid_argument&) {
+  } catch (const std::out_of_range&) {
+  }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  std::string input(reinterpret_cast<const char*>(data), size);
+  check_date(input);
+  check_time(input);
+  return 0;
+}
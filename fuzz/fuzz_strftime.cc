@@ -0,0 +1,84 @@
+// strftime的fuzz测试
+// 输入的前8个字节选择[datetime::min(), datetime::max()]中的一个datetime，剩余字节：
+//   1. 直接作为格式串传给datetime、date和time的strftime
+//   2. 映射为只含有%Y %m %d %H %M %S %f %%和普通字符的格式串，检查
+//      strptime(strftime(x, fmt), fmt) == x，没有出现的时间字段为0，缺少年月日时必须解析失败
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "datetime.h"
+
+static const char* kDirectives[] = {"%Y", "%m", "%d", "%H", "%M", "%S", "%f", "%%"};
+
+static void check_strftime(const datetime::datetime& dt, const std::string& fmt) {
+  try {
+    dt.strftime(fmt);
+  } catch (const std::invalid_argument&) {
+  }
+  try {
+    dt.date().strftime(fmt);
+  } catch (const std::invalid_argument&) {
+  }
+  try {
+    dt.time().strftime(fmt);
+  } catch (const std::invalid_argument&) {
+  }
+}
+
+static void check_roundtrip(const datetime::datetime& dt, const uint8_t* data, size_t size) {
+  std::string fmt;
+  unsigned seen = 0;
+  for (size_t i = 0; i < size; ++i) {
+    /* 最高位为1的字节表示格式化符号，其余为普通字符，'%'只能以%%出现 */
+    if (data[i] & 0x80) {
+      unsigned k = data[i] & 7;
+      fmt += kDirectives[k];
+      seen |= 1u << k;
+    } else if (data[i] != '%') {
+      fmt += static_cast<char>(data[i]);
+    }
+  }
+
+  std::string str = dt.strftime(fmt);
+  bool has_date = (seen & 7) == 7;
+  try {
+    auto parsed = datetime::datetime::strptime(str, fmt);
+    auto field = [seen](int k, int value) { return (seen >> k) & 1 ? value : 0; };
+    datetime::datetime expected(dt.year(), dt.month(), dt.day(), field(3, dt.hour()),
+                                field(4, dt.minute()), field(5, dt.second()),
+                                field(6, dt.microsecond()));
+    if (!has_date || parsed != expected) {
+      std::abort();
+    }
+  } catch (const std::invalid_argument&) {
+    std::abort();
+  } catch (const std::out_of_range&) {
+    /* 没有年月日时它们为0，超出范围 */
+    if (has_date) {
+      std::abort();
+    }
+  }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  if (size < 8) {
+    return 0;
+  }
+  uint64_t bits;
+  std::memcpy(&bits, data, sizeof(bits));
+  long long first = datetime::datetime::min().utctimestamp().count();
+  long long span = datetime::datetime::max().utctimestamp().count() - first + 1;
+  auto dt = datetime::datetime::utcfromtimestamp(
+      std::chrono::microseconds{first + static_cast<long long>(bits % span)});
+
+  data += 8;
+  size -= 8;
+  check_strftime(dt, std::string(reinterpret_cast<const char*>(data), size));
+  check_roundtrip(dt, data, size);
+  return 0;
+}
@@ -0,0 +1,51 @@
+// datetime::strptime的fuzz测试
+// 输入中第一个'\n'之前是格式串，之后是待解析的字符串。
+// 解析成功时，用同一个格式串格式化再解析，必须得到同一个datetime。
+// 不抛出异常的strptime_timestamp必须与strptime的结果一致。
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include "datetime.h"
+
+static std::optional<datetime::datetime> try_strptime(const std::string& str,
+                                                      const std::string& fmt) {
+  try {
+    return datetime::datetime::strptime(str, fmt);
+  } catch (const std::invalid_argument&) {
+  } catch (const std::out_of_range&) {
+    /* 格式正确但字段超出范围，如月份为13 */
+  }
+  return std::nullopt;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  std::string input(reinterpret_cast<const char*>(data), size);
+  auto pos = input.find('\n');
+  if (pos == std::string::npos) {
+    return 0;
+  }
+  std::string fmt = input.substr(0, pos);
+  std::string str = input.substr(pos + 1);
+
+  auto dt = try_strptime(str, fmt);
+  long long timestamp;
+  bool ok = datetime::strptime_timestamp(str, fmt, &timestamp);
+  if (ok != dt.has_value() || (ok && timestamp != dt->utctimestamp().count())) {
+    std::abort();
+  }
+  if (!dt) {
+    return 0;
+  }
+
+  /* 能解析成功说明格式串只含有strptime与strftime共同支持的格式化符号 */
+  auto again = try_strptime(dt->strftime(fmt), fmt);
+  if (!again || *again != *dt) {
+    std::abort();
+  }
+  return 0;
+}
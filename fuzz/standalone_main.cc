@@ -0,0 +1,39 @@
+// 没有libFuzzer(如使用GCC)时的入口：依次把命令行给出的文件或目录下的所有文件作为输入，
+// 用于回放语料库和复现崩溃，不做变异。
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+static void run_file(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  std::vector<char> buf((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(buf.data()), buf.size());
+}
+
+int main(int argc, char** argv) {
+  std::size_t count = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::filesystem::path path(argv[i]);
+    if (std::filesystem::is_directory(path)) {
+      for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+        if (entry.is_regular_file()) {
+          run_file(entry.path());
+          ++count;
+        }
+      }
+    } else {
+      run_file(path);
+      ++count;
+    }
+  }
+  std::printf("%s: %zu inputs\n", argv[0], count);
+  return 0;
+}
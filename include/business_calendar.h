@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "datetime.h"
+
+namespace datetime {
+
+/**
+ * @brief 工作日日历
+ * 以date::toordinal()为下标，用位图记录[1, kMaxOrdinal]内每一天是否为工作日，
+ * 并为每64天维护一个前缀计数，因此：
+ *   is_business_day         O(1)
+ *   business_days_between   O(1)，两次rank
+ *   add_business_days       O(log n)，rank + select
+ *   add_holiday             O(n / 64)，需要更新之后的所有前缀计数
+ *   add_holidays            O(k + n / 64)，k个节假日只重建一次前缀计数
+ * 其中n为kMaxOrdinal，约365万。逐个add_holiday添加很多节假日时为平方复杂度，应使用add_holidays。
+ * 位图与前缀计数共约700KB。
+ */
+class business_calendar {
+ public:
+  /* 周一至周五为工作日，第i位对应date::weekday() == i */
+  static constexpr int kDefaultWeekmask = 0x1f;
+
+  /**
+   * @brief
+   * @param holidays 节假日，可以包含周末，重复的日期会被忽略
+   * @param weekmask 每周的工作日，第i位为1表示weekday() == i的日期为工作日
+   */
+  explicit business_calendar(const std::vector<date>& holidays = {},
+                             int weekmask = kDefaultWeekmask);
+
+  /**
+   * @brief 从文本文件加载节假日
+   * 每行一个YYYY-MM-DD格式的日期，忽略空行以及'#'之后的内容。
+   * @param path
+   * @param weekmask
+   * @return business_calendar
+   * @exception std::runtime_error 无法打开文件
+   * @exception std::invalid_argument 无法解析的行
+   */
+  static business_calendar fromfile(const std::string& path, int weekmask = kDefaultWeekmask);
+
+  /**
+   * @brief 添加一个节假日，已经不是工作日的日期会被忽略
+   * 需要更新之后的所有前缀计数，约57000个，批量添加时使用add_holidays
+   */
+  void add_holiday(const date& d);
+
+  /**
+   * @brief 批量添加节假日，只重建一次前缀计数
+   */
+  void add_holidays(const std::vector<date>& holidays);
+
+  bool is_business_day(const date& d) const { return test(d.toordinal()); }
+
+  /**
+   * @brief [begin, end)内的工作日数，如果end < begin则返回-(工作日数 in [end, begin))
+   */
+  int business_days_between(const date& begin, const date& end) const;
+
+  /**
+   * @brief 偏移n个工作日
+   * n > 0时返回d之后的第n个工作日，n < 0时返回d之前的第-n个工作日，
+   * n == 0时如果d为工作日则返回d，否则返回d之后的第一个工作日。
+   * @exception std::out_of_range 结果超出[date::min(), date::max()]
+   */
+  date add_business_days(const date& d, int n) const;
+
+  int weekmask() const { return weekmask_; }
+
+ private:
+  static constexpr int kNumWords = (kMaxOrdinal + 1) / 64 + 1;
+
+  bool test(int ordinal) const { return (bits_[ordinal >> 6] >> (ordinal & 63)) & 1; }
+
+  /* ordinal之前(不含)的工作日数 */
+  int rank(int ordinal) const;
+  /* 第k个(从0开始)工作日的ordinal */
+  int select(int k) const;
+  /* 由bits_重新计算rank_和total_ */
+  void build_rank();
+
+  int weekmask_;
+  int total_;
+  std::vector<uint64_t> bits_;
+  /* rank_[w]为第w个word之前的工作日数，rank_.size() == kNumWords + 1 */
+  std::vector<int> rank_;
+};
+
+}  // namespace datetime
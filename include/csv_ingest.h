@@ -0,0 +1,102 @@
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "datetime.h"
+
+namespace datetime {
+
+/**
+ * @brief 需要解析的时间戳列
+ * column从0开始，format的格式化符号与datetime::strptime相同
+ */
+struct CsvTimestampColumn {
+  std::size_t column;
+  std::string format;
+};
+
+/**
+ * @brief 一个无法解析的字段
+ * row为数据行的下标(不包括表头)，与CsvIngestResult::timestamps的下标一致；column为CSV的列号
+ */
+struct CsvParseError {
+  std::size_t row;
+  std::size_t column;
+};
+
+struct CsvIngestResult {
+  /* 无法解析的字段对应的时间戳 */
+  static constexpr long long kInvalidTimestamp = LLONG_MIN;
+
+  std::size_t rows = 0;
+  /* 每个时间戳列一个数组，元素为UTC微秒时间戳，顺序与csv_ingest构造时的columns相同 */
+  std::vector<std::vector<long long>> timestamps;
+  /* 按行号排序 */
+  std::vector<CsvParseError> errors;
+};
+
+/**
+ * @brief 多线程解析CSV中的时间戳列
+ * 文件通过mmap读取，按换行符切分为与线程数相同的块，每个线程解析一个块：
+ *   1. 并行统计每个块的行数，得到每个块第一行的行号
+ *   2. 并行解析每一行中指定的列，直接写入结果数组中对应的位置
+ * 解析使用strptime_timestamp，不会抛出异常，无法解析的字段记录在errors中，
+ * 对应的时间戳为kInvalidTimestamp。
+ * 支持以"\n"或"\r\n"结尾的行，字段可以用双引号括起来，但不能包含换行符。
+ * 示例：
+ *    csv_ingest ingest({{0, "%Y-%m-%d %H:%M:%S.%f"}});
+ *    auto result = ingest.read("ticks.csv");
+ *    for (auto& e : result.errors) {
+ *      ...
+ *    }
+ */
+class csv_ingest {
+ public:
+  /**
+   * @brief
+   * @param columns 时间戳列
+   * @param delimiter 字段分隔符
+   * @param has_header 第一行是否为表头，表头不会被解析
+   * @param num_threads 线程数，0表示std::thread::hardware_concurrency()
+   */
+  explicit csv_ingest(std::vector<CsvTimestampColumn> columns, char delimiter = ',',
+                      bool has_header = true, unsigned num_threads = 0);
+
+  /**
+   * @brief 读取并解析文件
+   * @exception std::runtime_error 无法打开或映射文件
+   */
+  CsvIngestResult read(const std::string& path) const;
+
+  /**
+   * @brief 解析内存中的CSV数据
+   */
+  CsvIngestResult parse(std::string_view data) const;
+
+ private:
+  struct Chunk {
+    const char* begin;
+    const char* end;
+    std::size_t first_row;
+    std::vector<CsvParseError> errors;
+  };
+
+  std::size_t count_rows(const char* begin, const char* end) const;
+  void parse_chunk(Chunk* chunk, CsvIngestResult* result) const;
+  void parse_line(const char* begin, const char* end, std::size_t row, Chunk* chunk,
+                  CsvIngestResult* result) const;
+
+  std::vector<CsvTimestampColumn> columns_;
+  /* columns_按列号排序后的下标 */
+  std::vector<std::size_t> order_;
+  char delimiter_;
+  bool has_header_;
+  unsigned num_threads_;
+};
+
+}  // namespace datetime
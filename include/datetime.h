@@ -4,9 +4,15 @@
 #include <chrono>
 #include <compare>
 #include <cstdint>
+#include <cstring>
 #include <functional>
+#include <limits>
+#include <memory_resource>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 namespace datetime {
 
@@ -19,21 +25,49 @@ namespace detail {
 struct NonCheckTag {};
 struct NonNormTag {};
 struct NonNormNonCheckTag {};
+template <class T>
+struct key_traits;
 }  // namespace detail
 
+/* year -> 1 if leap year, else 0. */
+int is_leap(int year);
+
+/* year, month -> number of days in that month in that year */
+int days_in_month(int year, int month);
+
+/* Day of week, where Monday==0, ..., Sunday==6.  1/1/1 was a Monday. */
+int weekday(int year, int month, int day);
+
+/**
+ * @brief 不抛出异常的strptime，直接得到UTC微秒时间戳
+ * 格式化符号与datetime::strptime相同，成功时结果等于datetime::strptime(str, fmt).utctimestamp()。
+ * @return false 无法解析或字段超出范围
+ */
+bool strptime_timestamp(std::string_view str, std::string_view fmt, long long* timestamp);
+
 struct IsoCalendarDate {
   int year;
   int week;
   int weekday;
 };
 
+/**
+ * @brief 批量计算ISO日历，结果与date::fromordinal(ordinals[i]).isocalendar()相同
+ * 使用预先计算的每年ISO第1周周一的序数，不需要先转换为年月日。
+ * @param ordinals date::toordinal()的结果
+ * @param n
+ * @param out 至少n个元素
+ * @exception std::out_of_range ordinal超出[1, kMaxOrdinal]
+ */
+void isocalendar(const int* ordinals, std::size_t n, IsoCalendarDate* out);
+
 class timedelta {
  public:
-  timedelta() {}
+  constexpr timedelta() {}
   explicit timedelta(int days, int seconds = 0, int microseconds = 0);
   timedelta(int days, int seconds, int microseconds, int milliseconds, int minutes = 0,
             int hours = 0, int weeks = 0);
-  timedelta(const timedelta& other);
+  constexpr timedelta(const timedelta& other) = default;
 
   timedelta(std::chrono::weeks weeks);
   timedelta(std::chrono::days days);
@@ -41,7 +75,7 @@ class timedelta {
   timedelta(std::chrono::minutes minutes);
   timedelta(std::chrono::seconds seconds);
   timedelta(std::chrono::milliseconds milliseconds);
-  timedelta(std::chrono::microseconds microseconds);
+  constexpr timedelta(std::chrono::microseconds microseconds);
 
   static timedelta min() { return timedelta(-kMaxDeltaDays); }
   static timedelta max() { return timedelta(kMaxDeltaDays, 59, 99999, 0, 59, 23, 0); }
@@ -51,7 +85,7 @@ class timedelta {
   long total_milliseconds() const;
   long total_microseconds() const { return delta_to_microseconds(); }
 
-  operator bool() const { return days_ != 0 || seconds_ != 0 || microseconds_ != 0; }
+  explicit operator bool() const { return days_ != 0 || seconds_ != 0 || microseconds_ != 0; }
 
   timedelta& operator=(const timedelta& rhs);
   timedelta operator+(const timedelta& rhs) const;
@@ -74,9 +108,15 @@ class timedelta {
   timedelta& operator/=(int n);
   friend timedelta operator*(int lhs, const timedelta& rhs);
 
-  int days() const { return days_; }
-  int seconds() const { return seconds_; }
-  int microseconds() const { return microseconds_; }
+  constexpr int days() const { return days_; }
+  constexpr int seconds() const { return seconds_; }
+  constexpr int microseconds() const { return microseconds_; }
+
+  /**
+   * @brief 转换为std::chrono::microseconds
+   * @exception std::overflow_error 总微秒数超出int64的范围
+   */
+  constexpr explicit operator std::chrono::microseconds() const;
 
   timedelta abs() const;
   std::string str() const;
@@ -84,7 +124,8 @@ class timedelta {
 
  private:
   timedelta(int days, int seconds, int microseconds, detail::NonNormTag);
-  timedelta(int days, int seconds, int microseconds, detail::NonNormNonCheckTag);
+  constexpr timedelta(int days, int seconds, int microseconds, detail::NonNormNonCheckTag)
+      : days_(days), seconds_(seconds), microseconds_(microseconds) {}
 
   static timedelta microseconds_to_delta(long us);
   long delta_to_microseconds() const;
@@ -103,6 +144,14 @@ class date {
  public:
   date(int year, int month, int day);
 
+  /**
+   * @brief 不检查参数的构造函数，调用者保证参数在合法范围内
+   * 用于由合法的值计算得到的结果，如normalize之后的字段或ord_to_ymd的结果，避免重复检查
+   */
+  constexpr date(int year, int month, int day, detail::NonCheckTag) {
+    set_fileds(year, month, day);
+  }
+
   static date today();
   static date fromisoformat(const std::string& date_string);
   static date fromtimestamp(std::chrono::microseconds timestamp);
@@ -110,14 +159,33 @@ class date {
   static date fromordinal(int ordinal);
   static date fromisocalendar(const IsoCalendarDate& iso_calendar);
 
+  /**
+   * @brief 从std::chrono的日期构造，纯序数运算，不调用libc
+   * @exception std::out_of_range 日期不合法或年份超出[kMinYear, kMaxYear]
+   */
+  constexpr explicit date(const std::chrono::year_month_day& ymd);
+  constexpr explicit date(const std::chrono::sys_days& days)
+      : date(std::chrono::year_month_day(days)) {}
+
+  constexpr operator std::chrono::year_month_day() const {
+    return std::chrono::year_month_day(std::chrono::year(year()),
+                                       std::chrono::month(static_cast<unsigned>(month())),
+                                       std::chrono::day(static_cast<unsigned>(day())));
+  }
+  constexpr operator std::chrono::sys_days() const {
+    return std::chrono::sys_days(static_cast<std::chrono::year_month_day>(*this));
+  }
+
   static date min() { return date(kMinYear, 1, 1, detail::NonCheckTag{}); }
   static date max() { return date(kMaxYear, 12, 31, detail::NonCheckTag{}); }
 
   static timedelta resolution() { return timedelta(1); }
 
-  int year() const { return (static_cast<int>(data_[0]) << 8) | static_cast<int>(data_[1]); }
-  int month() const { return static_cast<int>(data_[2]); }
-  int day() const { return static_cast<int>(data_[3]); }
+  constexpr int year() const {
+    return (static_cast<int>(data_[0]) << 8) | static_cast<int>(data_[1]);
+  }
+  constexpr int month() const { return static_cast<int>(data_[2]); }
+  constexpr int day() const { return static_cast<int>(data_[3]); }
   int weekday() const;
   int isoweekday() const { return weekday() + 1; }
   int toordinal() const;
@@ -132,24 +200,33 @@ class date {
   timedelta operator-(const date& rhs) const;
 
   std::string strftime(const std::string& format) const;
+  /* 使用resource分配结果，见datetime::strftime(const std::string&, std::pmr::memory_resource*) */
+  std::pmr::string strftime(const std::string& format, std::pmr::memory_resource* resource) const;
 
   std::string ctime() const;
   std::string isoformat() const;
+  std::pmr::string isoformat(std::pmr::memory_resource* resource) const;
+
+  /**
+   * @brief 与isoformat()相同，写入buf而不分配内存，不添加'\0'
+   * @param buf 至少kIsoformatSize字节
+   * @return std::size_t 写入的字节数，总是kIsoformatSize
+   */
+  static constexpr std::size_t kIsoformatSize = 10;
+  std::size_t isoformat(char* buf) const;
 
   std::string str() const;
   std::string repr() const;
 
  private:
-  date(int year, int month, int day, detail::NonCheckTag);
-
-  void set_year(int year) {
+  constexpr void set_year(int year) {
     data_[0] = static_cast<unsigned char>((year & 0xff00) >> 8);
     data_[1] = static_cast<unsigned char>(year & 0x00ff);
   }
-  void set_month(int month) { data_[2] = static_cast<unsigned char>(month); }
-  void set_day(int day) { data_[3] = static_cast<unsigned char>(day); }
+  constexpr void set_month(int month) { data_[2] = static_cast<unsigned char>(month); }
+  constexpr void set_day(int day) { data_[3] = static_cast<unsigned char>(day); }
 
-  void set_fileds(int year, int month, int day) {
+  constexpr void set_fileds(int year, int month, int day) {
     set_year(year);
     set_month(month);
     set_day(day);
@@ -157,6 +234,7 @@ class date {
 
   friend class datetime;
   friend class std::hash<date>;
+  friend struct detail::key_traits<date>;
 
   static constexpr int kDataSize = 4;
   unsigned char data_[kDataSize];
@@ -171,6 +249,14 @@ class time {
 
   explicit time(int hour, int minute = 0, int second = 0, int usecond = 0);
 
+  /* 不检查参数，见date(int, int, int, detail::NonCheckTag) */
+  constexpr time(int hour, int minute, int second, int usecond, detail::NonCheckTag) {
+    set_hour(hour);
+    set_minute(minute);
+    set_second(second);
+    set_microsecond(usecond);
+  }
+
   /**
    * @brief 从iso格式构造time
    * 不支持时区，如果有则会忽略。
@@ -205,24 +291,32 @@ class time {
   std::strong_ordering operator<=>(const time& rhs) const = default;
 
   std::string strftime(const std::string& format) const;
+  std::pmr::string strftime(const std::string& format, std::pmr::memory_resource* resource) const;
 
   /**
-   * @brief 转换成HH:MM:SS格式的字符串
+   * @brief 转换成HH:MM:SS格式的字符串，微秒数不为0时为HH:MM:SS.ffffff
    *
    * @return std::string
    */
   std::string isoformat() const;
+  std::pmr::string isoformat(std::pmr::memory_resource* resource) const;
+
+  /**
+   * @brief 与isoformat()相同，写入buf而不分配内存，不添加'\0'
+   * @param buf 至少kMaxIsoformatSize字节
+   * @return std::size_t 写入的字节数
+   */
+  static constexpr std::size_t kMaxIsoformatSize = 15;
+  std::size_t isoformat(char* buf) const;
 
   std::string str() const;
   std::string repr() const;
 
  private:
-  time(int hour, int minute, int second, int usecond, detail::NonCheckTag);
-
-  void set_hour(int hour) { data_[0] = static_cast<unsigned char>(hour); }
-  void set_minute(int minute) { data_[1] = static_cast<unsigned char>(minute); }
-  void set_second(int second) { data_[2] = static_cast<unsigned char>(second); }
-  void set_microsecond(int microsecond) {
+  constexpr void set_hour(int hour) { data_[0] = static_cast<unsigned char>(hour); }
+  constexpr void set_minute(int minute) { data_[1] = static_cast<unsigned char>(minute); }
+  constexpr void set_second(int second) { data_[2] = static_cast<unsigned char>(second); }
+  constexpr void set_microsecond(int microsecond) {
     data_[3] = static_cast<unsigned char>((microsecond & 0xff0000) >> 16);
     data_[4] = static_cast<unsigned char>((microsecond & 0x00ff00) >> 8);
     data_[5] = static_cast<unsigned char>((microsecond & 0x0000ff));
@@ -239,7 +333,34 @@ class datetime {
  public:
   datetime(int year, int month, int day, int hour = 0, int minute = 0, int second = 0,
            int usecond = 0);
-  datetime(const datetime& other);
+  datetime(const datetime& other) = default;
+
+  /* 不检查参数，见date(int, int, int, detail::NonCheckTag) */
+  constexpr datetime(int year, int month, int day, int hour, int minute, int second, int usecond,
+                     detail::NonCheckTag) {
+    set_year(year);
+    set_month(month);
+    set_day(day);
+    set_hour(hour);
+    set_minute(minute);
+    set_second(second);
+    set_microsecond(usecond);
+  }
+
+  /**
+   * @brief 从std::chrono的时间点构造，纯序数运算，不调用libc
+   * sys_time视为UTC时间，与utcfromtimestamp相同；local_time为不带时区的本地时间，字段原样保留。
+   * @exception std::out_of_range 超出[datetime::min(), datetime::max()]
+   */
+  constexpr explicit datetime(const std::chrono::sys_time<std::chrono::microseconds>& tp);
+  constexpr explicit datetime(const std::chrono::local_time<std::chrono::microseconds>& tp)
+      : datetime(std::chrono::sys_time<std::chrono::microseconds>(tp.time_since_epoch())) {}
+
+  constexpr operator std::chrono::sys_time<std::chrono::microseconds>() const;
+  constexpr operator std::chrono::local_time<std::chrono::microseconds>() const {
+    return std::chrono::local_time<std::chrono::microseconds>(
+        static_cast<std::chrono::sys_time<std::chrono::microseconds>>(*this).time_since_epoch());
+  }
 
   static datetime now();
 
@@ -273,6 +394,17 @@ class datetime {
    * @return datetime
    */
   static datetime fromtimestamp(std::chrono::microseconds timestamp);
+
+  /**
+   * @brief 从微秒时间戳创建datetime，不做时区转换
+   * 即把时间戳视为UTC，结果等于datetime(1970, 1, 1) + timedelta(0, 0, timestamp)。
+   * 纯序数运算实现，不调用localtime_r。
+   *
+   * @param timestamp 自1970-01-01T00:00:00起的微秒数
+   * @return datetime
+   * @exception std::out_of_range 结果超出[datetime::min(), datetime::max()]
+   */
+  static datetime utcfromtimestamp(std::chrono::microseconds timestamp);
   static datetime fromordinal(int ordinal);
   static datetime fromisocalendar(const IsoCalendarDate& iso_calendar);
   static datetime combine(const ::datetime::date& d, const ::datetime::time& t);
@@ -293,20 +425,22 @@ class datetime {
 
   timedelta operator-(const datetime& rhs) const;
 
-  ::datetime::date date() const {
+  constexpr ::datetime::date date() const {
     return ::datetime::date(year(), month(), day(), detail::NonCheckTag{});
   }
   ::datetime::time time() const {
     return ::datetime::time(hour(), minute(), second(), microsecond(), detail::NonCheckTag{});
   }
 
-  int year() const { return (static_cast<int>(data_[0]) << 8) | static_cast<int>(data_[1]); }
-  int month() const { return static_cast<int>(data_[2]); }
-  int day() const { return static_cast<int>(data_[3]); }
-  int hour() const { return static_cast<int>(data_[4]); }
-  int minute() const { return static_cast<int>(data_[5]); }
-  int second() const { return static_cast<int>(data_[6]); }
-  int microsecond() const {
+  constexpr int year() const {
+    return (static_cast<int>(data_[0]) << 8) | static_cast<int>(data_[1]);
+  }
+  constexpr int month() const { return static_cast<int>(data_[2]); }
+  constexpr int day() const { return static_cast<int>(data_[3]); }
+  constexpr int hour() const { return static_cast<int>(data_[4]); }
+  constexpr int minute() const { return static_cast<int>(data_[5]); }
+  constexpr int second() const { return static_cast<int>(data_[6]); }
+  constexpr int microsecond() const {
     return (static_cast<int>(data_[7]) << 16) | (static_cast<int>(data_[8]) << 8) |
            static_cast<int>(data_[9]);
   }
@@ -317,6 +451,14 @@ class datetime {
 
   std::chrono::microseconds timestamp() const;
 
+  /**
+   * @brief 把datetime视为UTC时间，返回自1970-01-01T00:00:00起的微秒数
+   * utcfromtimestamp的逆运算，不做时区转换。
+   *
+   * @return std::chrono::microseconds
+   */
+  std::chrono::microseconds utctimestamp() const;
+
   /**
    * @brief datetime转字符串
    * 和python的strftime格式化符号基本一致
@@ -349,33 +491,53 @@ class datetime {
    */
   std::string strftime(const std::string& format) const;
 
+  /**
+   * @brief 与strftime(const std::string&)相同，结果的内存从resource分配
+   * 配合std::pmr::monotonic_buffer_resource等可以避免每次调用都向堆申请内存
+   */
+  std::pmr::string strftime(const std::string& format, std::pmr::memory_resource* resource) const;
+
   std::string ctime() const;
 
+  /**
+   * @brief 转换成YYYY-MM-DDTHH:MM:SS格式的字符串，微秒数不为0时为YYYY-MM-DDTHH:MM:SS.ffffff
+   */
   std::string str() const;
+  std::pmr::string str(std::pmr::memory_resource* resource) const;
+
+  /**
+   * @brief 与str()相同，写入buf而不分配内存，不添加'\0'
+   * 结果不超过kMaxStrSize字节，可以放在栈上的缓冲区中，如：
+   *    char buf[datetime::kMaxStrSize];
+   *    fwrite(buf, 1, dt.str(buf), file);
+   * @param buf 至少kMaxStrSize字节
+   * @return std::size_t 写入的字节数
+   */
+  static constexpr std::size_t kMaxStrSize = 26;
+  std::size_t str(char* buf) const;
+
   std::string repr() const;
 
  private:
-  datetime(int year, int month, int day, int hour, int minute, int second, int usecond,
-           detail::NonCheckTag);
-
-  void set_year(int year) {
+  constexpr void set_year(int year) {
     data_[0] = static_cast<unsigned char>((year & 0xff00) >> 8);
     data_[1] = static_cast<unsigned char>(year & 0x00ff);
   }
-  void set_month(int month) { data_[2] = static_cast<unsigned char>(month); }
-  void set_day(int day) { data_[3] = static_cast<unsigned char>(day); }
-  void set_hour(int hour) { data_[4] = static_cast<unsigned char>(hour); }
-  void set_minute(int minute) { data_[5] = static_cast<unsigned char>(minute); }
-  void set_second(int second) { data_[6] = static_cast<unsigned char>(second); }
-  void set_microsecond(int microsecond) {
+  constexpr void set_month(int month) { data_[2] = static_cast<unsigned char>(month); }
+  constexpr void set_day(int day) { data_[3] = static_cast<unsigned char>(day); }
+  constexpr void set_hour(int hour) { data_[4] = static_cast<unsigned char>(hour); }
+  constexpr void set_minute(int minute) { data_[5] = static_cast<unsigned char>(minute); }
+  constexpr void set_second(int second) { data_[6] = static_cast<unsigned char>(second); }
+  constexpr void set_microsecond(int microsecond) {
     data_[7] = static_cast<unsigned char>((microsecond & 0xff0000) >> 16);
     data_[8] = static_cast<unsigned char>((microsecond & 0x00ff00) >> 8);
     data_[9] = static_cast<unsigned char>((microsecond & 0x0000ff));
   }
 
   friend class std::hash<datetime>;
+  friend struct detail::key_traits<datetime>;
 
-  static datetime kDatetimeEpoch;
+  static const datetime kDatetimeEpoch;
 
   static constexpr int kDataSize = 10;
   unsigned char data_[kDataSize];
@@ -383,16 +545,202 @@ class datetime {
 
 inline timedelta operator*(int lhs, const timedelta& rhs) { return rhs * lhs; }
 
+/**
+ * @brief 批量检查列式的字段并构造datetime，不合法的行不抛出异常而是记录在valid_mask中
+ * 检查与datetime的构造函数相同。每8行一组做无分支的范围检查，2月先按29天检查，
+ * 只有2月29日的行再检查闰年。
+ * @param year,month,day,hour,minute,second,microsecond 每列n个元素
+ * @param n 行数
+ * @param out 至少n个元素，不合法的行为datetime::min()
+ * @param valid_mask 至少(n + 7) / 8字节，第i行合法时valid_mask[i / 8]的第i % 8位为1，多余的位为0
+ * @return std::size_t 合法的行数
+ */
+std::size_t validate_and_build(const int* year, const int* month, const int* day, const int* hour,
+                               const int* minute, const int* second, const int* microsecond,
+                               std::size_t n, datetime* out, uint8_t* valid_mask);
+
+/**
+ * @brief 字符串列，所有字符串连续保存在chars中，布局与Arrow的large_string相同
+ * 第i个字符串为chars[offsets[i], offsets[i + 1])，offsets总是比字符串数多一个元素。
+ * 批量格式化时所有结果追加到同一块内存，不需要为每个结果分配std::string。
+ * 示例：
+ *    std::pmr::monotonic_buffer_resource arena;
+ *    StringColumn column(&arena);
+ *    str(datetimes.data(), datetimes.size(), &column);
+ *    std::string_view s = column[0];
+ */
+struct StringColumn {
+  explicit StringColumn(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : offsets(1, 0, resource), chars(resource) {}
+
+  std::size_t size() const { return offsets.size() - 1; }
+  bool empty() const { return offsets.size() == 1; }
+  std::string_view operator[](std::size_t i) const {
+    return std::string_view(chars.data() + offsets[i],
+                            static_cast<std::size_t>(offsets[i + 1] - offsets[i]));
+  }
+  void clear() {
+    offsets.resize(1);
+    chars.clear();
+  }
+
+  std::pmr::vector<int64_t> offsets;
+  std::pmr::vector<char> chars;
+};
+
+/**
+ * @brief 批量格式化，结果依次追加到out，与逐个调用isoformat()/str()/strftime()的结果相同
+ * @param values n个元素
+ * @exception std::invalid_argument strftime的format不合法，此时out不变
+ */
+void isoformat(const date* values, std::size_t n, StringColumn* out);
+void isoformat(const time* values, std::size_t n, StringColumn* out);
+void str(const datetime* values, std::size_t n, StringColumn* out);
+void strftime(const datetime* values, std::size_t n, const std::string& format,
+              StringColumn* out);
+
+/* ---------------------------------------------------------------------------
+ * std::chrono
+ */
+
+constexpr timedelta::timedelta(std::chrono::microseconds microseconds) {
+  if (std::is_constant_evaluated()) {
+    /* 编译期不能调用frommicroseconds，按同样的规则取整，超出范围时throw使求值失败 */
+    /* 先除后借位，chrono::floor在LLONG_MIN附近做减法会溢出 */
+    constexpr long long kDayUs = 86400000000LL;
+    long long days = microseconds.count() / kDayUs;
+    long long rest = microseconds.count() % kDayUs;
+    if (rest < 0) {
+      --days;
+      rest += kDayUs;
+    }
+    if (days < -kMaxDeltaDays || days > kMaxDeltaDays) {
+      throw std::out_of_range("timedelta: std::chrono::microseconds out of range");
+    }
+    days_ = static_cast<int>(days);
+    seconds_ = static_cast<int>(rest / 1000000);
+    microseconds_ = static_cast<int>(rest % 1000000);
+  } else {
+    frommicroseconds(microseconds.count());
+  }
+}
+
+constexpr timedelta::operator std::chrono::microseconds() const {
+  /* 全程用long long计算并在相加前检查，避免中间结果溢出 */
+  constexpr long long kDayUs = 86400000000LL;
+  constexpr long long kMaxDays = std::numeric_limits<long long>::max() / kDayUs;
+  long long days = days_;
+  long long rest = seconds_ * 1000000LL + microseconds_; /* [0, kDayUs) */
+  if (days < 0) {
+    /* 负数时向零借一天，使days * kDayUs在LLONG_MIN附近也不溢出 */
+    ++days;
+    rest -= kDayUs;
+  }
+  if (days > kMaxDays || days < -kMaxDays) {
+    throw std::overflow_error("timedelta: Too large to convert to std::chrono::microseconds");
+  }
+  long long base = days * kDayUs;
+  if (rest >= 0 ? base > std::numeric_limits<long long>::max() - rest
+                : base < std::numeric_limits<long long>::min() - rest) {
+    throw std::overflow_error("timedelta: Too large to convert to std::chrono::microseconds");
+  }
+  return std::chrono::microseconds(base + rest);
+}
+
+constexpr date::date(const std::chrono::year_month_day& ymd) {
+  int y = static_cast<int>(ymd.year());
+  if (!ymd.ok() || y < kMinYear || y > kMaxYear) {
+    throw std::out_of_range("date: year_month_day out of range");
+  }
+  set_fileds(y, static_cast<int>(static_cast<unsigned>(ymd.month())),
+             static_cast<int>(static_cast<unsigned>(ymd.day())));
+}
+
+constexpr datetime::datetime(const std::chrono::sys_time<std::chrono::microseconds>& tp) {
+  namespace chrono = std::chrono;
+  constexpr chrono::sys_days kMin = chrono::year(kMinYear) / 1 / 1;
+  constexpr chrono::sys_days kMax = chrono::year(kMaxYear) / 12 / 31;
+  auto days = chrono::floor<chrono::days>(tp);
+  if (days < kMin || days > kMax) {
+    throw std::out_of_range("datetime: sys_time out of range");
+  }
+  chrono::year_month_day ymd(days);
+  long long us = (tp - days).count();
+  set_year(static_cast<int>(ymd.year()));
+  set_month(static_cast<int>(static_cast<unsigned>(ymd.month())));
+  set_day(static_cast<int>(static_cast<unsigned>(ymd.day())));
+  set_hour(static_cast<int>(us / 3600000000));
+  set_minute(static_cast<int>(us / 60000000 % 60));
+  set_second(static_cast<int>(us / 1000000 % 60));
+  set_microsecond(static_cast<int>(us % 1000000));
+}
+
+constexpr datetime::operator std::chrono::sys_time<std::chrono::microseconds>() const {
+  return std::chrono::sys_days(date()) + std::chrono::hours(hour()) +
+         std::chrono::minutes(minute()) + std::chrono::seconds(second()) +
+         std::chrono::microseconds(microsecond());
+}
+
 }  // namespace datetime
 
+namespace datetime::detail {
+/* murmur3的64位finalizer，输入的每一位都会影响输出的每一位 */
+inline uint64_t hash_mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+/**
+ * @brief 把date/datetime与整数key相互转换，key的大小顺序与值的顺序一致，且不会为0
+ * 与utctimestamp等不同，只需要移位，不需要计算序数
+ */
+template <>
+struct key_traits<date> {
+  using key_type = uint32_t;
+  /* year:14 month:4 day:5 */
+  static key_type pack(const date& d) {
+    return (static_cast<uint32_t>(d.year()) << 9) | (static_cast<uint32_t>(d.month()) << 5) |
+           static_cast<uint32_t>(d.day());
+  }
+  static date unpack(key_type key) {
+    return date(static_cast<int>(key >> 9), static_cast<int>((key >> 5) & 0xf),
+                static_cast<int>(key & 0x1f), NonCheckTag{});
+  }
+};
+
+template <>
+struct key_traits<datetime> {
+  using key_type = uint64_t;
+  /* year:14 month:4 day:5 hour:5 minute:6 second:6 microsecond:20 */
+  static key_type pack(const datetime& dt) {
+    return (static_cast<uint64_t>(dt.year()) << 46) | (static_cast<uint64_t>(dt.month()) << 42) |
+           (static_cast<uint64_t>(dt.day()) << 37) | (static_cast<uint64_t>(dt.hour()) << 32) |
+           (static_cast<uint64_t>(dt.minute()) << 26) |
+           (static_cast<uint64_t>(dt.second()) << 20) | static_cast<uint64_t>(dt.microsecond());
+  }
+  static datetime unpack(key_type key) {
+    return datetime(static_cast<int>(key >> 46), static_cast<int>((key >> 42) & 0xf),
+                    static_cast<int>((key >> 37) & 0x1f), static_cast<int>((key >> 32) & 0x1f),
+                    static_cast<int>((key >> 26) & 0x3f), static_cast<int>((key >> 20) & 0x3f),
+                    static_cast<int>(key & 0xfffff), NonCheckTag{});
+  }
+};
+}  // namespace datetime::detail
+
+/* 把各字段拼成一个整数再混合：date的4字节、time的6字节可以直接加载，datetime的有效字段共60位 */
 namespace std {
 template <>
 struct hash<datetime::timedelta> {
   using argument_type = datetime::timedelta;
   using result_type = std::size_t;
-  result_type operator()(const argument_type& delta) const {
-    auto data = delta.delta_to_microseconds();
-    return std::hash<decltype(data)>{}(data);
+  result_type operator()(const argument_type& delta) const noexcept {
+    uint64_t us = static_cast<uint64_t>(delta.seconds()) * 1000000 + delta.microseconds();
+    return datetime::detail::hash_mix(
+        datetime::detail::hash_mix(static_cast<uint64_t>(delta.days())) ^ us);
   }
 };
 
@@ -400,9 +748,10 @@ template <>
 struct hash<datetime::date> {
   using argument_type = datetime::date;
   using result_type = std::size_t;
-  result_type operator()(const argument_type& d) const {
-    std::string_view bytes((const char*)d.data_, d.kDataSize);
-    return std::hash<std::string_view>{}(bytes);
+  result_type operator()(const argument_type& d) const noexcept {
+    uint32_t key;
+    std::memcpy(&key, d.data_, sizeof(key));
+    return datetime::detail::hash_mix(key);
   }
 };
 
@@ -410,9 +759,13 @@ template <>
 struct hash<datetime::time> {
   using argument_type = datetime::time;
   using result_type = std::size_t;
-  result_type operator()(const argument_type& t) const {
-    std::string_view bytes((const char*)t.data_, t.kDataSize);
-    return std::hash<std::string_view>{}(bytes);
+  result_type operator()(const argument_type& t) const noexcept {
+    /* 分成4字节和2字节加载，先写入8字节的变量再读取会导致store forwarding失败 */
+    uint32_t hi;
+    uint16_t lo;
+    std::memcpy(&hi, t.data_, sizeof(hi));
+    std::memcpy(&lo, t.data_ + sizeof(hi), sizeof(lo));
+    return datetime::detail::hash_mix((static_cast<uint64_t>(hi) << 16) | lo);
   }
 };
 
@@ -421,8 +774,7 @@ struct hash<datetime::datetime> {
   using argument_type = datetime::datetime;
   using result_type = std::size_t;
   result_type operator()(const argument_type& dt) const noexcept {
-    std::string_view bytes((const char*)dt.data_, dt.kDataSize);
-    return std::hash<std::string_view>{}(bytes);
+    return datetime::detail::hash_mix(datetime::detail::key_traits<datetime::datetime>::pack(dt));
   }
 };
 }  // namespace std
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "datetime.h"
+
+namespace datetime {
+
+/**
+ * @brief 以date或datetime为key的有序map，key和value分别保存在连续的数组中
+ * key保存为detail::key_traits打包后的整数，查找为无分支的二分查找。
+ * 按时间顺序插入时(新的key不早于最后一个key)直接追加到末尾，为O(1)；
+ * 其他位置的插入和删除需要移动后面的元素，为O(n)。
+ * 插入和删除会使value的指针失效。
+ * 示例：
+ *    datetime_flat_map<datetime, double> bars;
+ *    bars[dt] += volume;
+ *    for (std::size_t i = bars.lower_bound(start); i < bars.size() && bars.key(i) < end; ++i) {
+ *      ...
+ *    }
+ */
+template <class Key, class T>
+class datetime_flat_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+
+  /**
+   * @brief 插入key，已存在时不修改
+   * @return std::pair<T*, bool> value的指针，是否插入了新元素
+   */
+  template <class... Args>
+  std::pair<T*, bool> try_emplace(const Key& key, Args&&... args) {
+    auto k = traits::pack(key);
+    std::size_t i = keys_.size();
+    if (keys_.empty() || keys_.back() < k) {
+      keys_.push_back(k);
+      values_.emplace_back(std::forward<Args>(args)...);
+      return {&values_.back(), true};
+    }
+    if (keys_.back() != k) {
+      i = lower_bound_key(k);
+      if (keys_[i] != k) {
+        keys_.insert(keys_.begin() + i, k);
+        values_.emplace(values_.begin() + i, std::forward<Args>(args)...);
+        return {&values_[i], true};
+      }
+    } else {
+      --i;
+    }
+    return {&values_[i], false};
+  }
+
+  /**
+   * @brief 插入key或修改已存在的value
+   * @return true 插入了新元素
+   */
+  template <class M>
+  bool insert_or_assign(const Key& key, M&& value) {
+    auto [p, inserted] = try_emplace(key, std::forward<M>(value));
+    if (!inserted) {
+      *p = std::forward<M>(value);
+    }
+    return inserted;
+  }
+
+  T& operator[](const Key& key) { return *try_emplace(key).first; }
+
+  /**
+   * @brief 查找key
+   * @return T* 不存在时为nullptr
+   */
+  T* find(const Key& key) {
+    std::size_t i = index_of(traits::pack(key));
+    return i == keys_.size() ? nullptr : &values_[i];
+  }
+  const T* find(const Key& key) const {
+    std::size_t i = index_of(traits::pack(key));
+    return i == keys_.size() ? nullptr : &values_[i];
+  }
+
+  bool contains(const Key& key) const { return index_of(traits::pack(key)) != keys_.size(); }
+
+  /**
+   * @brief 删除key
+   * @return false key不存在
+   */
+  bool erase(const Key& key) {
+    std::size_t i = index_of(traits::pack(key));
+    if (i == keys_.size()) {
+      return false;
+    }
+    keys_.erase(keys_.begin() + i);
+    values_.erase(values_.begin() + i);
+    return true;
+  }
+
+  /**
+   * @brief 第一个不早于key的元素的下标，都早于key时返回size()
+   */
+  std::size_t lower_bound(const Key& key) const { return lower_bound_key(traits::pack(key)); }
+
+  /**
+   * @brief 第一个晚于key的元素的下标，都不晚于key时返回size()
+   */
+  std::size_t upper_bound(const Key& key) const { return lower_bound_key(traits::pack(key) + 1); }
+
+  /**
+   * @brief 按key从小到大的第i个元素
+   */
+  Key key(std::size_t i) const { return traits::unpack(keys_[i]); }
+  T& value(std::size_t i) { return values_[i]; }
+  const T& value(std::size_t i) const { return values_[i]; }
+
+  /**
+   * @brief 按key从小到大对每个元素调用f(const Key&, T&)
+   */
+  template <class F>
+  void for_each(F&& f) {
+    for (std::size_t i = 0; i < keys_.size(); ++i) {
+      f(traits::unpack(keys_[i]), values_[i]);
+    }
+  }
+  template <class F>
+  void for_each(F&& f) const {
+    for (std::size_t i = 0; i < keys_.size(); ++i) {
+      f(traits::unpack(keys_[i]), values_[i]);
+    }
+  }
+
+  std::size_t size() const { return keys_.size(); }
+  bool empty() const { return keys_.empty(); }
+
+  void reserve(std::size_t n) {
+    keys_.reserve(n);
+    values_.reserve(n);
+  }
+
+  void clear() {
+    keys_.clear();
+    values_.clear();
+  }
+
+ private:
+  using traits = detail::key_traits<Key>;
+  using packed_type = typename traits::key_type;
+
+  /* 每次循环把范围减半，比较结果只用于选择下一个起点，编译为cmov而不是分支 */
+  std::size_t lower_bound_key(packed_type k) const {
+    const packed_type* base = keys_.data();
+    std::size_t n = keys_.size();
+    if (n == 0) {
+      return 0;
+    }
+    while (n > 1) {
+      std::size_t half = n / 2;
+      base = base[half - 1] < k ? base + half : base;
+      n -= half;
+    }
+    return (base - keys_.data()) + (*base < k);
+  }
+
+  /* key所在的下标，不存在时返回size() */
+  std::size_t index_of(packed_type k) const {
+    std::size_t i = lower_bound_key(k);
+    return i < keys_.size() && keys_[i] == k ? i : keys_.size();
+  }
+
+  std::vector<packed_type> keys_;
+  std::vector<T> values_;
+};
+
+}  // namespace datetime
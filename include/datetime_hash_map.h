@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "datetime.h"
+
+namespace datetime {
+
+/**
+ * @brief 以date或datetime为key的开放寻址hash map
+ * key保存为detail::key_traits打包后的整数(不会为0，0表示空槽)，使用线性探测，
+ * 负载因子不超过1/2，删除时把后面的元素向前移动而不是留下墓碑。
+ * key和value分别保存在连续的数组中，探测只访问key数组。
+ * 按时间顺序处理数据时同一个key往往被连续访问(如同一根bar)，最近一次访问的槽会被记住，
+ * 再次访问同一个key时不需要计算hash。
+ * T必须可以默认构造，空槽中保存默认构造的T。插入和删除会使value的指针失效。
+ * 示例：
+ *    datetime_hash_map<datetime, double> volumes;
+ *    volumes[bar_time] += volume;
+ *    if (auto p = volumes.find(bar_time)) {
+ *      ...
+ *    }
+ */
+template <class Key, class T>
+class datetime_hash_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+
+  /**
+   * @brief 插入key，已存在时不修改
+   * @return std::pair<T*, bool> value的指针，是否插入了新元素
+   */
+  template <class... Args>
+  std::pair<T*, bool> try_emplace(const Key& key, Args&&... args) {
+    auto k = traits::pack(key);
+    if (last_ < keys_.size() && keys_[last_] == k) {
+      return {&values_[last_], false};
+    }
+    if ((size_ + 1) * 2 > keys_.size()) {
+      rehash(keys_.empty() ? kMinCapacity : keys_.size() * 2);
+    }
+    std::size_t i = probe(k);
+    last_ = i;
+    if (keys_[i] == k) {
+      return {&values_[i], false};
+    }
+    keys_[i] = k;
+    values_[i] = T(std::forward<Args>(args)...);
+    ++size_;
+    return {&values_[i], true};
+  }
+
+  /**
+   * @brief 插入key或修改已存在的value
+   * @return true 插入了新元素
+   */
+  template <class M>
+  bool insert_or_assign(const Key& key, M&& value) {
+    auto [p, inserted] = try_emplace(key, std::forward<M>(value));
+    if (!inserted) {
+      *p = std::forward<M>(value);
+    }
+    return inserted;
+  }
+
+  T& operator[](const Key& key) { return *try_emplace(key).first; }
+
+  /**
+   * @brief 查找key
+   * @return T* 不存在时为nullptr
+   */
+  T* find(const Key& key) {
+    std::size_t i = index_of(traits::pack(key));
+    if (i == npos) {
+      return nullptr;
+    }
+    last_ = i;
+    return &values_[i];
+  }
+  const T* find(const Key& key) const {
+    std::size_t i = index_of(traits::pack(key));
+    return i == npos ? nullptr : &values_[i];
+  }
+
+  bool contains(const Key& key) const { return index_of(traits::pack(key)) != npos; }
+
+  /**
+   * @brief 删除key
+   * @return false key不存在
+   */
+  bool erase(const Key& key) {
+    std::size_t i = index_of(traits::pack(key));
+    if (i == npos) {
+      return false;
+    }
+    /* 把探测链上可以前移的元素移到空出的槽，保证查找遇到空槽即可停止 */
+    std::size_t mask = keys_.size() - 1;
+    for (std::size_t j = (i + 1) & mask; keys_[j] != 0; j = (j + 1) & mask) {
+      std::size_t home = slot(keys_[j]);
+      if (((j - home) & mask) >= ((j - i) & mask)) {
+        keys_[i] = keys_[j];
+        values_[i] = std::move(values_[j]);
+        i = j;
+      }
+    }
+    keys_[i] = 0;
+    values_[i] = T();
+    --size_;
+    last_ = npos;
+    return true;
+  }
+
+  /**
+   * @brief 对每个元素调用f(const Key&, T&)，顺序不确定
+   */
+  template <class F>
+  void for_each(F&& f) {
+    for (std::size_t i = 0; i < keys_.size(); ++i) {
+      if (keys_[i] != 0) {
+        f(traits::unpack(keys_[i]), values_[i]);
+      }
+    }
+  }
+  template <class F>
+  void for_each(F&& f) const {
+    for (std::size_t i = 0; i < keys_.size(); ++i) {
+      if (keys_[i] != 0) {
+        f(traits::unpack(keys_[i]), values_[i]);
+      }
+    }
+  }
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  /**
+   * @brief 预留空间，插入n个元素之前不会再rehash
+   */
+  void reserve(std::size_t n) {
+    std::size_t capacity = kMinCapacity;
+    while (capacity < n * 2) {
+      capacity *= 2;
+    }
+    if (capacity > keys_.size()) {
+      rehash(capacity);
+    }
+  }
+
+  void clear() {
+    keys_.clear();
+    values_.clear();
+    size_ = 0;
+    last_ = npos;
+  }
+
+ private:
+  using traits = detail::key_traits<Key>;
+  using packed_type = typename traits::key_type;
+
+  static constexpr std::size_t kMinCapacity = 16;
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  std::size_t slot(packed_type k) const { return detail::hash_mix(k) & (keys_.size() - 1); }
+
+  /* key所在的槽，不存在时为探测到的第一个空槽 */
+  std::size_t probe(packed_type k) const {
+    std::size_t mask = keys_.size() - 1;
+    std::size_t i = slot(k);
+    while (keys_[i] != k && keys_[i] != 0) {
+      i = (i + 1) & mask;
+    }
+    return i;
+  }
+
+  std::size_t index_of(packed_type k) const {
+    if (last_ < keys_.size() && keys_[last_] == k) {
+      return last_;
+    }
+    if (keys_.empty()) {
+      return npos;
+    }
+    std::size_t i = probe(k);
+    return keys_[i] == k ? i : npos;
+  }
+
+  void rehash(std::size_t capacity) {
+    std::vector<packed_type> keys(capacity);
+    std::vector<T> values(capacity);
+    keys_.swap(keys);
+    values_.swap(values);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      if (keys[i] != 0) {
+        std::size_t j = probe(keys[i]);
+        keys_[j] = keys[i];
+        values_[j] = std::move(values[i]);
+      }
+    }
+    last_ = npos;
+  }
+
+  std::vector<packed_type> keys_;
+  std::vector<T> values_;
+  std::size_t size_ = 0;
+  /* 最近一次访问的槽 */
+  std::size_t last_ = npos;
+};
+
+}  // namespace datetime
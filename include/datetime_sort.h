@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "datetime.h"
+
+namespace datetime {
+
+/**
+ * @brief 按时间升序排序
+ * 使用LSD基数排序，每趟11位。datetime先打包成detail::key_traits的60位整数，
+ * 时间戳按与最小值的差排序，只处理差值实际用到的位：年份在1-9999之间时不超过6趟，
+ * 一天以内的数据只需要4趟；所有元素在某一趟的数字都相同时跳过该趟。元素较少时使用std::sort。
+ * 多线程时每个线程排序一段，再用merge_sorted把各段归并起来。
+ * @param data 待排序的数组，datetime或UTC微秒时间戳，时间戳可以是任意long long
+ * @param n data的元素个数
+ * @param num_threads 线程数，0表示std::thread::hardware_concurrency()
+ */
+void radix_sort(::datetime::datetime* data, std::size_t n, unsigned num_threads = 1);
+void radix_sort(long long* data, std::size_t n, unsigned num_threads = 1);
+
+/**
+ * @brief 一个已经按升序排列的序列
+ */
+template <class T>
+struct SortedRun {
+  const T* data;
+  std::size_t size;
+};
+
+/**
+ * @brief 把k个已排序的序列归并成一个有序的序列
+ * 使用loser tree，每输出一个元素只需要log2(k)次比较，相等的元素按序列的先后输出。
+ * 多线程时从各序列中抽样选出分割点，按分割点把输出分成互不重叠的区间，每个线程归并一个区间。
+ * 示例，按时间合并多个交易所的成交：
+ *    std::vector<SortedRun<datetime>> runs;
+ *    for (auto& venue : venues) {
+ *      runs.push_back({venue.times.data(), venue.times.size()});
+ *    }
+ *    merge_sorted(runs, times.data(), sources.data());
+ *    // 第i个输出来自runs[sources[i]]，同一序列的元素保持原来的顺序
+ * @param out 至少为各序列长度之和
+ * @param run_index nullptr或与out的长度相同，记录每个输出元素来自哪个序列
+ * @param num_threads 线程数，0表示std::thread::hardware_concurrency()
+ */
+void merge_sorted(const std::vector<SortedRun<::datetime::datetime>>& runs,
+                  ::datetime::datetime* out, uint32_t* run_index = nullptr,
+                  unsigned num_threads = 1);
+void merge_sorted(const std::vector<SortedRun<long long>>& runs, long long* out,
+                  uint32_t* run_index = nullptr, unsigned num_threads = 1);
+
+}  // namespace datetime
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "datetime.h"
+
+namespace datetime {
+
+/**
+ * @brief Gorilla风格的时间戳压缩编码(delta-of-delta)
+ * 值为UTC微秒时间戳(见datetime::utctimestamp)，编码结果的格式：
+ *   8字节  值的个数，小端
+ *   64位   第一个值
+ *   之后每个值写入D = (v[i] - v[i-1]) - (v[i-1] - v[i-2])，第二个值的前一个差值视为0。
+ *   D先做zigzag变换得到z，再按大小选择一种编码：
+ *     z == 0         '0'
+ *     z < 2^7        '10'    + 7位
+ *     z < 2^12       '110'   + 12位
+ *     z < 2^20       '1110'  + 20位
+ *     z < 2^32       '11110' + 32位
+ *     其他           '11111' + 64位
+ *   位按从高到低的顺序写入字节，最后一个字节不足的部分补0。
+ * 间隔固定的序列每个值只需1位，间隔有微秒级抖动的序列每个值约1到3字节。
+ * 差值按64位无符号整数回绕计算，任意long long序列都可以无损还原。
+ *
+ * 示例：
+ *    delta_encoder enc;
+ *    for (auto& dt : datetimes) {
+ *      enc.append(dt);
+ *    }
+ *    const std::vector<uint8_t>& bytes = enc.finish();
+ *
+ *    delta_decoder dec(bytes);
+ *    long long us;
+ *    while (dec.next(&us)) {
+ *      ...
+ *    }
+ */
+class delta_encoder {
+ public:
+  delta_encoder() { clear(); }
+
+  void append(long long timestamp);
+  void append(const ::datetime::datetime& dt) { append(dt.utctimestamp().count()); }
+  void append(const long long* timestamps, std::size_t n);
+
+  /**
+   * @brief 已经写入的值的个数
+   */
+  std::size_t size() const { return count_; }
+
+  /**
+   * @brief 结束编码，写入值的个数并补齐最后一个字节
+   * 之后需要调用clear()才能开始新的编码。
+   *
+   * @return const std::vector<uint8_t>& 编码结果
+   */
+  const std::vector<uint8_t>& finish();
+
+  void clear();
+
+ private:
+  void put(uint64_t bits, int n);
+  void put_dod(uint64_t dod);
+
+  std::vector<uint8_t> bytes_;
+  uint64_t acc_;
+  int used_;
+  uint64_t prev_;
+  uint64_t prev_delta_;
+  std::size_t count_;
+};
+
+/**
+ * @brief delta_encoder的流式解码器
+ * 直接读取给定的内存，解码过程中不分配内存，data在解码期间必须有效。
+ */
+class delta_decoder {
+ public:
+  /**
+   * @brief
+   * @param data delta_encoder::finish()的结果
+   * @param size
+   * @exception std::invalid_argument 数据长度不足以容纳头部声明的值的个数
+   */
+  delta_decoder(const uint8_t* data, std::size_t size);
+  explicit delta_decoder(const std::vector<uint8_t>& bytes)
+      : delta_decoder(bytes.data(), bytes.size()) {}
+
+  /**
+   * @brief 解码下一个值
+   * @return false 已经没有更多的值
+   * @exception std::invalid_argument 数据被截断，之后再调用next也会抛出
+   */
+  bool next(long long* timestamp);
+
+  /**
+   * @brief 解码下一个值并转换为datetime
+   * @exception std::out_of_range 值超出datetime的范围
+   */
+  bool next(::datetime::datetime* dt);
+
+  /**
+   * @brief 最多解码n个值到out
+   * @return std::size_t 解码的值的个数
+   */
+  std::size_t next(long long* out, std::size_t n);
+
+  /**
+   * @brief 值的总个数
+   */
+  std::size_t size() const { return count_; }
+  std::size_t remaining() const { return count_ - index_; }
+
+ private:
+  /* 从pos_开始的64位，超出末尾的部分为0 */
+  uint64_t peek() const;
+  void skip(int n);
+  long long decode_one();
+
+  const uint8_t* data_;
+  std::size_t bits_;
+  std::size_t pos_;
+  std::size_t count_;
+  std::size_t index_ = 0;
+  uint64_t prev_ = 0;
+  uint64_t prev_delta_ = 0;
+};
+
+}  // namespace datetime
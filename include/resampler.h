@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "datetime.h"
+
+namespace datetime {
+
+/**
+ * @brief 一个时间区间[start, end)内的聚合结果
+ * start和end均为UTC微秒时间戳，见datetime::utctimestamp
+ */
+struct ResampleBucket {
+  long long start;
+  long long end;
+  double first;
+  double last;
+  double min;
+  double max;
+  double sum;
+  long count;
+
+  ::datetime::datetime start_time() const;
+  ::datetime::datetime end_time() const;
+};
+
+/**
+ * @brief 流式的时间分桶聚合器，用于从tick生成OHLC等bar
+ * 每个tick按interval向下取整分配到bucket，并增量维护first/last/min/max/sum/count，
+ * 每个tick的开销为O(1)。tick必须按时间递增输入，早于当前bucket的tick会被丢弃。
+ *
+ * 没有设置交易时段时，interval小于一天的bucket以每天0点为起点对齐，且不会跨越0点；
+ * interval不小于一天的bucket以1970-01-01T00:00:00为起点对齐。
+ * 设置了交易时段后，bucket以时段开始时间为起点对齐，不会跨越时段边界，
+ * 时段之外的tick会被丢弃。
+ *
+ * 示例：
+ *    resampler r(timedelta(0, 60));
+ *    for (auto& [dt, price] : ticks) {
+ *      if (r.update(dt, price)) {
+ *        on_bar(r.closed());
+ *      }
+ *    }
+ *    if (r.flush()) {
+ *      on_bar(r.closed());
+ *    }
+ */
+class resampler {
+ public:
+  /**
+   * @brief
+   * @param interval bucket的长度
+   * @exception std::invalid_argument interval <= 0
+   */
+  explicit resampler(const timedelta& interval);
+
+  /**
+   * @brief 添加一个每日交易时段[open, close)
+   * close <= open表示跨越0点的夜盘时段，open所在的日期即为该时段所属的日期。
+   * 时段之间不能重叠。
+   */
+  void add_session(const ::datetime::time& open, const ::datetime::time& close);
+
+  /**
+   * @brief 输入一个tick
+   *
+   * @param timestamp UTC微秒时间戳
+   * @param value
+   * @return true 该tick使前一个bucket关闭，关闭的bucket可以通过closed()获取
+   */
+  bool update(long long timestamp, double value);
+  bool update(const ::datetime::datetime& dt, double value) {
+    return update(dt.utctimestamp().count(), value);
+  }
+
+  /**
+   * @brief 在没有tick的情况下推进时间，用于定时关闭bucket
+   *
+   * @param timestamp UTC微秒时间戳
+   * @return true 当前bucket已关闭
+   */
+  bool advance(long long timestamp);
+  bool advance(const ::datetime::datetime& dt) { return advance(dt.utctimestamp().count()); }
+
+  /**
+   * @brief 立即关闭当前bucket，例如在收盘或数据结束时
+   *
+   * @return true 存在未关闭的bucket并已将其关闭
+   */
+  bool flush();
+
+  const ResampleBucket& closed() const { return closed_; }
+  const ResampleBucket& current() const { return current_; }
+  bool has_current() const { return current_.count != 0; }
+
+  /**
+   * @brief 由于乱序或不在交易时段内而被丢弃的tick数
+   */
+  long dropped() const { return dropped_; }
+
+ private:
+  struct Session {
+    long long open;
+    long long length;
+  };
+
+  bool locate(long long timestamp, long long* start, long long* end) const;
+  void close_current();
+
+  long long interval_;
+  std::vector<Session> sessions_;
+
+  ResampleBucket current_;
+  ResampleBucket closed_;
+  long long watermark_;
+  long dropped_ = 0;
+};
+
+}  // namespace datetime
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "datetime.h"
+
+namespace datetime {
+
+/**
+ * @brief cron表达式
+ * 每个字段被解析为一个位掩码，next_after按 月 -> 日 -> 时 -> 分 的顺序在位掩码中
+ * 直接查找下一个满足条件的值，而不是逐分钟地尝试。
+ *
+ * 格式为"分 时 日 月 星期"，每个字段支持：
+ *     *        所有值
+ *     a        单个值
+ *     a-b      区间
+ *     * /n     步长(中间没有空格)，也可以是a/n、a-b/n
+ *     a,b-c    以上形式的列表
+ * 月份可以用JAN-DEC表示，星期可以用SUN-SAT表示，0和7都表示星期日。
+ * 同时限制了日和星期时，两者满足其一即可(与Vixie cron一致)。
+ * 另外支持@yearly、@annually、@monthly、@weekly、@daily、@midnight、@hourly。
+ * 示例：
+ *    datetime::schedule s("*\/15 9-15 * * MON-FRI");
+ *    auto next = s.next_after(datetime::datetime(2021, 8, 31, 15, 59, 55));
+ *    assert(next == datetime::datetime(2021, 9, 1, 9, 0));
+ */
+class schedule {
+ public:
+  /**
+   * @brief
+   * @param expr cron表达式
+   * @exception std::invalid_argument 无法解析，或者永远不会触发(如2月30日)
+   */
+  explicit schedule(const std::string& expr);
+
+  /**
+   * @brief dt之后(不含dt)的第一个触发时间，精确到分钟
+   * @exception std::out_of_range 在datetime::max()之前不会再触发
+   */
+  ::datetime::datetime next_after(const ::datetime::datetime& dt) const;
+
+  /**
+   * @brief 批量计算多个schedule在dt之后的第一个触发时间
+   */
+  static std::vector<::datetime::datetime> next_after(const std::vector<schedule>& schedules,
+                                                       const ::datetime::datetime& dt);
+
+  /**
+   * @brief dt所在的分钟是否是触发时间
+   */
+  bool matches(const ::datetime::datetime& dt) const;
+
+ private:
+  /* year, month -> 该月中满足日和星期条件的日期的掩码，第d位表示d日 */
+  uint32_t day_mask(int year, int month) const;
+
+  bool next_after(int* year, int* month, int* day, int* hour, int* minute) const;
+
+  uint64_t minutes_ = 0; /* 0-59 */
+  uint32_t hours_ = 0;   /* 0-23 */
+  uint32_t days_ = 0;    /* 1-31 */
+  uint16_t months_ = 0;  /* 1-12 */
+  uint8_t weekdays_ = 0; /* 0-6，0为星期日 */
+  bool days_restricted_ = false;
+  bool weekdays_restricted_ = false;
+};
+
+}  // namespace datetime
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+
+#include "business_calendar.h"
+#include "datetime.h"
+
+namespace datetime {
+
+/**
+ * @brief 每日的一个交易时段[open, close)
+ * close <= open表示跨越0点的时段(如夜盘21:00-02:30)，该时段属于open所在的日期
+ */
+struct TradingSession {
+  ::datetime::time open;
+  ::datetime::time close;
+};
+
+/**
+ * @brief 交易时段日历
+ * 构造时把[first, last]内每个交易日的所有时段展开为按时间排序的扁平数组，
+ * 并记录每个时段之前的累计交易时长，所有查询都是一次二分查找，即O(log n)。
+ * 时间均视为交易所当地时间，不做时区转换。
+ */
+class session_calendar {
+ public:
+  /**
+   * @brief [first, last]内的每一天都是交易日
+   * @exception std::invalid_argument first > last，或者时段之间有重叠
+   */
+  session_calendar(const date& first, const date& last,
+                   const std::vector<TradingSession>& sessions);
+
+  /**
+   * @brief 只有calendar中的工作日才是交易日
+   * @exception std::invalid_argument first > last，或者时段之间有重叠
+   */
+  session_calendar(const date& first, const date& last,
+                   const std::vector<TradingSession>& sessions, const business_calendar& calendar);
+
+  bool in_session(const ::datetime::datetime& dt) const;
+
+  /**
+   * @brief dt之后(不含dt)第一个时段的开始时间
+   * @exception std::out_of_range 之后没有时段
+   */
+  ::datetime::datetime next_open(const ::datetime::datetime& dt) const;
+
+  /**
+   * @brief dt之后(不含dt)第一个时段的结束时间，如果dt在时段内则为该时段的结束时间
+   * @exception std::out_of_range 之后没有时段
+   */
+  ::datetime::datetime next_close(const ::datetime::datetime& dt) const;
+
+  /**
+   * @brief [begin, end)内处于交易时段的时长，end < begin时返回负值
+   */
+  timedelta trading_time_between(const ::datetime::datetime& begin,
+                                 const ::datetime::datetime& end) const;
+
+  /**
+   * @brief 展开后的时段总数
+   */
+  std::size_t size() const { return opens_.size(); }
+
+ private:
+  session_calendar(const date& first, const date& last,
+                   const std::vector<TradingSession>& sessions,
+                   const business_calendar* calendar);
+
+  /* 最后一个open <= t的时段下标，没有则为-1 */
+  long find(long long t) const;
+  /* 时间t之前的累计交易时长 */
+  long long elapsed(long long t) const;
+
+  /* 时间均为datetime::utctimestamp() */
+  std::vector<long long> opens_;
+  std::vector<long long> closes_;
+  std::vector<long long> elapsed_;
+};
+
+}  // namespace datetime
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "datetime.h"
+#include "wire_format.h"
+
+namespace datetime {
+
+/**
+ * @brief 时间索引文件的写入端
+ * 数据文件中的记录按时间递增写入，每写入一条记录调用一次add，当该记录与上一个索引项的
+ * 偏移相差不小于block_size时为它生成一个索引项，第一条记录总是有索引项。
+ * 索引文件格式(小端)：
+ *   8字节  "DTINDEX1"
+ *   8字节  block_size
+ *   8字节  索引项个数
+ *   之后每个索引项16字节：int64 UTC微秒时间戳(与datetime的wire格式相同)、uint64 数据文件偏移
+ * 示例：
+ *    time_index_writer writer("ticks.idx");
+ *    for (auto& tick : ticks) {
+ *      writer.add(tick.time, data_file_offset);
+ *      data_file_offset += write(tick);
+ *    }
+ *    writer.close();
+ */
+class time_index_writer {
+ public:
+  static constexpr uint64_t kDefaultBlockSize = 64 * 1024;
+
+  /**
+   * @brief
+   * @param path 索引文件路径，已存在时会被覆盖
+   * @param block_size 两个索引项之间数据的最小字节数
+   * @exception std::runtime_error 无法创建文件
+   */
+  explicit time_index_writer(const std::string& path, uint64_t block_size = kDefaultBlockSize);
+  ~time_index_writer();
+
+  time_index_writer(const time_index_writer&) = delete;
+  time_index_writer& operator=(const time_index_writer&) = delete;
+
+  /**
+   * @brief 记录一条数据
+   * @param dt 记录的时间，不能早于上一条记录
+   * @param offset 记录在数据文件中的偏移，不能小于上一条记录
+   * @exception std::invalid_argument 时间或偏移递减
+   */
+  void add(const ::datetime::datetime& dt, uint64_t offset) {
+    add(dt.utctimestamp().count(), offset);
+  }
+  void add(long long timestamp, uint64_t offset);
+
+  /**
+   * @brief 写入头部并关闭文件，析构时如果还没有关闭会自动调用
+   * @exception std::runtime_error 写入失败
+   */
+  void close();
+
+  /**
+   * @brief 索引项个数
+   */
+  std::size_t size() const { return count_; }
+
+ private:
+  std::string path_;
+  FILE* file_;
+  uint64_t block_size_;
+  std::size_t count_ = 0;
+  std::size_t records_ = 0;
+  long long last_timestamp_ = 0;
+  uint64_t last_offset_ = 0;
+  uint64_t block_offset_ = 0;
+};
+
+/**
+ * @brief 通过mmap读取的时间索引
+ * seek只访问索引文件，在索引项上先插值再二分交替查找：时间分布均匀时插值很快收敛，
+ * 分布不均匀时二分保证最多O(log n)次比较。
+ * 示例：
+ *    time_index index("ticks.idx");
+ *    fseek(data, index.seek(datetime(2024, 1, 2, 9, 30)), SEEK_SET);
+ *    // 从这里顺序读取，跳过早于09:30的记录
+ */
+class time_index {
+ public:
+  /**
+   * @brief
+   * @param path time_index_writer写入的索引文件
+   * @exception std::runtime_error 无法打开或映射文件
+   * @exception std::invalid_argument 文件格式不正确
+   */
+  explicit time_index(const std::string& path);
+  ~time_index();
+
+  time_index(time_index&& other) noexcept;
+  time_index& operator=(time_index&& other) noexcept;
+  time_index(const time_index&) = delete;
+  time_index& operator=(const time_index&) = delete;
+
+  /**
+   * @brief 第一条时间不早于dt的记录所在块的数据文件偏移
+   * 返回的偏移之前的记录都早于dt，从这里顺序读取至多一个块即可找到该记录。
+   * 索引为空时返回0。
+   */
+  uint64_t seek(const ::datetime::datetime& dt) const { return seek(dt.utctimestamp().count()); }
+  uint64_t seek(long long timestamp) const;
+
+  /**
+   * @brief 第一个时间不早于timestamp的索引项的下标，都早于timestamp时返回size()
+   */
+  std::size_t lower_bound(long long timestamp) const;
+
+  std::size_t size() const { return count_; }
+  uint64_t block_size() const { return block_size_; }
+
+  long long timestamp(std::size_t i) const { return detail::load_le64(entries_ + i * kEntrySize); }
+  ::datetime::datetime time(std::size_t i) const {
+    return ::datetime::datetime::utcfromtimestamp(std::chrono::microseconds{timestamp(i)});
+  }
+  uint64_t offset(std::size_t i) const {
+    return static_cast<uint64_t>(detail::load_le64(entries_ + i * kEntrySize + 8));
+  }
+
+ private:
+  static constexpr std::size_t kEntrySize = 16;
+
+  void unmap();
+
+  void* map_ = nullptr;
+  std::size_t map_size_ = 0;
+  const uint8_t* entries_ = nullptr;
+  std::size_t count_ = 0;
+  uint64_t block_size_ = 0;
+};
+
+}  // namespace datetime
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "datetime.h"
+
+namespace datetime {
+
+/**
+ * @brief 分层时间轮
+ * 4层，每层256个槽，第0层每个槽为一个tick(即resolution)，第n层每个槽为256^n个tick，
+ * 超出最高层范围的定时器会在最高层轮转时重新放置。
+ * 定时器节点保存在连续的数组中，槽内为基于下标的双向链表，因此：
+ *   add      O(1)
+ *   cancel   O(1)
+ *   advance  O(到期的定时器数 + 跳过的非空槽数 + 经过的tick数 / 256)
+ *            第0层的空槽通过位图跳过，但只要还有未到期的定时器，每256个tick的第0层轮转
+ *            都要停下来从上层放置一次(在最高层范围内的定时器最多被放置kLevels - 1次)；
+ *            没有定时器时直接跳到now
+ *
+ * 定时器在deadline之后的第一个tick到期，不会提前到期；deadline已经过去的定时器
+ * 在下一个tick到期。
+ * 示例：
+ *    timer_wheel wheel(datetime::now());
+ *    auto id = wheel.add(timedelta(0, 5), 42);
+ *    std::vector<uint64_t> expired;
+ *    wheel.advance(&expired);  // 使用datetime::now()推进
+ */
+class timer_wheel {
+ public:
+  using timer_id = uint64_t;
+
+  /**
+   * @brief
+   * @param start 时间轮的起始时间
+   * @param resolution tick的长度
+   * @exception std::invalid_argument resolution <= 0
+   */
+  explicit timer_wheel(const ::datetime::datetime& start,
+                       const timedelta& resolution = timedelta(0, 0, 1000));
+
+  /**
+   * @brief 添加一个在deadline到期的定时器
+   * @param deadline
+   * @param data 到期时通过advance返回的用户数据
+   * @return timer_id 用于cancel
+   */
+  timer_id add(const ::datetime::datetime& deadline, uint64_t data);
+
+  /**
+   * @brief 添加一个在current_time() + timeout到期的定时器
+   */
+  timer_id add(const timedelta& timeout, uint64_t data);
+
+  /**
+   * @brief 取消定时器
+   * @return false 定时器不存在，已经到期或已经取消
+   */
+  bool cancel(timer_id id);
+
+  /**
+   * @brief 推进到now，到期的定时器的data按到期的tick顺序追加到expired
+   * @return std::size_t 到期的定时器数
+   */
+  std::size_t advance(const ::datetime::datetime& now, std::vector<uint64_t>* expired);
+  std::size_t advance(std::vector<uint64_t>* expired) {
+    return advance(::datetime::datetime::now(), expired);
+  }
+
+  /**
+   * @brief 当前tick对应的时间
+   */
+  ::datetime::datetime current_time() const;
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  static constexpr int kLevels = 4;
+  static constexpr int kSlotBits = 8;
+  static constexpr int kSlots = 1 << kSlotBits;
+  static constexpr uint32_t kNil = UINT32_MAX;
+
+  struct Node {
+    uint64_t expire;
+    uint64_t data;
+    uint32_t prev;
+    uint32_t next;
+    uint32_t slot; /* level * kSlots + slot，空闲时为kNil */
+    uint32_t generation;
+  };
+
+  timer_id add_tick(uint64_t expire, uint64_t data);
+  void place(uint32_t index);
+  void link(uint32_t index, uint32_t slot);
+  void unlink(uint32_t index);
+  uint32_t take(uint32_t slot);
+  void release(uint32_t index);
+  void cascade(int level);
+  void tick(std::vector<uint64_t>* expired);
+  /* 当前tick之后第0层下一个非空槽的tick，没有则为下一次第0层轮转的tick */
+  uint64_t next_occupied() const;
+
+  long long start_;
+  long long resolution_;
+  uint64_t now_ = 0;
+  std::size_t size_ = 0;
+
+  std::vector<Node> nodes_;
+  uint32_t free_ = kNil;
+  uint32_t heads_[kLevels * kSlots];
+  uint64_t occupied_[kLevels * kSlots / 64] = {};
+};
+
+}  // namespace datetime
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+
+#include "datetime.h"
+
+namespace datetime {
+
+/**
+ * @brief 定长的二进制编码，用于跨进程传递(共享内存队列、文件等)
+ * 所有整数均为小端，与平台和类的内部布局无关，编码保持稳定：
+ *
+ *   类型        字节  内容
+ *   date         4    int32 序数，0001-01-01为1，见date::toordinal
+ *   time         8    int64 自0点起的微秒数，[0, 86400000000)
+ *   datetime     8    int64 UTC微秒时间戳，自1970-01-01T00:00:00起，见datetime::utctimestamp
+ *   timedelta   12    int32 days, int32 seconds [0, 86399], int32 microseconds [0, 999999]
+ *
+ * 对同一类型的值，datetime和date的编码作为有符号整数比较的顺序与值的顺序一致。
+ * 示例：
+ *    uint8_t buf[kWireSize<datetime>];
+ *    to_bytes(dt, buf);
+ *    auto dt2 = from_bytes<datetime>(buf);
+ */
+template <class T>
+constexpr std::size_t kWireSize = 0;
+template <>
+inline constexpr std::size_t kWireSize<::datetime::date> = 4;
+template <>
+inline constexpr std::size_t kWireSize<::datetime::time> = 8;
+template <>
+inline constexpr std::size_t kWireSize<::datetime::datetime> = 8;
+template <>
+inline constexpr std::size_t kWireSize<timedelta> = 12;
+
+/**
+ * @brief 把值编码到out，写入kWireSize<T>个字节
+ */
+void to_bytes(const ::datetime::date& d, uint8_t* out);
+void to_bytes(const ::datetime::time& t, uint8_t* out);
+void to_bytes(const ::datetime::datetime& dt, uint8_t* out);
+void to_bytes(const timedelta& delta, uint8_t* out);
+
+/**
+ * @brief 从in读取kWireSize<T>个字节并解码
+ * @exception std::out_of_range 编码的值超出T的范围
+ */
+template <class T>
+T from_bytes(const uint8_t* in);
+template <>
+::datetime::date from_bytes<::datetime::date>(const uint8_t* in);
+template <>
+::datetime::time from_bytes<::datetime::time>(const uint8_t* in);
+template <>
+::datetime::datetime from_bytes<::datetime::datetime>(const uint8_t* in);
+template <>
+timedelta from_bytes<timedelta>(const uint8_t* in);
+
+/**
+ * @brief 同from_bytes(in)，但先检查in中是否有kWireSize<T>个字节，用于读取长度不可信的输入
+ * @param size in中可读的字节数
+ * @exception std::invalid_argument size < kWireSize<T>
+ * @exception std::out_of_range 编码的值超出T的范围
+ */
+template <class T>
+T from_bytes(const uint8_t* in, std::size_t size);
+
+namespace detail {
+inline int64_t load_le64(const uint8_t* p) {
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; --i) {
+    v = (v << 8) | p[i];
+  }
+  return static_cast<int64_t>(v);
+}
+}  // namespace detail
+
+/**
+ * @brief 直接读取缓冲区中datetime编码的只读视图，不拷贝、不解码
+ * 比较只读取8字节的时间戳，只有value()等需要年月日的操作才解码。
+ * 视图不持有数据，data在视图使用期间必须有效。
+ * 示例：
+ *    datetime_view view(shm + offset);
+ *    if (view < deadline) {
+ *      ...
+ *    }
+ */
+class datetime_view {
+ public:
+  explicit datetime_view(const uint8_t* data) : data_(data) {}
+
+  /**
+   * @brief UTC微秒时间戳
+   */
+  long long timestamp() const { return detail::load_le64(data_); }
+
+  /**
+   * @brief 解码为datetime
+   * @exception std::out_of_range 编码的值超出datetime的范围
+   */
+  ::datetime::datetime value() const { return from_bytes<::datetime::datetime>(data_); }
+
+  const uint8_t* data() const { return data_; }
+
+  bool operator==(const datetime_view& rhs) const { return timestamp() == rhs.timestamp(); }
+  std::strong_ordering operator<=>(const datetime_view& rhs) const {
+    return timestamp() <=> rhs.timestamp();
+  }
+
+  bool operator==(const ::datetime::datetime& rhs) const {
+    return timestamp() == rhs.utctimestamp().count();
+  }
+  std::strong_ordering operator<=>(const ::datetime::datetime& rhs) const {
+    return timestamp() <=> rhs.utctimestamp().count();
+  }
+
+ private:
+  const uint8_t* data_;
+};
+
+}  // namespace datetime
@@ -0,0 +1,145 @@
+#include "business_calendar.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <fstream>
+#include <stdexcept>
+
+#include "fmt/format.h"
+
+namespace datetime {
+
+business_calendar::business_calendar(const std::vector<date>& holidays, int weekmask)
+    : weekmask_(weekmask), total_(0), bits_(kNumWords), rank_(kNumWords + 1) {
+  if (weekmask < 0 || weekmask > 0x7f) {
+    throw std::invalid_argument(
+        fmt::format("business_calendar: Invalid weekmask: {:#x}", weekmask));
+  }
+
+  /* 星期的规律以7为周期，word w的第0位对应ordinal 64w，其weekday为(64w + 6) % 7，
+   * 因此只有7种不同的word
+   */
+  uint64_t patterns[7];
+  for (int phase = 0; phase < 7; ++phase) {
+    uint64_t word = 0;
+    for (int i = 0; i < 64; ++i) {
+      if ((weekmask >> ((phase + i) % 7)) & 1) {
+        word |= uint64_t{1} << i;
+      }
+    }
+    patterns[phase] = word;
+  }
+  for (int w = 0; w < kNumWords; ++w) {
+    bits_[w] = patterns[(64 * w + 6) % 7];
+  }
+
+  /* ordinal 0以及kMaxOrdinal之后的位不属于任何日期 */
+  bits_[0] &= ~uint64_t{1};
+  constexpr int kLastBit = kMaxOrdinal & 63;
+  bits_[kNumWords - 1] &= ~uint64_t{0} >> (63 - kLastBit);
+
+  add_holidays(holidays);
+}
+
+business_calendar business_calendar::fromfile(const std::string& path, int weekmask) {
+  std::ifstream ifs(path);
+  if (!ifs) {
+    throw std::runtime_error(fmt::format("business_calendar::fromfile: Failed to open {}", path));
+  }
+
+  std::vector<date> holidays;
+  std::string line;
+  int lineno = 0;
+  while (std::getline(ifs, line)) {
+    ++lineno;
+    auto comment = line.find('#');
+    if (comment != std::string::npos) {
+      line.erase(comment);
+    }
+    auto begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+      continue;
+    }
+    auto end = line.find_last_not_of(" \t\r");
+    line = line.substr(begin, end - begin + 1);
+
+    try {
+      holidays.push_back(date::fromisoformat(line));
+    } catch (const std::exception& e) {
+      throw std::invalid_argument(
+          fmt::format("business_calendar::fromfile: {}:{}: {}", path, lineno, e.what()));
+    }
+  }
+
+  return business_calendar(holidays, weekmask);
+}
+
+void business_calendar::add_holiday(const date& d) {
+  int ordinal = d.toordinal();
+  if (!test(ordinal)) {
+    return;
+  }
+
+  bits_[ordinal >> 6] &= ~(uint64_t{1} << (ordinal & 63));
+  for (int w = (ordinal >> 6) + 1; w <= kNumWords; ++w) {
+    --rank_[w];
+  }
+  --total_;
+}
+
+void business_calendar::add_holidays(const std::vector<date>& holidays) {
+  for (const auto& d : holidays) {
+    int ordinal = d.toordinal();
+    bits_[ordinal >> 6] &= ~(uint64_t{1} << (ordinal & 63));
+  }
+  build_rank();
+}
+
+void business_calendar::build_rank() {
+  for (int w = 0; w < kNumWords; ++w) {
+    rank_[w + 1] = rank_[w] + std::popcount(bits_[w]);
+  }
+  total_ = rank_[kNumWords];
+}
+
+int business_calendar::rank(int ordinal) const {
+  int w = ordinal >> 6;
+  uint64_t below = (uint64_t{1} << (ordinal & 63)) - 1;
+  return rank_[w] + std::popcount(bits_[w] & below);
+}
+
+int business_calendar::select(int k) const {
+  assert(0 <= k && k < total_);
+  /* rank_[w] <= k < rank_[w + 1] */
+  int w = static_cast<int>(std::upper_bound(rank_.begin(), rank_.end(), k) - rank_.begin()) - 1;
+  uint64_t word = bits_[w];
+  for (int r = k - rank_[w]; r > 0; --r) {
+    word &= word - 1;
+  }
+  return w * 64 + std::countr_zero(word);
+}
+
+int business_calendar::business_days_between(const date& begin, const date& end) const {
+  return rank(end.toordinal()) - rank(begin.toordinal());
+}
+
+date business_calendar::add_business_days(const date& d, int n) const {
+  int ordinal = d.toordinal();
+  long k;
+  if (n > 0) {
+    k = static_cast<long>(rank(ordinal + 1)) + n - 1;
+  } else if (n < 0) {
+    k = static_cast<long>(rank(ordinal)) + n;
+  } else {
+    k = rank(ordinal);
+  }
+
+  if (k < 0 || k >= total_) {
+    throw std::out_of_range(fmt::format(
+        "business_calendar::add_business_days: Out of range: date:{} n:{}", d.isoformat(), n));
+  }
+  return date::fromordinal(select(static_cast<int>(k)));
+}
+
+}  // namespace datetime
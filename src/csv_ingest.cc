@@ -0,0 +1,220 @@
+#include "csv_ingest.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+#include "fmt/format.h"
+
+namespace datetime {
+
+/* 每个线程至少处理的字节数，避免小文件也启动很多线程 */
+static constexpr std::size_t kMinChunkSize = 64 * 1024;
+
+/* 空文件时begin和end都为nullptr，不能传给memchr */
+static const char* find(const char* begin, const char* end, char c) {
+  if (begin == end) {
+    return end;
+  }
+  auto p = static_cast<const char*>(std::memchr(begin, c, end - begin));
+  return p == nullptr ? end : p;
+}
+
+/* 返回从p开始的字段的结尾，即分隔符或行尾 */
+static const char* field_end(const char* p, const char* end, char delimiter) {
+  if (p < end && *p == '"') {
+    const char* q = p + 1;
+    while (true) {
+      q = find(q, end, '"');
+      if (q == end) {
+        return end;
+      }
+      if (q + 1 < end && q[1] == '"') {
+        q += 2;
+        continue;
+      }
+      return find(q + 1, end, delimiter);
+    }
+  }
+  return find(p, end, delimiter);
+}
+
+csv_ingest::csv_ingest(std::vector<CsvTimestampColumn> columns, char delimiter, bool has_header,
+                       unsigned num_threads)
+    : columns_(std::move(columns)),
+      order_(columns_.size()),
+      delimiter_(delimiter),
+      has_header_(has_header),
+      num_threads_(num_threads != 0 ? num_threads : std::thread::hardware_concurrency()) {
+  if (num_threads_ == 0) {
+    num_threads_ = 1;
+  }
+  std::iota(order_.begin(), order_.end(), 0);
+  std::stable_sort(order_.begin(), order_.end(), [this](std::size_t a, std::size_t b) {
+    return columns_[a].column < columns_[b].column;
+  });
+}
+
+CsvIngestResult csv_ingest::read(const std::string& path) const {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error(
+        fmt::format("csv_ingest: Failed to open {}: {}", path, std::strerror(errno)));
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    int err = errno;
+    ::close(fd);
+    throw std::runtime_error(
+        fmt::format("csv_ingest: Failed to stat {}: {}", path, std::strerror(err)));
+  }
+  std::size_t size = static_cast<std::size_t>(st.st_size);
+  if (size == 0) {
+    ::close(fd);
+    return parse(std::string_view());
+  }
+
+  void* map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  int err = errno;
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    throw std::runtime_error(
+        fmt::format("csv_ingest: Failed to mmap {}: {}", path, std::strerror(err)));
+  }
+  ::madvise(map, size, MADV_SEQUENTIAL);
+
+  try {
+    auto result = parse(std::string_view(static_cast<const char*>(map), size));
+    ::munmap(map, size);
+    return result;
+  } catch (...) {
+    ::munmap(map, size);
+    throw;
+  }
+}
+
+CsvIngestResult csv_ingest::parse(std::string_view data) const {
+  const char* begin = data.data();
+  const char* end = begin + data.size();
+  if (has_header_) {
+    begin = find(begin, end, '\n');
+    begin = begin == end ? end : begin + 1;
+  }
+
+  /* 按换行符切分，每块都以完整的行结束 */
+  std::size_t size = end - begin;
+  std::size_t num_chunks =
+      std::max<std::size_t>(1, std::min<std::size_t>(num_threads_, size / kMinChunkSize));
+  std::vector<Chunk> chunks(num_chunks);
+  const char* p = begin;
+  for (std::size_t i = 0; i < num_chunks; ++i) {
+    chunks[i].begin = p;
+    if (i + 1 == num_chunks) {
+      p = end;
+    } else {
+      p = std::max(p, begin + size * (i + 1) / num_chunks);
+      p = find(p, end, '\n');
+      p = p == end ? end : p + 1;
+    }
+    chunks[i].end = p;
+  }
+
+  auto run = [&chunks](auto&& f) {
+    if (chunks.size() == 1) {
+      f(&chunks[0]);
+      return;
+    }
+    std::vector<std::thread> threads;
+    for (auto& chunk : chunks) {
+      threads.emplace_back([&f, &chunk] { f(&chunk); });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  };
+
+  std::vector<std::size_t> rows(num_chunks);
+  run([this, &chunks, &rows](Chunk* chunk) {
+    rows[chunk - chunks.data()] = count_rows(chunk->begin, chunk->end);
+  });
+
+  CsvIngestResult result;
+  for (std::size_t i = 0; i < num_chunks; ++i) {
+    chunks[i].first_row = result.rows;
+    result.rows += rows[i];
+  }
+  result.timestamps.assign(columns_.size(), std::vector<long long>(result.rows));
+
+  run([this, &result](Chunk* chunk) { parse_chunk(chunk, &result); });
+
+  for (auto& chunk : chunks) {
+    result.errors.insert(result.errors.end(), chunk.errors.begin(), chunk.errors.end());
+  }
+  return result;
+}
+
+std::size_t csv_ingest::count_rows(const char* begin, const char* end) const {
+  std::size_t rows = std::count(begin, end, '\n');
+  if (begin != end && end[-1] != '\n') {
+    ++rows;
+  }
+  return rows;
+}
+
+void csv_ingest::parse_chunk(Chunk* chunk, CsvIngestResult* result) const {
+  std::size_t row = chunk->first_row;
+  const char* p = chunk->begin;
+  while (p < chunk->end) {
+    const char* eol = find(p, chunk->end, '\n');
+    parse_line(p, eol, row++, chunk, result);
+    p = eol == chunk->end ? eol : eol + 1;
+  }
+}
+
+void csv_ingest::parse_line(const char* begin, const char* end, std::size_t row, Chunk* chunk,
+                            CsvIngestResult* result) const {
+  if (begin != end && end[-1] == '\r') {
+    --end;
+  }
+
+  const char* p = begin;
+  std::size_t column = 0;
+  /* p为第column列的开头，has_field为false表示这一行已经没有更多的列 */
+  bool has_field = true;
+  for (std::size_t index : order_) {
+    const auto& target = columns_[index];
+    while (column < target.column && has_field) {
+      const char* fe = field_end(p, end, delimiter_);
+      has_field = fe != end;
+      p = has_field ? fe + 1 : end;
+      ++column;
+    }
+
+    long long ts;
+    bool ok = false;
+    if (has_field) {
+      const char* fe = field_end(p, end, delimiter_);
+      std::string_view field(p, fe - p);
+      if (field.size() >= 2 && field.front() == '"' && field.back() == '"') {
+        field = field.substr(1, field.size() - 2);
+      }
+      ok = strptime_timestamp(field, target.format, &ts);
+    }
+    if (ok) {
+      result->timestamps[index][row] = ts;
+    } else {
+      result->timestamps[index][row] = CsvIngestResult::kInvalidTimestamp;
+      chunk->errors.push_back(CsvParseError{row, target.column});
+    }
+  }
+}
+
+}  // namespace datetime
@@ -1,13 +1,16 @@
-#include "xyu/datetime.h"
+#include "datetime.h"
 
+#include <array>
+#include <bit>
 #include <chrono>
 #include <cmath>
 #include <cstdint>
-#include <iomanip>
-#include <sstream>
+#include <cstring>
 #include <stdexcept>
+#include <type_traits>
 
 #include "fmt/format.h"
+#include "parse_digits.h"
 
 namespace datetime {
 
@@ -34,11 +37,12 @@ static constexpr long kSecondsPerDay = 3600L * 24L;
 static constexpr long long kMaxFoldSeconds = 24 * 3600;
 /* NB: date(1970,1,1).toordinal() == 719163 */
 static constexpr long long kEpoch = 719163LL * 24 * 60 * 60;
+static constexpr long kEpochOrdinal = 719163L;
 
 static const char* kDayNames[] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
 
-static const char* kDayFullNames[] = {"Monday", "Tuesday", "Wensday", "Thurday",
-                                      "Friday", "Satday",  "Sunday"};
+static const char* kDayFullNames[] = {"Monday", "Tuesday",  "Wednesday", "Thursday",
+                                      "Friday", "Saturday", "Sunday"};
 
 static const char* kMonthNames[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
                                     "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
@@ -122,7 +126,7 @@ static const int kDaysBeforeMonth[] = {0, /* unused; this vector uses 1-based in
                                        0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
 
 /* year -> 1 if leap year, else 0. */
-static inline int is_leap(int year) {
+int is_leap(int year) {
   /* Cast year to unsigned.  The result is the same either way, but
    * C can generate faster code for unsigned mod than for signed
    * mod (especially for % 4 -- a good compiler should just grab
@@ -133,7 +137,7 @@ static inline int is_leap(int year) {
 }
 
 /* year, month -> number of days in that month in that year */
-static inline int days_in_month(int year, int month) {
+int days_in_month(int year, int month) {
   assert(month >= 1);
   assert(month <= 12);
   if (month == 2 && is_leap(year)) {
@@ -264,23 +268,132 @@ static inline int ymd_to_ord(int year, int month, int day) {
 }
 
 /* Day of week, where Monday==0, ..., Sunday==6.  1/1/1 was a Monday. */
-static inline int weekday(int year, int month, int day) {
+int weekday(int year, int month, int day) {
   return (ymd_to_ord(year, month, day) + 6) % 7;
 }
 
+/* 每年预先计算的信息，年份为[kMinYear, kMaxYear + 1]，共约40KB。
+ * isocalendar需要下一年的week1_monday，所以多一年。
+ */
+struct YearInfo {
+  /* ISO第1周周一的序数 */
+  uint32_t week1_monday : 22;
+  /* 1月1日是星期几，Monday==0 */
+  uint32_t first_weekday : 3;
+  uint32_t leap : 1;
+};
+static_assert(sizeof(YearInfo) == 4);
+
+static constexpr std::array<YearInfo, kMaxYear + 2> make_year_table() {
+  std::array<YearInfo, kMaxYear + 2> table{};
+  for (int year = kMinYear; year <= kMaxYear + 1; ++year) {
+    int y = year - 1;
+    int first_day = y * 365 + y / 4 - y / 100 + y / 400 + 1; /* ord of 1/1 */
+    /* 0 if 1/1 is a Monday, 1 if a Tue, etc. */
+    int first_weekday = (first_day + 6) % 7;
+    /* ordinal of closest Monday at or before 1/1, next Monday if 1/1 was Fri, Sat, Sun */
+    int week1_monday = first_day - first_weekday + (first_weekday > 3 ? 7 : 0);
+    bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+    table[year] = YearInfo{static_cast<uint32_t>(week1_monday),
+                           static_cast<uint32_t>(first_weekday), leap};
+  }
+  return table;
+}
+
+static constexpr std::array<YearInfo, kMaxYear + 2> kYearTable = make_year_table();
+
+static inline const YearInfo& year_info(int year) {
+  assert(year >= kMinYear && year <= kMaxYear + 1);
+  return kYearTable[year];
+}
+
 /* Ordinal of the Monday starting week 1 of the ISO year.  Week 1 is the
  * first calendar week containing a Thursday.
  */
-static int iso_week1_monday(int year) {
-  int first_day = ymd_to_ord(year, 1, 1); /* ord of 1/1 */
-  /* 0 if 1/1 is a Monday, 1 if a Tue, etc. */
-  int first_weekday = (first_day + 6) % 7;
-  /* ordinal of closest Monday at or before 1/1 */
-  int week1_monday = first_day - first_weekday;
+static inline int iso_week1_monday(int year) { return year_info(year).week1_monday; }
+
+/* 序数 -> ISO日历。先按平均每年的天数估计年份，再用相邻两年的week1_monday修正 */
+static inline IsoCalendarDate ord_to_isocalendar(int ordinal) {
+  int year = static_cast<int>((ordinal - 1) * 400LL / DI400Y) + 1;
+  if (year > kMaxYear) {
+    year = kMaxYear;
+  }
+  while (ordinal < iso_week1_monday(year)) {
+    --year;
+  }
+  while (ordinal >= iso_week1_monday(year + 1)) {
+    ++year;
+  }
+  int days = ordinal - iso_week1_monday(year);
+  return IsoCalendarDate{year, days / 7 + 1, days % 7 + 1};
+}
+
+/* year, month, day -> 1-based day of the year, as %j */
+static inline int day_of_year(int year, int month, int day) {
+  return kDaysBeforeMonth[month] + (month > 2 && year_info(year).leap) + day;
+}
+
+void isocalendar(const int* ordinals, std::size_t n, IsoCalendarDate* out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    if (ordinals[i] < 1 || ordinals[i] > kMaxOrdinal) {
+      throw std::out_of_range(fmt::format("isocalendar: Ordinal out of range: {}", ordinals[i]));
+    }
+    out[i] = ord_to_isocalendar(ordinals[i]);
+  }
+}
+
+/* 检查base开始的count行，ok[k]为第k行除闰年外是否合法，feb29[k]为是否为2月29日。
+ * 除2月外每月的天数为30 + ((month ^ (month >> 3)) & 1)，不需要查表，count为8时可以向量化
+ */
+static inline void check_rows(const int* year, const int* month, const int* day, const int* hour,
+                              const int* minute, const int* second, const int* microsecond,
+                              std::size_t count, uint8_t* ok, uint8_t* feb29) {
+  for (std::size_t k = 0; k < count; ++k) {
+    int m = month[k];
+    int d = day[k];
+    unsigned dim = m == 2 ? 29 : 30 + ((m ^ (m >> 3)) & 1);
+    /* 先转换为unsigned再相减，INT_MIN这样的输入不会有符号溢出 */
+    bool date_ok = (static_cast<unsigned>(year[k]) - unsigned{kMinYear} <= kMaxYear - kMinYear) &
+                   (static_cast<unsigned>(m) - 1u < 12) & (static_cast<unsigned>(d) - 1u < dim);
+    bool time_ok = (static_cast<unsigned>(hour[k]) < 24) & (static_cast<unsigned>(minute[k]) < 60) &
+                   (static_cast<unsigned>(second[k]) < 60) &
+                   (static_cast<unsigned>(microsecond[k]) < 1000000);
+    ok[k] = date_ok & time_ok;
+    feb29[k] = (m == 2) & (d == 29);
+  }
+}
+
+std::size_t validate_and_build(const int* year, const int* month, const int* day, const int* hour,
+                               const int* minute, const int* second, const int* microsecond,
+                               std::size_t n, ::datetime::datetime* out, uint8_t* valid_mask) {
+  std::size_t num_valid = 0;
+  for (std::size_t base = 0; base < n; base += 8) {
+    std::size_t count = n - base < 8 ? n - base : 8;
+    uint8_t ok[8];
+    uint8_t feb29[8];
+    if (count == 8) {
+      check_rows(year + base, month + base, day + base, hour + base, minute + base, second + base,
+                 microsecond + base, 8, ok, feb29);
+    } else {
+      check_rows(year + base, month + base, day + base, hour + base, minute + base, second + base,
+                 microsecond + base, count, ok, feb29);
+    }
 
-  if (first_weekday > 3) /* if 1/1 was Fri, Sat, Sun */
-    week1_monday += 7;
-  return week1_monday;
+    unsigned mask = 0;
+    for (std::size_t k = 0; k < count; ++k) {
+      std::size_t i = base + k;
+      if (feb29[k] & ok[k]) {
+        ok[k] = year_info(year[i]).leap;
+      }
+      mask |= static_cast<unsigned>(ok[k]) << k;
+      out[i] = ok[k] ? ::datetime::datetime(year[i], month[i], day[i], hour[i], minute[i],
+                                            second[i], microsecond[i], detail::NonCheckTag{})
+                     : ::datetime::datetime::min();
+    }
+    valid_mask[base / 8] = static_cast<uint8_t>(mask);
+    num_valid += std::popcount(mask);
+  }
+  return num_valid;
 }
 
 /* ---------------------------------------------------------------------------
@@ -455,18 +568,7 @@ static int normalize_datetime(int* year, int* month, int* day, int* hour, int* m
  * String parsing utilities and helper functions
  */
 
-static const char* parse_digits(const char* ptr, int* var, std::size_t num_digits) {
-  for (std::size_t i = 0; i < num_digits; ++i) {
-    unsigned int tmp = (unsigned int)(*(ptr++) - '0');
-    if (tmp > 9) {
-      return nullptr;
-    }
-    *var *= 10;
-    *var += (signed int)tmp;
-  }
-
-  return ptr;
-}
+using detail::parse_digits;
 
 [[gnu::unused]] static int parse_isoformat_date(const char* dtstr, int* year, int* month,
                                                 int* day) {
@@ -478,29 +580,13 @@ static const char* parse_digits(const char* ptr, int* var, std::size_t num_digit
    *      -2:  Failed to parse dateseparator
    */
   const char* p = dtstr;
-  p = parse_digits(p, year, 4);
-  if (nullptr == p) {
+  if (!parse_digits<4>(p, year) || !parse_digits<2>(p + 5, month) ||
+      !parse_digits<2>(p + 8, day)) {
     return -1;
   }
-
-  if (*(p++) != '-') {
+  if (p[4] != '-' || p[7] != '-') {
     return -2;
   }
-
-  p = parse_digits(p, month, 2);
-  if (nullptr == p) {
-    return -1;
-  }
-
-  if (*(p++) != '-') {
-    return -2;
-  }
-
-  p = parse_digits(p, day, 2);
-  if (p == nullptr) {
-    return -1;
-  }
-
   return 0;
 }
 
@@ -512,15 +598,16 @@ static int parse_hh_mm_ss_ff(const char* tstr, const char* tstr_end, int* hour,
 
   // Parse [HH[:MM[:SS]]]
   for (std::size_t i = 0; i < 3; ++i) {
-    p = parse_digits(p, vals[i], 2);
-    if (nullptr == p) {
+    if (p_end - p < 2 || !parse_digits<2>(p, vals[i])) {
       return -3;
     }
+    p += 2;
 
+    if (p == p_end) {
+      return 0;
+    }
     char c = *(p++);
-    if (p >= p_end) {
-      return c != '\0';
-    } else if (c == ':') {
+    if (c == ':') {
       continue;
     } else if (c == '.') {
       break;
@@ -531,21 +618,14 @@ static int parse_hh_mm_ss_ff(const char* tstr, const char* tstr_end, int* hour,
 
   // Parse .fff[fff]
   std::size_t len_remains = p_end - p;
-  if (!(len_remains == 6 || len_remains == 3)) {
-    return -3;
+  if (len_remains == 6) {
+    return parse_digits<6>(p, microsecond) ? 0 : -3;
   }
-
-  p = parse_digits(p, microsecond, len_remains);
-  if (nullptr == p) {
-    return -3;
-  }
-
-  if (len_remains == 3) {
+  if (len_remains == 3 && parse_digits<3>(p, microsecond)) {
     *microsecond *= 1000;
+    return 0;
   }
-
-  // Return 1 if it's not the end of the string
-  return *p != '\0';
+  return -3;
 }
 
 [[gnu::unused]] static int parse_isoformat_time(const char* dtstr, std::size_t dtlen, int* hour,
@@ -605,8 +685,51 @@ static int parse_hh_mm_ss_ff(const char* tstr, const char* tstr_end, int* hour,
   return rv ? -5 : 1;
 }
 
+/* 00-99的两位数字，kDigitPairs[2 * n]和kDigitPairs[2 * n + 1]为n的十位和个位 */
+static constexpr std::array<char, 200> kDigitPairs = [] {
+  std::array<char, 200> table{};
+  for (int i = 0; i < 100; ++i) {
+    table[2 * i] = static_cast<char>('0' + i / 10);
+    table[2 * i + 1] = static_cast<char>('0' + i % 10);
+  }
+  return table;
+}();
+
+static inline char* write_2digits(char* p, int n) {
+  std::memcpy(p, &kDigitPairs[2 * n], 2);
+  return p + 2;
+}
+
+/* 以下函数写入定长的字段，返回写入后的位置 */
+
+/* YYYY-MM-DD */
+static inline char* write_date(char* p, int year, int month, int day) {
+  p = write_2digits(p, year / 100);
+  p = write_2digits(p, year % 100);
+  *p++ = '-';
+  p = write_2digits(p, month);
+  *p++ = '-';
+  return write_2digits(p, day);
+}
+
+/* HH:MM:SS，microsecond不为0时为HH:MM:SS.ffffff。
+ * 总是写入15字节，只根据microsecond决定返回的位置，避免微秒数时有时无造成的分支预测失败
+ */
+static inline char* write_time(char* p, int hour, int minute, int second, int microsecond) {
+  p = write_2digits(p, hour);
+  *p++ = ':';
+  p = write_2digits(p, minute);
+  *p++ = ':';
+  p = write_2digits(p, second);
+  p[0] = '.';
+  write_2digits(p + 1, microsecond / 10000);
+  write_2digits(p + 3, microsecond / 100 % 100);
+  write_2digits(p + 5, microsecond % 100);
+  return p + (microsecond != 0 ? 7 : 0);
+}
+
 std::string format_ctime(int year, int month, int day, int hour, int minute, int second) {
-  int wday = datetime::weekday(year, month, day);
+  int wday = ::datetime::weekday(year, month, day);
 
   return fmt::format("{} {} {:2d} {:02d}:{:02d}:{:02d} {:04d}", kDayNames[wday],
                      kMonthNames[month - 1], day, hour, minute, second, year);
@@ -678,12 +801,6 @@ timedelta::timedelta(int days, int seconds, int microseconds, detail::NonNormTag
   check_delta_day_range(days);
 }
 
-timedelta::timedelta(int days, int seconds, int microseconds, detail::NonNormNonCheckTag)
-    : days_(days), seconds_(seconds), microseconds_(microseconds) {}
-
-timedelta::timedelta(const timedelta& other)
-    : days_(other.days_), seconds_(other.seconds_), microseconds_(other.microseconds_) {}
-
 timedelta::timedelta(int days, int seconds, int microseconds) {
   normalize_d_s_us(&days, &seconds, &microseconds);
 
@@ -730,9 +847,6 @@ timedelta::timedelta(std::chrono::seconds seconds)
 timedelta::timedelta(std::chrono::milliseconds milliseconds)
     : timedelta(std::chrono::duration_cast<std::chrono::microseconds>(milliseconds)) {}
 
-timedelta::timedelta(std::chrono::microseconds microseconds) {
-  frommicroseconds(microseconds.count());
-}
 
 long timedelta::delta_to_microseconds() const {
   return (kSecondsPerDay * days() + seconds()) * kUsPerSecond + microseconds();
@@ -899,8 +1013,6 @@ date::date(int year, int month, int day) {
   set_fileds(year, month, day);
 }
 
-date::date(int year, int month, int day, detail::NonCheckTag) { set_fileds(year, month, day); }
-
 date date::today() {
   return fromtimestamp(std::chrono::duration_cast<std::chrono::seconds>(
       std::chrono::system_clock::now().time_since_epoch()));
@@ -938,12 +1050,15 @@ date date::fromordinal(int ordinal) {
   if (ordinal < 1) {
     throw std::invalid_argument(fmt::format("date::fromordinal: Invalid ordinal: {}", ordinal));
   }
+  if (ordinal > kMaxOrdinal) {
+    throw std::out_of_range(fmt::format("date::fromordinal: Ordinal out of range: {}", ordinal));
+  }
 
   int y;
   int m;
   int d;
   ord_to_ymd(ordinal, &y, &m, &d);
-  return date(y, m, d);
+  return date(y, m, d, detail::NonCheckTag{});
 }
 
 date date::fromisocalendar(const IsoCalendarDate& iso_calendar) {
@@ -958,8 +1073,8 @@ date date::fromisocalendar(const IsoCalendarDate& iso_calendar) {
     if (week == 53) {
       // ISO years have 53 weeks in it on years starting with a Thursday
       // and on leap years starting on Wednesday
-      int first_weekday = ::datetime::weekday(y, 1, 1);
-      if (first_weekday == 3 || (first_weekday == 2 && is_leap(y))) {
+      const YearInfo& info = year_info(y);
+      if (info.first_weekday == 3 || (info.first_weekday == 2 && info.leap)) {
         out_of_range = 0;
       }
     }
@@ -980,10 +1095,15 @@ date date::fromisocalendar(const IsoCalendarDate& iso_calendar) {
 
   int mon = week;
   int day_offset = (mon - 1) * 7 + d - 1;
+  /* 第1年的第1周从0001-01-01开始，只有9999年第52周的最后两天会超出范围 */
+  if (day_1 + day_offset > kMaxOrdinal) {
+    throw std::out_of_range(fmt::format("date::fromisocalendar: Date out of range: {}-W{}-{}", y,
+                                        week, d));
+  }
 
   ord_to_ymd(day_1 + day_offset, &y, &mon, &d);
 
-  return date(y, mon, d);
+  return date(y, mon, d, detail::NonCheckTag{});
 }
 
 int date::weekday() const { return ::datetime::weekday(year(), month(), day()); }
@@ -992,22 +1112,14 @@ int date::toordinal() const { return ymd_to_ord(year(), month(), day()); }
 
 IsoCalendarDate date::isocalendar() const {
   int y = year();
-  int week1_monday = iso_week1_monday(y);
   int today = ymd_to_ord(y, month(), day());
-  int week;
-  int d;
-
-  week = divmod(today - week1_monday, 7, &d);
-  if (week < 0) {
+  if (today < iso_week1_monday(y)) {
     --y;
-    week1_monday = iso_week1_monday(y);
-    week = divmod(today - week1_monday, 7, &d);
-  } else if (week >= 52 && today >= iso_week1_monday(y + 1)) {
+  } else if (today >= iso_week1_monday(y + 1)) {
     ++y;
-    week = 0;
   }
-
-  return IsoCalendarDate{y, week + 1, d + 1};
+  int days = today - iso_week1_monday(y);
+  return IsoCalendarDate{y, days / 7 + 1, days % 7 + 1};
 }
 
 date date::operator+(const timedelta& delta) const {
@@ -1046,50 +1158,47 @@ timedelta date::operator-(const date& rhs) const {
   return timedelta(lhs_ord - rhs_old, 0, 0, detail::NonNormTag{});
 }
 
-datetime datetime::strptime(const std::string& str, const std::string& fmt) {
-  const char* pfmt = fmt.c_str();
-  const char* pstr = str.c_str();
-
-  int _year = 0;
-  int _month = 0;
-  int _day = 0;
-  int _hour = 0;
-  int _minute = 0;
-  int _second = 0;
-  int _microsecond = 0;
-
-#define PARSE_02d(name)                                                          \
-  if (pstr[1] == 0 || !isdigit(pstr[0]) || !isdigit(pstr[1])) {                  \
-    goto error;                                                                  \
-  }                                                                              \
-  name = static_cast<int>(pstr[0] - '0') * 10 + static_cast<int>(pstr[1] - '0'); \
-  pstr += 2;                                                                     \
+/* strptime的核心，不抛出异常，也不检查字段的范围。fields依次为年、月、日、时、分、秒、微秒 */
+static bool strptime_fields(const char* pstr, const char* pstr_end, const char* pfmt,
+                            const char* pfmt_end, int* fields) {
+  int& _year = fields[0];
+  int& _month = fields[1];
+  int& _day = fields[2];
+  int& _hour = fields[3];
+  int& _minute = fields[4];
+  int& _second = fields[5];
+  int& _microsecond = fields[6];
+  for (int i = 0; i < 7; ++i) {
+    fields[i] = 0;
+  }
+
+  // 先检查剩余长度再读取，不依赖字符串末尾的'\0'
+#define PARSE_02d(name)                                       \
+  if (pstr_end - pstr < 2 || !parse_digits<2>(pstr, &name)) { \
+    return false;                                             \
+  }                                                           \
+  pstr += 2;                                                  \
   break;
 
-  while (*pfmt && *pstr) {
+  while (pfmt < pfmt_end && pstr < pstr_end) {
     if (*pfmt != '%') {
       if (*pfmt != *pstr) {
-        goto error;
+        return false;
       }
       ++pfmt;
       ++pstr;
       continue;
     }
 
-    if (*pstr == 0) {
-      goto error;
-    }
-
     ++pfmt;
-    // 如果到了末尾则*pfmt == '\0'
+    if (pfmt == pfmt_end) {
+      return false;
+    }
     switch (*pfmt) {
       case 'Y': {
-        if (pstr[1] == 0 || pstr[2] == 0 || pstr[3] == 0 || !isdigit(pstr[0]) ||
-            !isdigit(pstr[1]) || !isdigit(pstr[2]) || !isdigit(pstr[3])) {
-          goto error;
+        if (pstr_end - pstr < 4 || !parse_digits<4>(pstr, &_year)) {
+          return false;
         }
-        _year = static_cast<int>(pstr[0] - '0') * 1000 + static_cast<int>(pstr[1] - '0') * 100 +
-                static_cast<int>(pstr[2] - '0') * 10 + static_cast<int>(pstr[3] - '0');
         pstr += 4;
         break;
       }
@@ -1109,54 +1218,84 @@ datetime datetime::strptime(const std::string& str, const std::string& fmt) {
         PARSE_02d(_second);
       }
       case 'f': {
-        if (pstr[1] == 0 || pstr[2] == 0 || pstr[3] == 0 || pstr[4] == 0 || pstr[5] == 0 ||
-            !isdigit(pstr[0]) || !isdigit(pstr[1]) || !isdigit(pstr[2]) || !isdigit(pstr[3]) ||
-            !isdigit(pstr[4]) || !isdigit(pstr[5])) {
-          goto error;
+        if (pstr_end - pstr < 6 || !parse_digits<6>(pstr, &_microsecond)) {
+          return false;
         }
-        _microsecond =
-            static_cast<int>(pstr[0] - '0') * 100000 + static_cast<int>(pstr[1] - '0') * 10000 +
-            static_cast<int>(pstr[2] - '0') * 1000 + static_cast<int>(pstr[3] - '0') * 100 +
-            static_cast<int>(pstr[4] - '0') * 10 + static_cast<int>(pstr[5] - '0');
         pstr += 6;
         break;
       }
       case '%': {
         if (*pstr != '%') {
-          goto error;
+          return false;
         }
         ++pstr;
         break;
       }
       default: {
-        goto error;
+        return false;
       }
     }
 
     ++pfmt;
   }
 
-  if (*pfmt != 0) {
-    goto error;
-  }
-  return datetime(_year, _month, _day, _hour, _minute, _second, _microsecond);
+#undef PARSE_02d
 
-error:
-  throw std::invalid_argument(
-      fmt::format("datetime::strptime: Invalid format: date_string:{} fmt:{}", str, fmt));
+  return pfmt == pfmt_end;
+}
 
-#undef PARSE_02d
+datetime datetime::strptime(const std::string& str, const std::string& fmt) {
+  int f[7];
+  if (!strptime_fields(str.data(), str.data() + str.size(), fmt.data(), fmt.data() + fmt.size(),
+                       f)) {
+    throw std::invalid_argument(
+        fmt::format("datetime::strptime: Invalid format: date_string:{} fmt:{}", str, fmt));
+  }
+  return datetime(f[0], f[1], f[2], f[3], f[4], f[5], f[6]);
+}
+
+bool strptime_timestamp(std::string_view str, std::string_view fmt, long long* timestamp) {
+  int f[7];
+  if (!strptime_fields(str.data(), str.data() + str.size(), fmt.data(), fmt.data() + fmt.size(),
+                       f)) {
+    return false;
+  }
+  /* 与check_date_args、check_time_args相同的检查，微秒固定为6位数字，不会超出范围 */
+  if (f[0] < kMinYear || f[0] > kMaxYear || f[1] < 1 || f[1] > 12 || f[2] < 1 ||
+      f[2] > days_in_month(f[0], f[1]) || f[3] > 23 || f[4] > 59 || f[5] > 59) {
+    return false;
+  }
+  long days = ymd_to_ord(f[0], f[1], f[2]) - kEpochOrdinal;
+  long seconds = (days * 24 + f[3]) * 3600 + f[4] * 60 + f[5];
+  *timestamp = seconds * kUsPerSecond + f[6];
+  return true;
 }
 
 std::string date::strftime(const std::string& fmt) const {
-  datetime dt(year(), month(), day(), 0, 0, 0, 0);
+  datetime dt(year(), month(), day(), 0, 0, 0, 0, detail::NonCheckTag{});
   return dt.strftime(fmt);
 }
 
+std::pmr::string date::strftime(const std::string& fmt,
+                                std::pmr::memory_resource* resource) const {
+  datetime dt(year(), month(), day(), 0, 0, 0, 0, detail::NonCheckTag{});
+  return dt.strftime(fmt, resource);
+}
+
 std::string date::ctime() const { return format_ctime(year(), month(), day(), 0, 0, 0); }
 
 std::string date::isoformat() const {
-  return fmt::format("{:04d}-{:02d}-{:02d}", year(), month(), day());
+  char buf[kIsoformatSize];
+  return std::string(buf, isoformat(buf));
+}
+
+std::pmr::string date::isoformat(std::pmr::memory_resource* resource) const {
+  char buf[kIsoformatSize];
+  return std::pmr::string(buf, isoformat(buf), resource);
+}
+
+std::size_t date::isoformat(char* buf) const {
+  return write_date(buf, year(), month(), day()) - buf;
 }
 
 std::string date::str() const { return isoformat(); }
@@ -1174,13 +1313,6 @@ time::time(int hour, int minute, int second, int usecond) {
   set_microsecond(usecond);
 }
 
-time::time(int hour, int minute, int second, int usecond, detail::NonCheckTag) {
-  set_hour(hour);
-  set_minute(minute);
-  set_second(second);
-  set_microsecond(usecond);
-}
-
 time time::fromisoformat(const std::string& time_string) {
   int hour = 0, minute = 0, second = 0, microsecond = 0;
   int tzoffset, tzimicrosecond = 0;
@@ -1196,17 +1328,28 @@ time time::fromisoformat(const std::string& time_string) {
 }
 
 std::string time::strftime(const std::string& fmt) const {
-  datetime dt(1900, 1, 1, hour(), minute(), second(), microsecond());
+  datetime dt(1900, 1, 1, hour(), minute(), second(), microsecond(), detail::NonCheckTag{});
   return dt.strftime(fmt);
 }
 
+std::pmr::string time::strftime(const std::string& fmt,
+                                std::pmr::memory_resource* resource) const {
+  datetime dt(1900, 1, 1, hour(), minute(), second(), microsecond(), detail::NonCheckTag{});
+  return dt.strftime(fmt, resource);
+}
+
 std::string time::isoformat() const {
-  int us = microsecond();
-  if (us != 0) {
-    return fmt::format("{:02d}:{:02d}:{:02d}.{:06d}", hour(), minute(), second(), us);
-  } else {
-    return fmt::format("{:02d}:{:02d}:{:02d}", hour(), minute(), second());
-  }
+  char buf[kMaxIsoformatSize];
+  return std::string(buf, isoformat(buf));
+}
+
+std::pmr::string time::isoformat(std::pmr::memory_resource* resource) const {
+  char buf[kMaxIsoformatSize];
+  return std::pmr::string(buf, isoformat(buf), resource);
+}
+
+std::size_t time::isoformat(char* buf) const {
+  return write_time(buf, hour(), minute(), second(), microsecond()) - buf;
 }
 
 std::string time::str() const { return isoformat(); }
@@ -1226,7 +1369,7 @@ std::string time::repr() const {
   }
 }
 
-::datetime::datetime datetime::kDatetimeEpoch{1970, 1, 1, 0, 0, 0, 0};
+const ::datetime::datetime datetime::kDatetimeEpoch{1970, 1, 1, 0, 0, 0, 0};
 
 datetime::datetime(int year, int month, int day, int hour, int minute, int second, int usecond) {
   check_date_args(year, month, day);
@@ -1241,19 +1384,6 @@ datetime::datetime(int year, int month, int day, int hour, int minute, int secon
   set_microsecond(usecond);
 }
 
-datetime::datetime(int year, int month, int day, int hour, int minute, int second, int usecond,
-                   detail::NonCheckTag) {
-  set_year(year);
-  set_month(month);
-  set_day(day);
-  set_hour(hour);
-  set_minute(minute);
-  set_second(second);
-  set_microsecond(usecond);
-}
-
-datetime::datetime(const datetime& other) { memcpy(data_, other.data_, sizeof(data_)); }
-
 datetime datetime::now() {
   auto ts = std::chrono::duration_cast<std::chrono::microseconds>(
       std::chrono::system_clock::now().time_since_epoch());
@@ -1273,25 +1403,49 @@ datetime datetime::fromtimestamp(std::chrono::microseconds timestamp) {
                   timestamp.count() % 1000000UL);
 }
 
+datetime datetime::utcfromtimestamp(std::chrono::microseconds timestamp) {
+  long us = timestamp.count();
+  long days = divmod(us, kUsPerDay, &us);
+  if (days < 1 - kEpochOrdinal || days > kMaxOrdinal - kEpochOrdinal) {
+    throw std::out_of_range(
+        fmt::format("datetime::utcfromtimestamp: Timestamp out of range: {}", timestamp.count()));
+  }
+
+  int y;
+  int m;
+  int d;
+  ord_to_ymd(static_cast<int>(days + kEpochOrdinal), &y, &m, &d);
+
+  long s = divmod(us, kUsPerSecond, &us);
+  int hh = static_cast<int>(s / 3600);
+  int mm = static_cast<int>(s % 3600 / 60);
+  int ss = static_cast<int>(s % 60);
+  return datetime(y, m, d, hh, mm, ss, static_cast<int>(us), detail::NonCheckTag{});
+}
+
 datetime datetime::fromordinal(int ordinal) {
   if (ordinal < 1) {
     throw std::invalid_argument(fmt::format("datetime::fromordinal: Invalid ordinal: {}", ordinal));
   }
+  if (ordinal > kMaxOrdinal) {
+    throw std::out_of_range(fmt::format("datetime::fromordinal: Ordinal out of range: {}", ordinal));
+  }
 
   int y;
   int m;
   int d;
   ord_to_ymd(ordinal, &y, &m, &d);
-  return datetime(y, m, d);
+  return datetime(y, m, d, 0, 0, 0, 0, detail::NonCheckTag{});
 }
 
 datetime datetime::fromisocalendar(const IsoCalendarDate& iso_calendar) {
   auto d = ::datetime::date::fromisocalendar(iso_calendar);
-  return datetime(d.year(), d.month(), d.day());
+  return datetime(d.year(), d.month(), d.day(), 0, 0, 0, 0, detail::NonCheckTag{});
 }
 
 datetime datetime::combine(const ::datetime::date& d, const ::datetime::time& t) {
-  return datetime(d.year(), d.month(), d.day(), t.hour(), t.minute(), t.second(), t.microsecond());
+  return datetime(d.year(), d.month(), d.day(), t.hour(), t.minute(), t.second(), t.microsecond(),
+                  detail::NonCheckTag{});
 }
 
 datetime datetime::operator+(const timedelta& delta) const {
@@ -1306,7 +1460,7 @@ datetime datetime::operator+(const timedelta& delta) const {
   if (normalize_datetime(&y, &m, &d, &h, &min, &s, &us) < 0) {
     throw std::out_of_range("Failed to normalize datetime");
   }
-  return datetime(y, m, d, h, min, s, us);
+  return datetime(y, m, d, h, min, s, us, detail::NonCheckTag{});
 }
 
 datetime& datetime::operator+=(const timedelta& delta) {
@@ -1326,7 +1480,7 @@ datetime datetime::operator-(const timedelta& delta) const {
   if (normalize_datetime(&y, &m, &d, &h, &min, &s, &us) < 0) {
     throw std::out_of_range("Failed to normalize datetime");
   }
-  return datetime(y, m, d, h, min, s, us);
+  return datetime(y, m, d, h, min, s, us, detail::NonCheckTag{});
 }
 
 datetime& datetime::operator-=(const timedelta& delta) {
@@ -1358,14 +1512,58 @@ std::chrono::microseconds datetime::timestamp() const {
   return std::chrono::microseconds{total_sec * 1000000 + microsecond()};
 }
 
-std::string datetime::strftime(const std::string& fmt) const {
-  std::stringstream ss;
+std::chrono::microseconds datetime::utctimestamp() const {
+  long days = ymd_to_ord(year(), month(), day()) - kEpochOrdinal;
+  long seconds = (days * 24 + hour()) * 3600 + minute() * 60 + second();
+  return std::chrono::microseconds{seconds * kUsPerSecond + microsecond()};
+}
+
+/* 以下函数写入定长的字段，返回写入后的位置 */
+
+/* YYYY */
+static inline char* write_year(char* p, int year) {
+  p = write_2digits(p, year / 100);
+  return write_2digits(p, year % 100);
+}
+
+/* HH:MM:SS */
+static inline char* write_hh_mm_ss(char* p, int hour, int minute, int second) {
+  p = write_2digits(p, hour);
+  *p++ = ':';
+  p = write_2digits(p, minute);
+  *p++ = ':';
+  return write_2digits(p, second);
+}
+
+/* 写入name，不包括结尾的'\0' */
+static inline char* write_name(char* p, const char* name) {
+  std::size_t n = std::strlen(name);
+  std::memcpy(p, name, n);
+  return p + n;
+}
+
+/* strftime的实现，结果追加到out，Out需要支持append(const char*, std::size_t)。
+ * 结果先写入栈上的buf，剩余空间不足一个格式化符号的最大长度时才追加到out，
+ * 通常每次调用只追加一次
+ */
+template <class Out>
+static void strftime_to(const ::datetime::datetime& dt, const std::string& fmt, Out* out) {
+  /* 一个格式化符号最多写入的字节数，%c为24字节 */
+  constexpr std::size_t kMaxFieldSize = 32;
+  char buf[256];
+  char* const buf_end = buf + sizeof(buf);
+  char* p = buf;
   std::size_t i = 0;
 
   while (i < fmt.size()) {
+    if (static_cast<std::size_t>(buf_end - p) < kMaxFieldSize) {
+      out->append(buf, p - buf);
+      p = buf;
+    }
+
+    /* 字面量通常只有一两个字符，逐个复制 */
     if (fmt[i] != '%') {
-      ss << fmt[i];
-      ++i;
+      *p++ = fmt[i++];
       continue;
     }
 
@@ -1373,71 +1571,69 @@ std::string datetime::strftime(const std::string& fmt) const {
     // 如果到了末尾则fmt[i] == '\0'
     switch (fmt[i]) {
       case 'a': {
-        ss << kDayNames[weekday()];
+        std::memcpy(p, kDayNames[dt.weekday()], 3);
+        p += 3;
         break;
       }
       case 'A': {
-        ss << kDayFullNames[weekday()];
+        p = write_name(p, kDayFullNames[dt.weekday()]);
         break;
       }
       case 'w': {
-        ss << ((weekday() + 1) % 7);
+        *p++ = static_cast<char>('0' + (dt.weekday() + 1) % 7);
         break;
       }
       case 'd': {
-        ss << std::setw(2) << std::setfill('0') << day();
+        p = write_2digits(p, dt.day());
         break;
       }
       case 'b': {
-        ss << kMonthNames[month() - 1];
+        std::memcpy(p, kMonthNames[dt.month() - 1], 3);
+        p += 3;
         break;
       }
       case 'B': {
-        ss << kMonthFullNames[month() - 1];
+        p = write_name(p, kMonthFullNames[dt.month() - 1]);
         break;
       }
       case 'm': {
-        ss << std::setw(2) << std::setfill('0') << month();
+        p = write_2digits(p, dt.month());
         break;
       }
       case 'y': {
-        ss << std::setw(2) << std::setfill('0') << (year() % 100);
+        p = write_2digits(p, dt.year() % 100);
         break;
       }
       case 'Y': {
-        ss << std::setw(4) << std::setfill('0') << year();
+        p = write_year(p, dt.year());
         break;
       }
       case 'H': {
-        ss << std::setw(2) << std::setfill('0') << hour();
+        p = write_2digits(p, dt.hour());
         break;
       }
       case 'I': {
-        if (hour() == 0 || hour() == 12) {
-          ss << "12";
-        } else {
-          ss << std::setw(2) << std::setfill('0') << (hour() % 12);
-        }
+        p = write_2digits(p, dt.hour() % 12 == 0 ? 12 : dt.hour() % 12);
         break;
       }
       case 'p': {
-        if (hour() < 12) {
-          ss << "AM";
-        } else {
-          ss << "PM";
-        }
+        std::memcpy(p, dt.hour() < 12 ? "AM" : "PM", 2);
+        p += 2;
         break;
       }
       case 'M': {
-        ss << std::setw(2) << std::setfill('0') << minute();
+        p = write_2digits(p, dt.minute());
         break;
       }
       case 'S': {
-        ss << std::setw(2) << std::setfill('0') << second();
+        p = write_2digits(p, dt.second());
         break;
       }
       case 'f': {
-        ss << std::setw(6) << std::setfill('0') << microsecond();
+        int us = dt.microsecond();
+        p = write_2digits(p, us / 10000);
+        p = write_2digits(p, us / 100 % 100);
+        p = write_2digits(p, us % 100);
         break;
       }
       case 'z': {
@@ -1451,52 +1647,61 @@ std::string datetime::strftime(const std::string& fmt) const {
         break;
       }
       case 'j': {
-        ss << std::setw(3) << std::setfill('0') << (days_before_month(year(), month()) + day());
+        int yday = day_of_year(dt.year(), dt.month(), dt.day());
+        *p++ = static_cast<char>('0' + yday / 100);
+        p = write_2digits(p, yday % 100);
         break;
       }
       case 'U': {
-        int first_weekday = ::datetime::weekday(year(), 1, 1);
+        int first_weekday = year_info(dt.year()).first_weekday;
         int first_sunday = 1;
         if (first_weekday < 6) {
           first_sunday += (6 - first_weekday);
         }
-        int day_of_year = days_before_month(year(), month()) + day();
-        if (day_of_year < first_sunday) {
-          ss << "00";
-        } else {
-          ss << std::setw(2) << std::setfill('0') << (1 + (day_of_year - first_sunday) / 7);
-        }
+        int yday = day_of_year(dt.year(), dt.month(), dt.day());
+        p = write_2digits(p, yday < first_sunday ? 0 : 1 + (yday - first_sunday) / 7);
         break;
       }
       case 'W': {
-        int first_weekday = ::datetime::weekday(year(), 1, 1);
+        int first_weekday = year_info(dt.year()).first_weekday;
         int first_monday = 1;
         if (first_weekday > 0) {
           first_monday += (6 - first_weekday + 1);
         }
-        int day_of_year = days_before_month(year(), month()) + day();
-        if (day_of_year < first_monday) {
-          ss << "00";
-        } else {
-          ss << std::setw(2) << std::setfill('0') << (1 + (day_of_year - first_monday) / 7);
-        }
+        int yday = day_of_year(dt.year(), dt.month(), dt.day());
+        p = write_2digits(p, yday < first_monday ? 0 : 1 + (yday - first_monday) / 7);
         break;
       }
       case 'c': {
-        ss << fmt::format("{} {} {:>2d} {:02d}:{:02d}:{:02d} {:04d}", kDayNames[weekday()],
-                          kMonthNames[month() - 1], day(), hour(), minute(), second(), year());
+        /* Www Mmm dd HH:MM:SS YYYY，日期不足两位时前面补空格 */
+        std::memcpy(p, kDayNames[dt.weekday()], 3);
+        p[3] = ' ';
+        std::memcpy(p + 4, kMonthNames[dt.month() - 1], 3);
+        p[7] = ' ';
+        p = write_2digits(p + 8, dt.day());
+        if (p[-2] == '0') {
+          p[-2] = ' ';
+        }
+        *p++ = ' ';
+        p = write_hh_mm_ss(p, dt.hour(), dt.minute(), dt.second());
+        *p++ = ' ';
+        p = write_year(p, dt.year());
         break;
       }
       case 'x': {
-        ss << fmt::format("{:02d}/{:02d}/{:02d}", month(), day(), (year() % 100));
+        p = write_2digits(p, dt.month());
+        *p++ = '/';
+        p = write_2digits(p, dt.day());
+        *p++ = '/';
+        p = write_2digits(p, dt.year() % 100);
         break;
       }
       case 'X': {
-        ss << fmt::format("{:02d}:{:02d}:{:02d}", hour(), minute(), second());
+        p = write_hh_mm_ss(p, dt.hour(), dt.minute(), dt.second());
         break;
       }
       case '%': {
-        ss << '%';
+        *p++ = '%';
         break;
       }
       default: {
@@ -1506,8 +1711,20 @@ std::string datetime::strftime(const std::string& fmt) const {
 
     ++i;
   }
+  out->append(buf, p - buf);
+}
 
-  return ss.str();
+std::string datetime::strftime(const std::string& fmt) const {
+  std::string result;
+  strftime_to(*this, fmt, &result);
+  return result;
+}
+
+std::pmr::string datetime::strftime(const std::string& fmt,
+                                    std::pmr::memory_resource* resource) const {
+  std::pmr::string result(resource);
+  strftime_to(*this, fmt, &result);
+  return result;
 }
 
 std::string datetime::ctime() const {
@@ -1515,15 +1732,19 @@ std::string datetime::ctime() const {
 }
 
 std::string datetime::str() const {
-  char sep = 'T';
-  int us = microsecond();
-  if (us != 0) {
-    return fmt::format("{:04d}-{:02d}-{:02d}{}{:02d}:{:02d}:{:02d}.{:06d}", year(), month(), day(),
-                       sep, hour(), minute(), second(), us);
-  } else {
-    return fmt::format("{:04d}-{:02d}-{:02d}{}{:02d}:{:02d}:{:02d}", year(), month(), day(), sep,
-                       hour(), minute(), second());
-  }
+  char buf[kMaxStrSize];
+  return std::string(buf, str(buf));
+}
+
+std::pmr::string datetime::str(std::pmr::memory_resource* resource) const {
+  char buf[kMaxStrSize];
+  return std::pmr::string(buf, str(buf), resource);
+}
+
+std::size_t datetime::str(char* buf) const {
+  char* p = write_date(buf, year(), month(), day());
+  *p++ = 'T';
+  return write_time(p, hour(), minute(), second(), microsecond()) - buf;
 }
 
 std::string datetime::repr() const {
@@ -1538,4 +1759,65 @@ std::string datetime::repr() const {
   }
 }
 
+/* ---------------------------------------------------------------------------
+ * Batch formatting
+ */
+
+/* 每个元素的结果不超过kMaxSize字节，先按最大长度扩展chars直接写入，最后截掉多余的部分 */
+template <std::size_t kMaxSize, class T, class F>
+static void format_column(const T* values, std::size_t n, StringColumn* out, F&& format) {
+  std::size_t offset = out->chars.size();
+  std::size_t first = out->offsets.size();
+  out->chars.resize(offset + n * kMaxSize);
+  out->offsets.resize(first + n);
+
+  char* chars = out->chars.data();
+  int64_t* offsets = out->offsets.data() + first;
+  for (std::size_t i = 0; i < n; ++i) {
+    offset += format(values[i], chars + offset);
+    offsets[i] = static_cast<int64_t>(offset);
+  }
+  out->chars.resize(offset);
+}
+
+void isoformat(const date* values, std::size_t n, StringColumn* out) {
+  format_column<date::kIsoformatSize>(values, n, out,
+                                      [](const date& d, char* buf) { return d.isoformat(buf); });
+}
+
+void isoformat(const time* values, std::size_t n, StringColumn* out) {
+  format_column<time::kMaxIsoformatSize>(
+      values, n, out, [](const time& t, char* buf) { return t.isoformat(buf); });
+}
+
+void str(const ::datetime::datetime* values, std::size_t n, StringColumn* out) {
+  format_column<::datetime::datetime::kMaxStrSize>(
+      values, n, out, [](const ::datetime::datetime& dt, char* buf) { return dt.str(buf); });
+}
+
+/* strftime_to的输出，直接追加到StringColumn::chars */
+struct CharsAppender {
+  void append(const char* s, std::size_t n) { chars->insert(chars->end(), s, s + n); }
+
+  std::pmr::vector<char>* chars;
+};
+
+void strftime(const ::datetime::datetime* values, std::size_t n, const std::string& format,
+              StringColumn* out) {
+  std::size_t chars_size = out->chars.size();
+  std::size_t offsets_size = out->offsets.size();
+  out->offsets.reserve(offsets_size + n);
+  CharsAppender appender{&out->chars};
+  try {
+    for (std::size_t i = 0; i < n; ++i) {
+      strftime_to(values[i], format, &appender);
+      out->offsets.push_back(static_cast<int64_t>(out->chars.size()));
+    }
+  } catch (...) {
+    out->chars.resize(chars_size);
+    out->offsets.resize(offsets_size);
+    throw;
+  }
+}
+
 }  // namespace datetime
@@ -0,0 +1,377 @@
+#include "datetime_sort.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace datetime {
+
+/* 每个线程至少处理的元素个数，避免小数组也启动很多线程 */
+static constexpr std::size_t kMinChunkSize = 64 * 1024;
+
+/* 元素较少时std::sort更快，也不值得初始化基数排序的计数器 */
+static constexpr std::size_t kMinRadixSize = 256;
+
+static constexpr int kRadixBits = 11;
+static constexpr std::size_t kRadixSize = std::size_t{1} << kRadixBits;
+static constexpr uint64_t kRadixMask = kRadixSize - 1;
+static constexpr int kMaxPasses = (64 + kRadixBits - 1) / kRadixBits;
+
+/* 并行归并时每段从各序列中抽样的个数 */
+static constexpr std::size_t kSamplesPerPart = 32;
+
+/* 把long long映射到uint64_t并保持顺序 */
+static constexpr uint64_t kSignBit = uint64_t{1} << 63;
+
+static uint64_t datetime_key(const ::datetime::datetime& dt) {
+  return detail::key_traits<::datetime::datetime>::pack(dt);
+}
+
+static uint64_t timestamp_key(long long timestamp) {
+  return static_cast<uint64_t>(timestamp) ^ kSignBit;
+}
+
+static uint64_t identity_key(uint64_t key) { return key; }
+
+/* 数组分成的段数，每段至少kMinChunkSize个元素 */
+static std::size_t num_parts(std::size_t n, unsigned num_threads) {
+  if (num_threads == 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  return std::max<std::size_t>(1, std::min<std::size_t>(num_threads, n / kMinChunkSize));
+}
+
+/* 每个线程调用一次f(i)，i为0到parts-1，parts为1时在当前线程调用 */
+template <class F>
+static void run_parallel(std::size_t parts, F&& f) {
+  if (parts == 1) {
+    f(std::size_t{0});
+    return;
+  }
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < parts; ++i) {
+    threads.emplace_back([&f, i] { f(i); });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+/* ---------------------------------------------------------------------------
+ * Radix sort
+ */
+
+/* 对keys升序排序，buf为同样大小的临时空间 */
+static void radix_sort_keys(uint64_t* keys, uint64_t* buf, std::size_t n) {
+  if (n < kMinRadixSize) {
+    std::sort(keys, keys + n);
+    return;
+  }
+
+  uint64_t min = keys[0];
+  uint64_t max = keys[0];
+  for (std::size_t i = 1; i < n; ++i) {
+    min = std::min(min, keys[i]);
+    max = std::max(max, keys[i]);
+  }
+  if (min == max) {
+    return;
+  }
+
+  /* 对与最小值的差排序，差值的高位全为0，不需要处理 */
+  int passes = (std::bit_width(max - min) + kRadixBits - 1) / kRadixBits;
+  std::vector<std::size_t> counts(passes * kRadixSize);
+  for (std::size_t i = 0; i < n; ++i) {
+    uint64_t k = keys[i] - min;
+    keys[i] = k;
+    for (int p = 0; p < passes; ++p) {
+      ++counts[p * kRadixSize + ((k >> (p * kRadixBits)) & kRadixMask)];
+    }
+  }
+
+  /* 所有元素的数字都相同的趟不需要移动元素 */
+  bool needed[kMaxPasses];
+  int last = 0;
+  for (int p = 0; p < passes; ++p) {
+    needed[p] = counts[p * kRadixSize + ((keys[0] >> (p * kRadixBits)) & kRadixMask)] != n;
+    if (needed[p]) {
+      last = p;
+    }
+  }
+
+  uint64_t* src = keys;
+  uint64_t* dst = buf;
+  for (int p = 0; p < passes; ++p) {
+    if (!needed[p]) {
+      continue;
+    }
+    std::size_t* offsets = &counts[p * kRadixSize];
+    std::size_t sum = 0;
+    for (std::size_t b = 0; b < kRadixSize; ++b) {
+      std::size_t count = offsets[b];
+      offsets[b] = sum;
+      sum += count;
+    }
+    /* 最后一趟顺便加回最小值 */
+    int shift = p * kRadixBits;
+    uint64_t base = p == last ? min : 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      uint64_t k = src[i];
+      dst[offsets[(k >> shift) & kRadixMask]++] = k + base;
+    }
+    std::swap(src, dst);
+  }
+  if (src != keys) {
+    std::memcpy(keys, src, n * sizeof(uint64_t));
+  }
+}
+
+/* ---------------------------------------------------------------------------
+ * k-way merge
+ */
+
+/**
+ * loser tree：tree_[1]到tree_[k - 1]为内部节点，保存在该节点的比赛中输掉的序列，
+ * tree_[0]为最终的胜者。序列i对应的叶子为k + i，节点j的父节点为j / 2。
+ * key相同时order_小的胜出，未结束的序列order_为序号，已结束的为序号加k，排在所有未结束的序列之后。
+ */
+class LoserTree {
+ public:
+  explicit LoserTree(std::size_t k) : keys_(k), order_(k), tree_(k) {}
+
+  void set(std::size_t i, uint64_t key) {
+    keys_[i] = key;
+    order_[i] = i;
+  }
+  void set_done(std::size_t i) {
+    keys_[i] = std::numeric_limits<uint64_t>::max();
+    order_[i] = keys_.size() + i;
+  }
+
+  /* 所有序列都set之后调用 */
+  void build() { tree_[0] = keys_.size() == 1 ? 0 : build(1); }
+
+  std::size_t top() const { return tree_[0]; }
+
+  /* 胜者的key改变之后，沿着它的叶子到根的路径重新比赛 */
+  void replay() {
+    std::size_t k = keys_.size();
+    uint32_t winner = tree_[0];
+    for (std::size_t j = (winner + k) / 2; j > 0; j /= 2) {
+      if (less(tree_[j], winner)) {
+        std::swap(tree_[j], winner);
+      }
+    }
+    tree_[0] = winner;
+  }
+
+ private:
+  bool less(std::size_t a, std::size_t b) const {
+    return keys_[a] < keys_[b] || (keys_[a] == keys_[b] && order_[a] < order_[b]);
+  }
+
+  /* 返回以节点j为根的子树的胜者 */
+  uint32_t build(std::size_t j) {
+    std::size_t k = keys_.size();
+    if (j >= k) {
+      return static_cast<uint32_t>(j - k);
+    }
+    uint32_t a = build(2 * j);
+    uint32_t b = build(2 * j + 1);
+    if (less(b, a)) {
+      std::swap(a, b);
+    }
+    tree_[j] = b;
+    return a;
+  }
+
+  std::vector<uint64_t> keys_;
+  std::vector<std::size_t> order_;
+  std::vector<uint32_t> tree_;
+};
+
+template <class T, class Key>
+static void merge_runs(const SortedRun<T>* runs, std::size_t k, T* out, uint32_t* run_index,
+                       Key key) {
+  if (k == 0) {
+    return;
+  }
+  LoserTree tree(k);
+  std::vector<std::size_t> pos(k);
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < k; ++i) {
+    total += runs[i].size;
+    if (runs[i].size != 0) {
+      tree.set(i, key(runs[i].data[0]));
+    } else {
+      tree.set_done(i);
+    }
+  }
+  tree.build();
+
+  for (std::size_t n = 0; n < total; ++n) {
+    std::size_t i = tree.top();
+    const SortedRun<T>& run = runs[i];
+    out[n] = run.data[pos[i]];
+    if (run_index != nullptr) {
+      run_index[n] = static_cast<uint32_t>(i);
+    }
+    if (++pos[i] < run.size) {
+      tree.set(i, key(run.data[pos[i]]));
+    } else {
+      tree.set_done(i);
+    }
+    tree.replay();
+  }
+}
+
+/**
+ * 从各序列中按相同的间隔抽样，取样本的分位数作为分割点，每个序列中小于第t个分割点的元素
+ * 属于前t段，各段在输出中互不重叠，可以分别用一个线程归并。与分割点相等的元素都在后一段，
+ * 所以相等的元素仍然按序列的先后输出。
+ */
+template <class T, class Key>
+static void parallel_merge(const SortedRun<T>* runs, std::size_t k, T* out, uint32_t* run_index,
+                           Key key, std::size_t parts) {
+  if (parts <= 1) {
+    merge_runs(runs, k, out, run_index, key);
+    return;
+  }
+
+  std::size_t total = 0;
+  for (std::size_t r = 0; r < k; ++r) {
+    total += runs[r].size;
+  }
+  std::size_t stride = std::max<std::size_t>(1, total / (kSamplesPerPart * parts));
+  std::vector<uint64_t> samples;
+  for (std::size_t r = 0; r < k; ++r) {
+    for (std::size_t i = stride / 2; i < runs[r].size; i += stride) {
+      samples.push_back(key(runs[r].data[i]));
+    }
+  }
+  /* 序列很多且都很短时可能没有样本 */
+  if (samples.empty()) {
+    merge_runs(runs, k, out, run_index, key);
+    return;
+  }
+  std::sort(samples.begin(), samples.end());
+
+  /* bounds[t * k + r]为第t段在序列r中的起点 */
+  std::vector<std::size_t> bounds((parts + 1) * k);
+  for (std::size_t r = 0; r < k; ++r) {
+    bounds[parts * k + r] = runs[r].size;
+  }
+  for (std::size_t t = 1; t < parts; ++t) {
+    uint64_t splitter = samples[samples.size() * t / parts];
+    for (std::size_t r = 0; r < k; ++r) {
+      const T* data = runs[r].data;
+      bounds[t * k + r] =
+          std::lower_bound(data, data + runs[r].size, splitter,
+                           [&key](const T& x, uint64_t s) { return key(x) < s; }) -
+          data;
+    }
+  }
+  std::vector<std::size_t> offsets(parts + 1);
+  for (std::size_t t = 0; t <= parts; ++t) {
+    for (std::size_t r = 0; r < k; ++r) {
+      offsets[t] += bounds[t * k + r];
+    }
+  }
+
+  run_parallel(parts, [&](std::size_t t) {
+    std::vector<SortedRun<T>> slices(k);
+    for (std::size_t r = 0; r < k; ++r) {
+      std::size_t begin = bounds[t * k + r];
+      slices[r] = {runs[r].data + begin, bounds[(t + 1) * k + r] - begin};
+    }
+    merge_runs(slices.data(), k, out + offsets[t],
+               run_index == nullptr ? nullptr : run_index + offsets[t], key);
+  });
+}
+
+/* ---------------------------------------------------------------------------
+ * Public API
+ */
+
+/**
+ * 把data转换成key后分段并行排序，再把各段归并，最后转换回data。
+ * to_key(data[i])写入keys[i]，from_key(key)返回排序后的元素。
+ */
+template <class T, class ToKey, class FromKey>
+static void sort_by_keys(T* data, std::size_t n, unsigned num_threads, ToKey to_key,
+                         FromKey from_key) {
+  std::size_t parts = num_parts(n, num_threads);
+  auto keys = std::make_unique_for_overwrite<uint64_t[]>(n);
+  auto buf = std::make_unique_for_overwrite<uint64_t[]>(n);
+  auto chunk = [n, parts](std::size_t t) { return n * t / parts; };
+
+  run_parallel(parts, [&](std::size_t t) {
+    std::size_t begin = chunk(t);
+    std::size_t end = chunk(t + 1);
+    for (std::size_t i = begin; i < end; ++i) {
+      keys[i] = to_key(data[i]);
+    }
+    radix_sort_keys(keys.get() + begin, buf.get() + begin, end - begin);
+  });
+
+  const uint64_t* sorted = keys.get();
+  if (parts > 1) {
+    std::vector<SortedRun<uint64_t>> runs;
+    for (std::size_t t = 0; t < parts; ++t) {
+      runs.push_back({keys.get() + chunk(t), chunk(t + 1) - chunk(t)});
+    }
+    parallel_merge(runs.data(), parts, buf.get(), nullptr, identity_key, parts);
+    sorted = buf.get();
+  }
+
+  run_parallel(parts, [&](std::size_t t) {
+    for (std::size_t i = chunk(t); i < chunk(t + 1); ++i) {
+      data[i] = from_key(sorted[i]);
+    }
+  });
+}
+
+void radix_sort(::datetime::datetime* data, std::size_t n, unsigned num_threads) {
+  if (n < kMinRadixSize) {
+    std::sort(data, data + n);
+    return;
+  }
+  sort_by_keys(data, n, num_threads, datetime_key, [](uint64_t key) {
+    return detail::key_traits<::datetime::datetime>::unpack(key);
+  });
+}
+
+void radix_sort(long long* timestamps, std::size_t n, unsigned num_threads) {
+  if (n < kMinRadixSize) {
+    std::sort(timestamps, timestamps + n);
+    return;
+  }
+  sort_by_keys(timestamps, n, num_threads, timestamp_key,
+               [](uint64_t key) { return static_cast<long long>(key ^ kSignBit); });
+}
+
+template <class T, class Key>
+static void merge_sorted_impl(const std::vector<SortedRun<T>>& runs, T* out, uint32_t* run_index,
+                              unsigned num_threads, Key key) {
+  std::size_t total = 0;
+  for (const auto& run : runs) {
+    total += run.size;
+  }
+  parallel_merge(runs.data(), runs.size(), out, run_index, key, num_parts(total, num_threads));
+}
+
+void merge_sorted(const std::vector<SortedRun<::datetime::datetime>>& runs,
+                  ::datetime::datetime* out, uint32_t* run_index, unsigned num_threads) {
+  merge_sorted_impl(runs, out, run_index, num_threads, datetime_key);
+}
+
+void merge_sorted(const std::vector<SortedRun<long long>>& runs, long long* out,
+                  uint32_t* run_index, unsigned num_threads) {
+  merge_sorted_impl(runs, out, run_index, num_threads, timestamp_key);
+}
+
+}  // namespace datetime
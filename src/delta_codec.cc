@@ -0,0 +1,230 @@
+#include "delta_codec.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#include "fmt/format.h"
+
+namespace datetime {
+
+static constexpr std::size_t kHeaderSize = 8;
+
+/* 编码'1'*k + '0'后的数据位数，k == 5时没有结尾的'0' */
+static constexpr int kPayloadBits[] = {0, 7, 12, 20, 32, 64};
+
+static inline uint64_t zigzag(uint64_t v) {
+  return (v << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(v) >> 63);
+}
+
+static inline uint64_t unzigzag(uint64_t z) { return (z >> 1) ^ (0 - (z & 1)); }
+
+/* 逐字节读写，与主机字节序无关，编译器会将其合并为一次load/store加字节交换 */
+static inline uint64_t load_be64(const uint8_t* p) {
+  uint64_t v = 0;
+  for (int i = 0; i < 8; ++i) {
+    v = (v << 8) | p[i];
+  }
+  return v;
+}
+
+static inline void store_be64(uint8_t* p, uint64_t v) {
+  for (int i = 0; i < 8; ++i) {
+    p[i] = static_cast<uint8_t>(v >> (56 - 8 * i));
+  }
+}
+
+/* ---------------------------------------------------------------------------
+ * delta_encoder
+ */
+
+void delta_encoder::clear() {
+  bytes_.assign(kHeaderSize, 0);
+  acc_ = 0;
+  used_ = 0;
+  prev_ = 0;
+  prev_delta_ = 0;
+  count_ = 0;
+}
+
+/* 写入bits的低n位，1 <= n <= 64 */
+void delta_encoder::put(uint64_t bits, int n) {
+  if (n < 64) {
+    bits &= (uint64_t{1} << n) - 1;
+  }
+  int space = 64 - used_;
+  if (n < space) {
+    acc_ |= bits << (space - n);
+    used_ += n;
+    return;
+  }
+
+  int rest = n - space;
+  acc_ |= rest == 0 ? bits : bits >> rest;
+  std::size_t size = bytes_.size();
+  bytes_.resize(size + 8);
+  store_be64(&bytes_[size], acc_);
+  acc_ = rest == 0 ? 0 : bits << (64 - rest);
+  used_ = rest;
+}
+
+void delta_encoder::put_dod(uint64_t dod) {
+  uint64_t z = zigzag(dod);
+  if (z == 0) {
+    put(0, 1);
+  } else if (z < (uint64_t{1} << 7)) {
+    put((uint64_t{0b10} << 7) | z, 2 + 7);
+  } else if (z < (uint64_t{1} << 12)) {
+    put((uint64_t{0b110} << 12) | z, 3 + 12);
+  } else if (z < (uint64_t{1} << 20)) {
+    put((uint64_t{0b1110} << 20) | z, 4 + 20);
+  } else if (z < (uint64_t{1} << 32)) {
+    put((uint64_t{0b11110} << 32) | z, 5 + 32);
+  } else {
+    put(0b11111, 5);
+    put(z, 64);
+  }
+}
+
+void delta_encoder::append(long long timestamp) {
+  uint64_t v = static_cast<uint64_t>(timestamp);
+  if (count_ == 0) {
+    put(v, 64);
+  } else {
+    uint64_t delta = v - prev_;
+    put_dod(delta - prev_delta_);
+    prev_delta_ = delta;
+  }
+  prev_ = v;
+  ++count_;
+}
+
+void delta_encoder::append(const long long* timestamps, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    append(timestamps[i]);
+  }
+}
+
+const std::vector<uint8_t>& delta_encoder::finish() {
+  for (int i = 0; i < used_; i += 8) {
+    bytes_.push_back(static_cast<uint8_t>(acc_ >> (56 - i)));
+  }
+  acc_ = 0;
+  used_ = 0;
+
+  uint64_t count = count_;
+  for (std::size_t i = 0; i < kHeaderSize; ++i) {
+    bytes_[i] = static_cast<uint8_t>(count >> (8 * i));
+  }
+  return bytes_;
+}
+
+/* ---------------------------------------------------------------------------
+ * delta_decoder
+ */
+
+delta_decoder::delta_decoder(const uint8_t* data, std::size_t size) : data_(data) {
+  if (size < kHeaderSize) {
+    throw std::invalid_argument(fmt::format("delta_decoder: Stream too short: {} bytes", size));
+  }
+  uint64_t count = 0;
+  for (std::size_t i = 0; i < kHeaderSize; ++i) {
+    count |= static_cast<uint64_t>(data[i]) << (8 * i);
+  }
+  bits_ = (size - kHeaderSize) * 8;
+  pos_ = kHeaderSize * 8;
+  bits_ += pos_;
+
+  /* 第一个值64位，之后每个值至少1位 */
+  if (count != 0 && (bits_ - pos_ < 64 || count - 1 > bits_ - pos_ - 64)) {
+    throw std::invalid_argument(
+        fmt::format("delta_decoder: {} bytes cannot hold {} values", size, count));
+  }
+  count_ = static_cast<std::size_t>(count);
+}
+
+uint64_t delta_decoder::peek() const {
+  std::size_t byte = pos_ >> 3;
+  int shift = static_cast<int>(pos_ & 7);
+  std::size_t size = bits_ >> 3;
+  uint64_t w;
+  uint8_t extra;
+  if (byte + 9 <= size) {
+    w = load_be64(data_ + byte);
+    extra = data_[byte + 8];
+  } else {
+    /* 截断报错后pos_停在数据之后，再次调用时读到0，随后的skip仍然报错 */
+    uint8_t buf[9] = {};
+    if (byte < size) {
+      std::memcpy(buf, data_ + byte, std::min<std::size_t>(size - byte, 9));
+    }
+    w = load_be64(buf);
+    extra = buf[8];
+  }
+  return shift == 0 ? w : (w << shift) | (extra >> (8 - shift));
+}
+
+void delta_decoder::skip(int n) {
+  pos_ += n;
+  if (pos_ > bits_) {
+    throw std::invalid_argument("delta_decoder: Truncated stream");
+  }
+}
+
+long long delta_decoder::decode_one() {
+  uint64_t w = peek();
+  if (index_ == 0) {
+    skip(64);
+    prev_ = w;
+    return static_cast<long long>(w);
+  }
+
+  int ones = std::min(std::countl_one(w), 5);
+  uint64_t z;
+  if (ones == 0) {
+    skip(1);
+    z = 0;
+  } else if (ones < 5) {
+    int width = kPayloadBits[ones];
+    z = (w >> (64 - (ones + 1) - width)) & ((uint64_t{1} << width) - 1);
+    skip(ones + 1 + width);
+  } else {
+    skip(5);
+    z = peek();
+    skip(64);
+  }
+
+  prev_delta_ += unzigzag(z);
+  prev_ += prev_delta_;
+  return static_cast<long long>(prev_);
+}
+
+bool delta_decoder::next(long long* timestamp) {
+  if (index_ == count_) {
+    return false;
+  }
+  *timestamp = decode_one();
+  ++index_;
+  return true;
+}
+
+bool delta_decoder::next(::datetime::datetime* dt) {
+  long long us;
+  if (!next(&us)) {
+    return false;
+  }
+  *dt = ::datetime::datetime::utcfromtimestamp(std::chrono::microseconds{us});
+  return true;
+}
+
+std::size_t delta_decoder::next(long long* out, std::size_t n) {
+  n = std::min(n, count_ - index_);
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i] = decode_one();
+    ++index_;
+  }
+  return n;
+}
+
+}  // namespace datetime
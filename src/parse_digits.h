@@ -0,0 +1,79 @@
+#pragma once
+
+// 定长数字字段的解析，只在库内部使用，放在头文件中以便测试直接与逐字符的解析比较
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace datetime::detail {
+
+/* 把p开始的N个字节依次放在整数的低位，第一个字节在最低位。
+ * 只使用1/2/4/8字节的加载再拼接，避免先写入部分字节再整体读取导致store forwarding失败
+ */
+template <int N>
+inline uint64_t load_bytes(const char* p) {
+  if constexpr (N == 1) {
+    return static_cast<uint8_t>(p[0]);
+  } else if constexpr (std::endian::native == std::endian::little && (N & (N - 1)) == 0) {
+    std::conditional_t<N == 2, uint16_t, std::conditional_t<N == 4, uint32_t, uint64_t>> v;
+    std::memcpy(&v, p, N);
+    return v;
+  } else {
+    constexpr int kLow = N > 4 ? 4 : N > 2 ? 2 : 1;
+    return load_bytes<kLow>(p) | (load_bytes<N - kLow>(p + kLow) << (8 * kLow));
+  }
+}
+
+/* 在一个整数中同时检查并转换N(<=8)个ASCII数字(SWAR)。
+ * 3-4位用32位整数，7-8位用64位整数，把N个字节放在高位，低位补'0'，这样补的'0'相当于前导的0：
+ *   1. 每个字节的高4位为3，且加6后高4位仍为3，即在'0'-'9'之间
+ *   2. 相邻的数字两两合并为0-99，再合并为0-9999，最后合并为8位数，每一步一次乘法
+ * 5-6位拆成互不依赖的4位和1-2位，比3次连续的乘法延迟更低；不超过2位时逐个字符转换更快
+ */
+template <int N>
+inline bool parse_digits(const char* p, int* value) {
+  static_assert(N >= 1 && N <= 8);
+  if constexpr (N <= 2) {
+    int v = 0;
+    for (int i = 0; i < N; ++i) {
+      unsigned d = static_cast<unsigned char>(p[i]) - '0';
+      if (d > 9) {
+        return false;
+      }
+      v = v * 10 + static_cast<int>(d);
+    }
+    *value = v;
+    return true;
+  } else if constexpr (N == 5 || N == 6) {
+    int high, low;
+    if (!(parse_digits<4>(p, &high) & parse_digits<N - 4>(p + 4, &low))) {
+      return false;
+    }
+    *value = high * (N == 5 ? 10 : 100) + low;
+    return true;
+  } else {
+    using word = std::conditional_t<N <= 4, uint32_t, uint64_t>;
+    constexpr int kWidth = sizeof(word);
+    constexpr word kOnes = static_cast<word>(0x0101010101010101ULL);
+    word v = static_cast<word>(load_bytes<N>(p));
+    if constexpr (N < kWidth) {
+      v = (v << (8 * (kWidth - N))) | ((kOnes * 0x30) >> (8 * N));
+    }
+    word high = v & (kOnes * 0xf0);
+    word plus6 = (v + kOnes * 0x06) & (kOnes * 0xf0);
+    if ((high | (plus6 >> 4)) != kOnes * 0x33) {
+      return false;
+    }
+    v = ((v & (kOnes * 0x0f)) * 2561) >> 8;
+    v = ((v & static_cast<word>(0x00ff00ff00ff00ffULL)) * 6553601) >> 16;
+    if constexpr (kWidth == 8) {
+      v = ((v & 0x0000ffff0000ffffULL) * 42949672960001ULL) >> 32;
+    }
+    *value = static_cast<int>(v);
+    return true;
+  }
+}
+
+}  // namespace datetime::detail
@@ -0,0 +1,166 @@
+#include "resampler.h"
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+
+#include "fmt/format.h"
+
+namespace datetime {
+
+static constexpr long long kUsPerSecond = 1000000LL;
+static constexpr long long kUsPerDay = kUsPerSecond * 24 * 3600;
+
+/* floor(x / y) for y > 0 */
+static inline long long floor_div(long long x, long long y) {
+  long long q = x / y;
+  if (x - q * y < 0) {
+    --q;
+  }
+  return q;
+}
+
+static inline long long time_to_us(const ::datetime::time& t) {
+  return ((t.hour() * 60LL + t.minute()) * 60 + t.second()) * kUsPerSecond + t.microsecond();
+}
+
+static inline bool overlapped(long long a, long long la, long long b, long long lb) {
+  return a < b + lb && b < a + la;
+}
+
+static void reset_bucket(ResampleBucket* bucket) {
+  bucket->start = LLONG_MAX;
+  bucket->end = LLONG_MIN;
+  bucket->count = 0;
+}
+
+::datetime::datetime ResampleBucket::start_time() const {
+  return ::datetime::datetime::utcfromtimestamp(std::chrono::microseconds{start});
+}
+
+::datetime::datetime ResampleBucket::end_time() const {
+  return ::datetime::datetime::utcfromtimestamp(std::chrono::microseconds{end});
+}
+
+resampler::resampler(const timedelta& interval)
+    : interval_(interval.total_microseconds()), watermark_(LLONG_MIN) {
+  if (interval_ <= 0) {
+    throw std::invalid_argument(
+        fmt::format("resampler: interval must be positive: {}", interval.str()));
+  }
+  reset_bucket(&current_);
+  reset_bucket(&closed_);
+}
+
+void resampler::add_session(const ::datetime::time& open, const ::datetime::time& close) {
+  long long o = time_to_us(open);
+  long long c = time_to_us(close);
+  long long length = c > o ? c - o : c - o + kUsPerDay;
+
+  for (const auto& s : sessions_) {
+    if (overlapped(o, length, s.open, s.length) ||
+        overlapped(o, length, s.open - kUsPerDay, s.length) ||
+        overlapped(o, length, s.open + kUsPerDay, s.length)) {
+      throw std::invalid_argument(fmt::format("resampler::add_session: Session [{}, {}) overlaps",
+                                              open.isoformat(), close.isoformat()));
+    }
+  }
+
+  auto it = std::upper_bound(sessions_.begin(), sessions_.end(), o,
+                             [](long long v, const Session& s) { return v < s.open; });
+  sessions_.insert(it, Session{o, length});
+}
+
+bool resampler::locate(long long timestamp, long long* start, long long* end) const {
+  long long day = floor_div(timestamp, kUsPerDay) * kUsPerDay;
+
+  if (sessions_.empty()) {
+    if (interval_ >= kUsPerDay) {
+      *start = floor_div(timestamp, interval_) * interval_;
+      *end = *start + interval_;
+    } else {
+      long long offset = timestamp - day;
+      *start = timestamp - offset % interval_;
+      *end = std::min(*start + interval_, day + kUsPerDay);
+    }
+    return true;
+  }
+
+  // 夜盘时段可能属于前一天
+  for (long long base : {day, day - kUsPerDay}) {
+    for (const auto& s : sessions_) {
+      long long open = base + s.open;
+      long long close = open + s.length;
+      if (timestamp >= open && timestamp < close) {
+        long long offset = timestamp - open;
+        *start = timestamp - offset % interval_;
+        *end = std::min(*start + interval_, close);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void resampler::close_current() {
+  closed_ = current_;
+  watermark_ = current_.end;
+  reset_bucket(&current_);
+}
+
+bool resampler::update(long long timestamp, double value) {
+  if (timestamp >= current_.start && timestamp < current_.end) {
+    current_.last = value;
+    current_.min = std::min(current_.min, value);
+    current_.max = std::max(current_.max, value);
+    current_.sum += value;
+    ++current_.count;
+    return false;
+  }
+
+  if (timestamp < watermark_ || (current_.count != 0 && timestamp < current_.start)) {
+    ++dropped_;
+    return false;
+  }
+
+  bool closed = false;
+  if (current_.count != 0) {
+    close_current();
+    closed = true;
+  }
+
+  long long start;
+  long long end;
+  if (!locate(timestamp, &start, &end)) {
+    ++dropped_;
+    return closed;
+  }
+
+  current_.start = start;
+  current_.end = end;
+  current_.first = value;
+  current_.last = value;
+  current_.min = value;
+  current_.max = value;
+  current_.sum = value;
+  current_.count = 1;
+  return closed;
+}
+
+bool resampler::advance(long long timestamp) {
+  if (current_.count != 0 && timestamp >= current_.end) {
+    close_current();
+    return true;
+  }
+  return false;
+}
+
+bool resampler::flush() {
+  if (current_.count != 0) {
+    close_current();
+    return true;
+  }
+  return false;
+}
+
+}  // namespace datetime
@@ -0,0 +1,281 @@
+#include "schedule.h"
+
+#include <bit>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+#include "fmt/format.h"
+
+namespace datetime {
+
+static const char* kMonthNames[] = {"JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+                                    "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"};
+
+static const char* kWeekdayNames[] = {"SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT"};
+
+/* 第一个 >= from 的置位，没有则返回-1 */
+static inline int next_bit(uint64_t mask, int from) {
+  if (from >= 64) {
+    return -1;
+  }
+  mask >>= from;
+  return mask ? from + std::countr_zero(mask) : -1;
+}
+
+static int parse_value(const std::string& str, const char* const* names, int num_names,
+                       int name_base) {
+  if (names && str.size() == 3 && std::isalpha(static_cast<unsigned char>(str[0]))) {
+    for (int i = 0; i < num_names; ++i) {
+      bool equal = true;
+      for (int j = 0; j < 3; ++j) {
+        equal &= std::toupper(static_cast<unsigned char>(str[j])) == names[i][j];
+      }
+      if (equal) {
+        return i + name_base;
+      }
+    }
+    return -1;
+  }
+
+  if (str.empty() || str.size() > 2) {
+    return -1;
+  }
+  int value = 0;
+  for (char c : str) {
+    if (!std::isdigit(static_cast<unsigned char>(c))) {
+      return -1;
+    }
+    value = value * 10 + (c - '0');
+  }
+  return value;
+}
+
+/* 解析一个字段，成功返回true，第v位表示值v */
+static bool parse_field(const std::string& field, int lo, int hi, const char* const* names,
+                        int num_names, int name_base, uint64_t* mask) {
+  std::size_t begin = 0;
+  while (begin <= field.size()) {
+    std::size_t end = field.find(',', begin);
+    if (end == std::string::npos) {
+      end = field.size();
+    }
+    std::string item = field.substr(begin, end - begin);
+    begin = end + 1;
+
+    int step = 1;
+    std::size_t slash = item.find('/');
+    if (slash != std::string::npos) {
+      step = parse_value(item.substr(slash + 1), nullptr, 0, 0);
+      if (step <= 0) {
+        return false;
+      }
+      item.erase(slash);
+    }
+
+    int first;
+    int last;
+    if (item == "*") {
+      first = lo;
+      last = hi;
+    } else {
+      std::size_t dash = item.find('-');
+      first = parse_value(item.substr(0, dash), names, num_names, name_base);
+      if (dash != std::string::npos) {
+        last = parse_value(item.substr(dash + 1), names, num_names, name_base);
+      } else {
+        last = slash != std::string::npos ? hi : first;
+      }
+    }
+
+    if (first < lo || last > hi || first > last) {
+      return false;
+    }
+    for (int v = first; v <= last; v += step) {
+      *mask |= uint64_t{1} << v;
+    }
+  }
+  return true;
+}
+
+schedule::schedule(const std::string& expr) {
+  std::string e = expr;
+  if (e == "@yearly" || e == "@annually") {
+    e = "0 0 1 1 *";
+  } else if (e == "@monthly") {
+    e = "0 0 1 * *";
+  } else if (e == "@weekly") {
+    e = "0 0 * * 0";
+  } else if (e == "@daily" || e == "@midnight") {
+    e = "0 0 * * *";
+  } else if (e == "@hourly") {
+    e = "0 * * * *";
+  }
+
+  std::istringstream iss(e);
+  std::string fields[5];
+  for (auto& field : fields) {
+    iss >> field;
+  }
+  std::string extra;
+  iss >> extra;
+
+  uint64_t minutes = 0;
+  uint64_t hours = 0;
+  uint64_t days = 0;
+  uint64_t months = 0;
+  uint64_t weekdays = 0;
+  if (fields[4].empty() || !extra.empty() ||
+      !parse_field(fields[0], 0, 59, nullptr, 0, 0, &minutes) ||
+      !parse_field(fields[1], 0, 23, nullptr, 0, 0, &hours) ||
+      !parse_field(fields[2], 1, 31, nullptr, 0, 0, &days) ||
+      !parse_field(fields[3], 1, 12, kMonthNames, 12, 1, &months) ||
+      !parse_field(fields[4], 0, 7, kWeekdayNames, 7, 0, &weekdays)) {
+    throw std::invalid_argument(fmt::format("schedule: Invalid cron expression: {}", expr));
+  }
+  /* 7也表示星期日 */
+  if (weekdays & (1 << 7)) {
+    weekdays = (weekdays | 1) & 0x7f;
+  }
+
+  minutes_ = minutes;
+  hours_ = static_cast<uint32_t>(hours);
+  days_ = static_cast<uint32_t>(days);
+  months_ = static_cast<uint16_t>(months);
+  weekdays_ = static_cast<uint8_t>(weekdays);
+  days_restricted_ = fields[2][0] != '*';
+  weekdays_restricted_ = fields[4][0] != '*';
+
+  /* 只限制了日时，所选的日必须在所选的某个月中存在 */
+  if (!weekdays_restricted_) {
+    bool feasible = false;
+    for (int m = 1; m <= 12; ++m) {
+      if ((months_ >> m) & 1) {
+        feasible |= next_bit(days_, 1) <= days_in_month(2000, m);
+      }
+    }
+    if (!feasible) {
+      throw std::invalid_argument(fmt::format("schedule: Cron expression never fires: {}", expr));
+    }
+  }
+}
+
+uint32_t schedule::day_mask(int year, int month) const {
+  int dim = days_in_month(year, month);
+  uint32_t valid = ((uint32_t{1} << dim) - 1) << 1;
+  if (!weekdays_restricted_) {
+    return days_ & valid;
+  }
+
+  /* 把以1日的星期为起点的7天掩码重复5次，第d位表示d日 */
+  int first = (::datetime::weekday(year, month, 1) + 1) % 7;
+  uint64_t week = ((weekdays_ >> first) | (weekdays_ << (7 - first))) & 0x7f;
+  uint64_t pattern = week * ((1 << 0) | (1 << 7) | (1 << 14) | (1 << 21) | (1 << 28));
+  uint32_t mask = static_cast<uint32_t>(pattern << 1);
+
+  if (days_restricted_) {
+    mask |= days_;
+  }
+  return mask & valid;
+}
+
+bool schedule::next_after(int* year, int* month, int* day, int* hour, int* minute) const {
+  while (*year <= kMaxYear) {
+    int m = next_bit(months_, *month);
+    if (m < 0) {
+      ++*year;
+      *month = 1;
+      *day = 1;
+      *hour = 0;
+      *minute = 0;
+      continue;
+    }
+    if (m != *month) {
+      *month = m;
+      *day = 1;
+      *hour = 0;
+      *minute = 0;
+    }
+
+    int d = next_bit(day_mask(*year, *month), *day);
+    if (d < 0) {
+      ++*month;
+      *day = 1;
+      *hour = 0;
+      *minute = 0;
+      continue;
+    }
+    if (d != *day) {
+      *day = d;
+      *hour = 0;
+      *minute = 0;
+    }
+
+    int h = next_bit(hours_, *hour);
+    if (h < 0) {
+      ++*day;
+      *hour = 0;
+      *minute = 0;
+      continue;
+    }
+    if (h != *hour) {
+      *hour = h;
+      *minute = 0;
+    }
+
+    int min = next_bit(minutes_, *minute);
+    if (min < 0) {
+      ++*hour;
+      *minute = 0;
+      continue;
+    }
+    *minute = min;
+    return true;
+  }
+  return false;
+}
+
+::datetime::datetime schedule::next_after(const ::datetime::datetime& dt) const {
+  int y = dt.year();
+  int m = dt.month();
+  int d = dt.day();
+  int h = dt.hour();
+  int min = dt.minute() + 1;
+  if (!next_after(&y, &m, &d, &h, &min)) {
+    throw std::out_of_range(fmt::format("schedule::next_after: No fire time after {}", dt.str()));
+  }
+  /* next_after只会得到合法的字段 */
+  return ::datetime::datetime(y, m, d, h, min, 0, 0, detail::NonCheckTag{});
+}
+
+std::vector<::datetime::datetime> schedule::next_after(const std::vector<schedule>& schedules,
+                                                        const ::datetime::datetime& dt) {
+  std::vector<::datetime::datetime> result;
+  result.reserve(schedules.size());
+
+  const int year = dt.year();
+  const int month = dt.month();
+  const int day = dt.day();
+  const int hour = dt.hour();
+  const int minute = dt.minute() + 1;
+  for (const auto& s : schedules) {
+    int y = year;
+    int m = month;
+    int d = day;
+    int h = hour;
+    int min = minute;
+    if (!s.next_after(&y, &m, &d, &h, &min)) {
+      throw std::out_of_range(
+          fmt::format("schedule::next_after: No fire time after {}", dt.str()));
+    }
+    result.emplace_back(y, m, d, h, min, 0, 0, detail::NonCheckTag{});
+  }
+  return result;
+}
+
+bool schedule::matches(const ::datetime::datetime& dt) const {
+  return ((minutes_ >> dt.minute()) & 1) && ((hours_ >> dt.hour()) & 1) &&
+         ((months_ >> dt.month()) & 1) && ((day_mask(dt.year(), dt.month()) >> dt.day()) & 1);
+}
+
+}  // namespace datetime
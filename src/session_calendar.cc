@@ -0,0 +1,112 @@
+#include "session_calendar.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "fmt/format.h"
+
+namespace datetime {
+
+static constexpr long long kUsPerSecond = 1000000LL;
+static constexpr long long kUsPerDay = kUsPerSecond * 24 * 3600;
+
+static inline long long time_to_us(const ::datetime::time& t) {
+  return ((t.hour() * 60LL + t.minute()) * 60 + t.second()) * kUsPerSecond + t.microsecond();
+}
+
+session_calendar::session_calendar(const date& first, const date& last,
+                                   const std::vector<TradingSession>& sessions)
+    : session_calendar(first, last, sessions, nullptr) {}
+
+session_calendar::session_calendar(const date& first, const date& last,
+                                   const std::vector<TradingSession>& sessions,
+                                   const business_calendar& calendar)
+    : session_calendar(first, last, sessions, &calendar) {}
+
+session_calendar::session_calendar(const date& first, const date& last,
+                                   const std::vector<TradingSession>& sessions,
+                                   const business_calendar* calendar) {
+  if (last < first) {
+    throw std::invalid_argument(fmt::format("session_calendar: Invalid date range: [{}, {}]",
+                                            first.isoformat(), last.isoformat()));
+  }
+
+  /* 每日时段相对于0点的偏移，按开始时间排序 */
+  std::vector<std::pair<long long, long long>> daily;
+  for (const auto& s : sessions) {
+    long long open = time_to_us(s.open);
+    long long close = time_to_us(s.close);
+    daily.emplace_back(open, close > open ? close : close + kUsPerDay);
+  }
+  std::sort(daily.begin(), daily.end());
+
+  long long day = ::datetime::datetime::combine(first, ::datetime::time()).utctimestamp().count();
+  for (int ordinal = first.toordinal(); ordinal <= last.toordinal(); ++ordinal, day += kUsPerDay) {
+    if (calendar && !calendar->is_business_day(date::fromordinal(ordinal))) {
+      continue;
+    }
+    for (const auto& [open, close] : daily) {
+      if (!closes_.empty() && closes_.back() > day + open) {
+        throw std::invalid_argument(fmt::format(
+            "session_calendar: Overlapped sessions at {}", date::fromordinal(ordinal).isoformat()));
+      }
+      opens_.push_back(day + open);
+      closes_.push_back(day + close);
+    }
+  }
+
+  elapsed_.resize(opens_.size());
+  long long total = 0;
+  for (std::size_t i = 0; i < opens_.size(); ++i) {
+    elapsed_[i] = total;
+    total += closes_[i] - opens_[i];
+  }
+}
+
+long session_calendar::find(long long t) const {
+  return static_cast<long>(std::upper_bound(opens_.begin(), opens_.end(), t) - opens_.begin()) - 1;
+}
+
+long long session_calendar::elapsed(long long t) const {
+  long i = find(t);
+  if (i < 0) {
+    return 0;
+  }
+  return elapsed_[i] + std::min(t - opens_[i], closes_[i] - opens_[i]);
+}
+
+bool session_calendar::in_session(const ::datetime::datetime& dt) const {
+  long long t = dt.utctimestamp().count();
+  long i = find(t);
+  return i >= 0 && t < closes_[i];
+}
+
+::datetime::datetime session_calendar::next_open(const ::datetime::datetime& dt) const {
+  std::size_t i = find(dt.utctimestamp().count()) + 1;
+  if (i >= opens_.size()) {
+    throw std::out_of_range(
+        fmt::format("session_calendar::next_open: No session after {}", dt.str()));
+  }
+  return ::datetime::datetime::utcfromtimestamp(std::chrono::microseconds{opens_[i]});
+}
+
+::datetime::datetime session_calendar::next_close(const ::datetime::datetime& dt) const {
+  long long t = dt.utctimestamp().count();
+  long i = find(t);
+  if (i < 0 || t >= closes_[i]) {
+    ++i;
+  }
+  if (static_cast<std::size_t>(i) >= closes_.size()) {
+    throw std::out_of_range(
+        fmt::format("session_calendar::next_close: No session after {}", dt.str()));
+  }
+  return ::datetime::datetime::utcfromtimestamp(std::chrono::microseconds{closes_[i]});
+}
+
+timedelta session_calendar::trading_time_between(const ::datetime::datetime& begin,
+                                                 const ::datetime::datetime& end) const {
+  long long us = elapsed(end.utctimestamp().count()) - elapsed(begin.utctimestamp().count());
+  return timedelta(std::chrono::microseconds{us});
+}
+
+}  // namespace datetime
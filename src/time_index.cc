@@ -0,0 +1,213 @@
+#include "time_index.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "fmt/format.h"
+
+namespace datetime {
+
+static constexpr char kMagic[8] = {'D', 'T', 'I', 'N', 'D', 'E', 'X', '1'};
+static constexpr std::size_t kHeaderSize = 24;
+
+static void store_le64(uint8_t* p, uint64_t v) {
+  for (int i = 0; i < 8; ++i) {
+    p[i] = static_cast<uint8_t>(v >> (8 * i));
+  }
+}
+
+/* ---------------------------------------------------------------------------
+ * time_index_writer
+ */
+
+time_index_writer::time_index_writer(const std::string& path, uint64_t block_size)
+    : path_(path), file_(std::fopen(path.c_str(), "wb")), block_size_(block_size) {
+  if (file_ == nullptr) {
+    throw std::runtime_error(fmt::format("time_index_writer: Failed to open {}: {}", path,
+                                         std::strerror(errno)));
+  }
+  /* 头部在close时写入 */
+  uint8_t header[kHeaderSize] = {};
+  if (std::fwrite(header, 1, sizeof(header), file_) != sizeof(header)) {
+    std::fclose(file_);
+    throw std::runtime_error(fmt::format("time_index_writer: Failed to write {}", path));
+  }
+}
+
+time_index_writer::~time_index_writer() {
+  if (file_ != nullptr) {
+    try {
+      close();
+    } catch (const std::exception&) {
+    }
+  }
+}
+
+void time_index_writer::add(long long timestamp, uint64_t offset) {
+  if (records_ != 0 && (timestamp < last_timestamp_ || offset < last_offset_)) {
+    throw std::invalid_argument(fmt::format(
+        "time_index_writer: Records must be in order: ({}, {}) after ({}, {})", timestamp, offset,
+        last_timestamp_, last_offset_));
+  }
+
+  if (records_ == 0 || offset - block_offset_ >= block_size_) {
+    uint8_t entry[16];
+    store_le64(entry, static_cast<uint64_t>(timestamp));
+    store_le64(entry + 8, offset);
+    if (std::fwrite(entry, 1, sizeof(entry), file_) != sizeof(entry)) {
+      throw std::runtime_error(fmt::format("time_index_writer: Failed to write {}", path_));
+    }
+    block_offset_ = offset;
+    ++count_;
+  }
+  last_timestamp_ = timestamp;
+  last_offset_ = offset;
+  ++records_;
+}
+
+void time_index_writer::close() {
+  if (file_ == nullptr) {
+    return;
+  }
+  uint8_t header[kHeaderSize];
+  std::memcpy(header, kMagic, sizeof(kMagic));
+  store_le64(header + 8, block_size_);
+  store_le64(header + 16, count_);
+
+  bool ok = std::fseek(file_, 0, SEEK_SET) == 0 &&
+            std::fwrite(header, 1, sizeof(header), file_) == sizeof(header);
+  ok = std::fclose(file_) == 0 && ok;
+  file_ = nullptr;
+  if (!ok) {
+    throw std::runtime_error(fmt::format("time_index_writer: Failed to write {}", path_));
+  }
+}
+
+/* ---------------------------------------------------------------------------
+ * time_index
+ */
+
+time_index::time_index(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error(
+        fmt::format("time_index: Failed to open {}: {}", path, std::strerror(errno)));
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    int err = errno;
+    ::close(fd);
+    throw std::runtime_error(fmt::format("time_index: Failed to stat {}: {}", path,
+                                         std::strerror(err)));
+  }
+  map_size_ = static_cast<std::size_t>(st.st_size);
+  if (map_size_ < kHeaderSize) {
+    ::close(fd);
+    throw std::invalid_argument(fmt::format("time_index: {} is not an index file", path));
+  }
+
+  map_ = ::mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd, 0);
+  int err = errno;
+  ::close(fd);
+  if (map_ == MAP_FAILED) {
+    map_ = nullptr;
+    throw std::runtime_error(
+        fmt::format("time_index: Failed to mmap {}: {}", path, std::strerror(err)));
+  }
+
+  const uint8_t* base = static_cast<const uint8_t*>(map_);
+  uint64_t count = static_cast<uint64_t>(detail::load_le64(base + 16));
+  if (std::memcmp(base, kMagic, sizeof(kMagic)) != 0 ||
+      count != (map_size_ - kHeaderSize) / kEntrySize ||
+      (map_size_ - kHeaderSize) % kEntrySize != 0) {
+    unmap();
+    throw std::invalid_argument(fmt::format("time_index: {} is not an index file", path));
+  }
+  block_size_ = static_cast<uint64_t>(detail::load_le64(base + 8));
+  count_ = static_cast<std::size_t>(count);
+  entries_ = base + kHeaderSize;
+}
+
+time_index::~time_index() { unmap(); }
+
+time_index::time_index(time_index&& other) noexcept
+    : map_(std::exchange(other.map_, nullptr)),
+      map_size_(std::exchange(other.map_size_, 0)),
+      entries_(std::exchange(other.entries_, nullptr)),
+      count_(std::exchange(other.count_, 0)),
+      block_size_(other.block_size_) {}
+
+time_index& time_index::operator=(time_index&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    map_ = std::exchange(other.map_, nullptr);
+    map_size_ = std::exchange(other.map_size_, 0);
+    entries_ = std::exchange(other.entries_, nullptr);
+    count_ = std::exchange(other.count_, 0);
+    block_size_ = other.block_size_;
+  }
+  return *this;
+}
+
+void time_index::unmap() {
+  if (map_ != nullptr) {
+    ::munmap(map_, map_size_);
+    map_ = nullptr;
+  }
+  entries_ = nullptr;
+  count_ = 0;
+}
+
+std::size_t time_index::lower_bound(long long ts) const {
+  /* 不变式：[0, lo)都早于ts，[hi, count_)都不早于ts */
+  std::size_t lo = 0;
+  std::size_t hi = count_;
+  bool interpolate = true;
+  while (hi - lo > 8) {
+    std::size_t mid;
+    if (interpolate) {
+      long long first = timestamp(lo);
+      long long last = timestamp(hi - 1);
+      if (ts <= first) {
+        return lo;
+      }
+      if (ts > last) {
+        return hi;
+      }
+      long double ratio = (static_cast<long double>(ts) - first) /
+                          (static_cast<long double>(last) - first);
+      mid = lo + static_cast<std::size_t>(ratio * (hi - 1 - lo));
+    } else {
+      mid = lo + (hi - lo) / 2;
+    }
+    interpolate = !interpolate;
+
+    if (timestamp(mid) < ts) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  while (lo < hi && timestamp(lo) < ts) {
+    ++lo;
+  }
+  return lo;
+}
+
+uint64_t time_index::seek(long long ts) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  /* 时间相同的记录可能跨越块的边界，所以从最后一个起始时间早于ts的块开始 */
+  std::size_t i = lower_bound(ts);
+  return offset(i == 0 ? 0 : i - 1);
+}
+
+}  // namespace datetime
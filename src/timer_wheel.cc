@@ -0,0 +1,196 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <stdexcept>
+
+#include "fmt/format.h"
+
+namespace datetime {
+
+timer_wheel::timer_wheel(const ::datetime::datetime& start, const timedelta& resolution)
+    : start_(start.utctimestamp().count()), resolution_(resolution.total_microseconds()) {
+  if (resolution_ <= 0) {
+    throw std::invalid_argument(
+        fmt::format("timer_wheel: resolution must be positive: {}", resolution.str()));
+  }
+  std::fill(std::begin(heads_), std::end(heads_), kNil);
+}
+
+timer_wheel::timer_id timer_wheel::add(const ::datetime::datetime& deadline, uint64_t data) {
+  long long us = deadline.utctimestamp().count() - start_;
+  uint64_t expire = us <= 0 ? 0 : (us + resolution_ - 1) / resolution_;
+  return add_tick(expire, data);
+}
+
+timer_wheel::timer_id timer_wheel::add(const timedelta& timeout, uint64_t data) {
+  long long us = timeout.total_microseconds();
+  uint64_t expire = us <= 0 ? 0 : now_ + (us + resolution_ - 1) / resolution_;
+  return add_tick(expire, data);
+}
+
+timer_wheel::timer_id timer_wheel::add_tick(uint64_t expire, uint64_t data) {
+  uint32_t index;
+  if (free_ != kNil) {
+    index = free_;
+    free_ = nodes_[index].next;
+  } else {
+    index = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back(Node{0, 0, kNil, kNil, kNil, 0});
+  }
+
+  auto& node = nodes_[index];
+  node.expire = std::max(expire, now_ + 1);
+  node.data = data;
+  place(index);
+  ++size_;
+  return (static_cast<uint64_t>(node.generation) << 32) | index;
+}
+
+bool timer_wheel::cancel(timer_id id) {
+  uint32_t index = static_cast<uint32_t>(id);
+  uint32_t generation = static_cast<uint32_t>(id >> 32);
+  if (index >= nodes_.size() || nodes_[index].generation != generation ||
+      nodes_[index].slot == kNil) {
+    return false;
+  }
+  unlink(index);
+  release(index);
+  return true;
+}
+
+void timer_wheel::place(uint32_t index) {
+  uint64_t expire = nodes_[index].expire;
+  assert(expire >= now_);
+  uint64_t delta = expire - now_;
+
+  int level = 0;
+  while (level < kLevels - 1 && delta >= (uint64_t{1} << (kSlotBits * (level + 1)))) {
+    ++level;
+  }
+  if (delta >= (uint64_t{1} << (kSlotBits * kLevels))) {
+    /* 超出范围，先放在最高层最远的槽，轮转到时再重新放置 */
+    expire = now_ + (uint64_t{1} << (kSlotBits * kLevels)) - 1;
+  }
+
+  uint32_t slot = level * kSlots + ((expire >> (kSlotBits * level)) & (kSlots - 1));
+  link(index, slot);
+}
+
+void timer_wheel::link(uint32_t index, uint32_t slot) {
+  auto& node = nodes_[index];
+  node.slot = slot;
+  node.prev = kNil;
+  node.next = heads_[slot];
+  if (node.next != kNil) {
+    nodes_[node.next].prev = index;
+  }
+  heads_[slot] = index;
+  occupied_[slot >> 6] |= uint64_t{1} << (slot & 63);
+}
+
+void timer_wheel::unlink(uint32_t index) {
+  auto& node = nodes_[index];
+  if (node.prev != kNil) {
+    nodes_[node.prev].next = node.next;
+  } else {
+    heads_[node.slot] = node.next;
+  }
+  if (node.next != kNil) {
+    nodes_[node.next].prev = node.prev;
+  }
+  if (heads_[node.slot] == kNil) {
+    occupied_[node.slot >> 6] &= ~(uint64_t{1} << (node.slot & 63));
+  }
+}
+
+uint32_t timer_wheel::take(uint32_t slot) {
+  uint32_t head = heads_[slot];
+  heads_[slot] = kNil;
+  occupied_[slot >> 6] &= ~(uint64_t{1} << (slot & 63));
+  return head;
+}
+
+void timer_wheel::release(uint32_t index) {
+  auto& node = nodes_[index];
+  node.slot = kNil;
+  ++node.generation;
+  node.next = free_;
+  free_ = index;
+  --size_;
+}
+
+void timer_wheel::cascade(int level) {
+  uint32_t slot = level * kSlots + ((now_ >> (kSlotBits * level)) & (kSlots - 1));
+  uint32_t index = take(slot);
+  while (index != kNil) {
+    uint32_t next = nodes_[index].next;
+    place(index);
+    index = next;
+  }
+}
+
+void timer_wheel::tick(std::vector<uint64_t>* expired) {
+  ++now_;
+  if ((now_ & (kSlots - 1)) == 0) {
+    /* 从最高的需要轮转的层开始逐层向下放置 */
+    int level = 1;
+    while (level < kLevels - 1 && ((now_ >> (kSlotBits * level)) & (kSlots - 1)) == 0) {
+      ++level;
+    }
+    for (; level >= 1; --level) {
+      cascade(level);
+    }
+  }
+
+  uint32_t index = take(now_ & (kSlots - 1));
+  while (index != kNil) {
+    uint32_t next = nodes_[index].next;
+    expired->push_back(nodes_[index].data);
+    release(index);
+    index = next;
+  }
+}
+
+uint64_t timer_wheel::next_occupied() const {
+  uint64_t base = now_ & ~static_cast<uint64_t>(kSlots - 1);
+  int pos = static_cast<int>(now_ & (kSlots - 1)) + 1;
+  for (int w = pos >> 6; w < kSlots / 64; ++w) {
+    uint64_t bits = occupied_[w];
+    if (w == pos >> 6) {
+      bits &= ~uint64_t{0} << (pos & 63);
+    }
+    if (bits) {
+      return base + w * 64 + std::countr_zero(bits);
+    }
+  }
+  return base + kSlots;
+}
+
+std::size_t timer_wheel::advance(const ::datetime::datetime& now, std::vector<uint64_t>* expired) {
+  long long us = now.utctimestamp().count() - start_;
+  if (us <= 0) {
+    return 0;
+  }
+
+  std::size_t count = expired->size();
+  uint64_t target = us / resolution_;
+  while (now_ < target) {
+    if (size_ == 0) {
+      now_ = target;
+      break;
+    }
+    /* 跳过第0层的空槽，直到下一个非空槽或下一次轮转 */
+    now_ = std::min(next_occupied(), target) - 1;
+    tick(expired);
+  }
+  return expired->size() - count;
+}
+
+::datetime::datetime timer_wheel::current_time() const {
+  return ::datetime::datetime::utcfromtimestamp(
+      std::chrono::microseconds{start_ + static_cast<long long>(now_) * resolution_});
+}
+
+}  // namespace datetime
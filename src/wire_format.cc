@@ -0,0 +1,105 @@
+#include "wire_format.h"
+
+#include <stdexcept>
+
+#include "fmt/format.h"
+
+namespace datetime {
+
+static constexpr long long kUsPerSecond = 1000000LL;
+static constexpr long long kUsPerDay = 86400LL * kUsPerSecond;
+
+static inline void store_le32(uint8_t* p, uint32_t v) {
+  for (int i = 0; i < 4; ++i) {
+    p[i] = static_cast<uint8_t>(v >> (8 * i));
+  }
+}
+
+static inline void store_le64(uint8_t* p, uint64_t v) {
+  for (int i = 0; i < 8; ++i) {
+    p[i] = static_cast<uint8_t>(v >> (8 * i));
+  }
+}
+
+static inline int32_t load_le32(const uint8_t* p) {
+  uint32_t v = 0;
+  for (int i = 3; i >= 0; --i) {
+    v = (v << 8) | p[i];
+  }
+  return static_cast<int32_t>(v);
+}
+
+void to_bytes(const ::datetime::date& d, uint8_t* out) {
+  store_le32(out, static_cast<uint32_t>(d.toordinal()));
+}
+
+void to_bytes(const ::datetime::time& t, uint8_t* out) {
+  long long us = ((t.hour() * 60LL + t.minute()) * 60 + t.second()) * kUsPerSecond +
+                 t.microsecond();
+  store_le64(out, static_cast<uint64_t>(us));
+}
+
+void to_bytes(const ::datetime::datetime& dt, uint8_t* out) {
+  store_le64(out, static_cast<uint64_t>(dt.utctimestamp().count()));
+}
+
+void to_bytes(const timedelta& delta, uint8_t* out) {
+  store_le32(out, static_cast<uint32_t>(delta.days()));
+  store_le32(out + 4, static_cast<uint32_t>(delta.seconds()));
+  store_le32(out + 8, static_cast<uint32_t>(delta.microseconds()));
+}
+
+template <>
+::datetime::date from_bytes<::datetime::date>(const uint8_t* in) {
+  int ordinal = load_le32(in);
+  if (ordinal < 1 || ordinal > kMaxOrdinal) {
+    throw std::out_of_range(fmt::format("from_bytes<date>: Ordinal out of range: {}", ordinal));
+  }
+  return ::datetime::date::fromordinal(ordinal);
+}
+
+template <>
+::datetime::time from_bytes<::datetime::time>(const uint8_t* in) {
+  long long us = detail::load_le64(in);
+  if (us < 0 || us >= kUsPerDay) {
+    throw std::out_of_range(fmt::format("from_bytes<time>: Microseconds out of range: {}", us));
+  }
+  long long seconds = us / kUsPerSecond;
+  return ::datetime::time(static_cast<int>(seconds / 3600), static_cast<int>(seconds / 60 % 60),
+                          static_cast<int>(seconds % 60), static_cast<int>(us % kUsPerSecond),
+                          detail::NonCheckTag{});
+}
+
+template <>
+::datetime::datetime from_bytes<::datetime::datetime>(const uint8_t* in) {
+  return ::datetime::datetime::utcfromtimestamp(std::chrono::microseconds{detail::load_le64(in)});
+}
+
+template <>
+timedelta from_bytes<timedelta>(const uint8_t* in) {
+  int days = load_le32(in);
+  int seconds = load_le32(in + 4);
+  int microseconds = load_le32(in + 8);
+  if (seconds < 0 || seconds >= 86400 || microseconds < 0 || microseconds >= kUsPerSecond) {
+    throw std::out_of_range(fmt::format("from_bytes<timedelta>: Not normalized: {}, {}, {}", days,
+                                        seconds, microseconds));
+  }
+  /* days的范围由构造函数检查 */
+  return timedelta(days, seconds, microseconds);
+}
+
+template <class T>
+T from_bytes(const uint8_t* in, std::size_t size) {
+  if (size < kWireSize<T>) {
+    throw std::invalid_argument(
+        fmt::format("from_bytes: Truncated input: {} of {} bytes", size, kWireSize<T>));
+  }
+  return from_bytes<T>(in);
+}
+
+template ::datetime::date from_bytes<::datetime::date>(const uint8_t*, std::size_t);
+template ::datetime::time from_bytes<::datetime::time>(const uint8_t*, std::size_t);
+template ::datetime::datetime from_bytes<::datetime::datetime>(const uint8_t*, std::size_t);
+template timedelta from_bytes<timedelta>(const uint8_t*, std::size_t);
+
+}  // namespace datetime
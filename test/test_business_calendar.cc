@@ -0,0 +1,175 @@
+// business_calendar的工作日计数与偏移，节假日文件的加载，与逐日计数的结果比较
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "business_calendar.h"
+#include "test_check.h"
+
+using datetime::business_calendar;
+using datetime::date;
+using datetime::timedelta;
+
+/* 2024-12-25与2025-01-01均为周三 */
+static const std::vector<date> kHolidays = {date(2024, 12, 25), date(2025, 1, 1)};
+
+static void check_weekends_and_holidays() {
+  business_calendar cal(kHolidays);
+  EXPECT_TRUE(cal.is_business_day(date(2024, 12, 24)));
+  EXPECT_TRUE(!cal.is_business_day(date(2024, 12, 25)));
+  EXPECT_TRUE(!cal.is_business_day(date(2025, 1, 4)));
+  EXPECT_TRUE(!cal.is_business_day(date(2025, 1, 5)));
+  EXPECT_TRUE(cal.is_business_day(date(2025, 1, 6)));
+
+  /* 周一至周六 */
+  business_calendar six_days({}, 0x3f);
+  EXPECT_TRUE(six_days.is_business_day(date(2025, 1, 4)));
+  EXPECT_TRUE(!six_days.is_business_day(date(2025, 1, 5)));
+  EXPECT_EQ(six_days.weekmask(), 0x3f);
+
+  EXPECT_THROW(business_calendar({}, 0x80), std::invalid_argument);
+  EXPECT_THROW(business_calendar({}, -1), std::invalid_argument);
+}
+
+static void check_add_business_days() {
+  business_calendar cal(kHolidays);
+  /* 跨越节假日 */
+  EXPECT_EQ(cal.add_business_days(date(2024, 12, 20), 5), date(2024, 12, 30));
+  EXPECT_EQ(cal.add_business_days(date(2024, 12, 30), -5), date(2024, 12, 20));
+  /* 跨越年份以及元旦 */
+  EXPECT_EQ(cal.add_business_days(date(2024, 12, 30), 2), date(2025, 1, 2));
+  EXPECT_EQ(cal.add_business_days(date(2024, 12, 31), 1), date(2025, 1, 2));
+  EXPECT_EQ(cal.add_business_days(date(2025, 1, 2), -1), date(2024, 12, 31));
+  EXPECT_EQ(cal.add_business_days(date(2025, 1, 1), -1), date(2024, 12, 31));
+  EXPECT_EQ(cal.add_business_days(date(2025, 1, 1), 1), date(2025, 1, 2));
+  EXPECT_EQ(cal.add_business_days(date(2025, 1, 1), 0), date(2025, 1, 2));
+  /* 从周末开始 */
+  EXPECT_EQ(cal.add_business_days(date(2025, 1, 4), 0), date(2025, 1, 6));
+  EXPECT_EQ(cal.add_business_days(date(2025, 1, 4), 1), date(2025, 1, 6));
+  EXPECT_EQ(cal.add_business_days(date(2025, 1, 4), -1), date(2025, 1, 3));
+  EXPECT_EQ(cal.add_business_days(date(2025, 1, 6), 0), date(2025, 1, 6));
+
+  EXPECT_THROW(cal.add_business_days(date::max(), 1), std::out_of_range);
+  EXPECT_THROW(cal.add_business_days(date::min(), -1), std::out_of_range);
+  EXPECT_EQ(cal.add_business_days(date::min(), 0), date(1, 1, 1));
+}
+
+static void check_business_days_between() {
+  business_calendar cal(kHolidays);
+  /* 12-23, 24, 26, 27, 30, 31, 01-02, 03 */
+  EXPECT_EQ(cal.business_days_between(date(2024, 12, 23), date(2025, 1, 6)), 8);
+  EXPECT_EQ(cal.business_days_between(date(2025, 1, 6), date(2024, 12, 23)), -8);
+  EXPECT_EQ(cal.business_days_between(date(2025, 1, 1), date(2025, 1, 2)), 0);
+  EXPECT_EQ(cal.business_days_between(date(2025, 1, 6), date(2025, 1, 6)), 0);
+  EXPECT_EQ(cal.business_days_between(date::min(), date::max()),
+            cal.business_days_between(date::min(), date(5000, 1, 1)) +
+                cal.business_days_between(date(5000, 1, 1), date::max()));
+
+  /* 已经是节假日或周末的日期不影响计数 */
+  cal.add_holiday(date(2024, 12, 24));
+  cal.add_holiday(date(2024, 12, 24));
+  cal.add_holiday(date(2024, 12, 28));
+  EXPECT_EQ(cal.business_days_between(date(2024, 12, 23), date(2025, 1, 6)), 7);
+  EXPECT_EQ(cal.add_business_days(date(2024, 12, 23), 1), date(2024, 12, 26));
+  EXPECT_EQ(cal.add_business_days(date(2030, 1, 1), 0), date(2030, 1, 1));
+}
+
+/* 批量添加与逐个添加、构造时传入的结果相同 */
+static void check_add_holidays() {
+  std::vector<date> holidays;
+  for (date d(2020, 1, 1); d < date(2030, 1, 1); d += timedelta(13)) {
+    holidays.push_back(d);
+  }
+  /* 重复的日期和周末 */
+  holidays.push_back(date(2024, 12, 28));
+  holidays.push_back(holidays.front());
+
+  business_calendar batch(kHolidays);
+  batch.add_holidays(holidays);
+  business_calendar one_by_one(kHolidays);
+  for (const auto& d : holidays) {
+    one_by_one.add_holiday(d);
+  }
+  auto all = kHolidays;
+  all.insert(all.end(), holidays.begin(), holidays.end());
+  business_calendar constructed(all);
+  for (const auto* cal : {&batch, &one_by_one}) {
+    EXPECT_EQ(cal->business_days_between(date::min(), date::max()),
+              constructed.business_days_between(date::min(), date::max()));
+    for (date d(2019, 12, 1); d < date(2030, 2, 1); d += timedelta(1)) {
+      EXPECT_EQ(cal->is_business_day(d), constructed.is_business_day(d));
+      EXPECT_EQ(cal->business_days_between(date::min(), d),
+                constructed.business_days_between(date::min(), d));
+      EXPECT_EQ(cal->add_business_days(d, 3), constructed.add_business_days(d, 3));
+    }
+  }
+  batch.add_holidays({});
+  EXPECT_EQ(batch.business_days_between(date::min(), date::max()),
+            constructed.business_days_between(date::min(), date::max()));
+}
+
+/* 与逐日计数以及逐日移动的结果比较 */
+static void check_against_linear_scan() {
+  business_calendar cal(kHolidays);
+  const date origin(2023, 12, 1);
+  int count = 0;
+  for (date d = origin; d < date(2026, 2, 1); d += timedelta(1)) {
+    EXPECT_EQ(cal.business_days_between(origin, d), count);
+    EXPECT_EQ(cal.business_days_between(d, origin), -count);
+    count += cal.is_business_day(d);
+
+    for (int n = -12; n <= 12; ++n) {
+      date expected = d;
+      if (n > 0) {
+        for (int left = n; left > 0;) {
+          expected += timedelta(1);
+          left -= cal.is_business_day(expected);
+        }
+      } else if (n < 0) {
+        for (int left = -n; left > 0;) {
+          expected -= timedelta(1);
+          left -= cal.is_business_day(expected);
+        }
+      } else {
+        while (!cal.is_business_day(expected)) {
+          expected += timedelta(1);
+        }
+      }
+      EXPECT_EQ(cal.add_business_days(d, n), expected);
+    }
+  }
+}
+
+static void check_fromfile() {
+  auto path = std::filesystem::temp_directory_path() / "test_business_calendar_holidays.txt";
+  {
+    std::ofstream ofs(path, std::ios::binary);
+    ofs << "# holidays\n\n  2024-12-25  # Christmas\r\n\t2025-01-01\n2024-12-25\n";
+  }
+  auto cal = business_calendar::fromfile(path.string());
+  business_calendar expected(kHolidays);
+  for (date d(2024, 12, 1); d < date(2025, 2, 1); d += timedelta(1)) {
+    EXPECT_EQ(cal.is_business_day(d), expected.is_business_day(d));
+  }
+  EXPECT_EQ(cal.business_days_between(date::min(), date::max()),
+            expected.business_days_between(date::min(), date::max()));
+
+  {
+    std::ofstream ofs(path, std::ios::binary);
+    ofs << "2024-12-25\n2024-13-01\n";
+  }
+  EXPECT_THROW(business_calendar::fromfile(path.string()), std::invalid_argument);
+  std::filesystem::remove(path);
+  EXPECT_THROW(business_calendar::fromfile(path.string()), std::runtime_error);
+}
+
+int main() {
+  check_weekends_and_holidays();
+  check_add_business_days();
+  check_business_days_between();
+  check_add_holidays();
+  check_against_linear_scan();
+  check_fromfile();
+  return test_result("test_business_calendar");
+}
@@ -0,0 +1,194 @@
+// 与C++20 std::chrono日历的差分测试
+// 遍历[date::min(), date::max()]内的每一天，并对datetime做密集采样，
+// 把date/datetime的序数、星期、ISO日历、时间戳以及加减法的结果与std::chrono的计算结果比较。
+// 按CPU核数并行，任何不一致都会打印出来并使程序返回1。
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "datetime.h"
+#include "test_check.h"
+
+namespace chrono = std::chrono;
+
+static const chrono::sys_days kOrdinalBase = chrono::sys_days{chrono::year{1} / 1 / 1} -
+                                             chrono::days{1};
+
+static chrono::sys_days to_sys_days(int ordinal) { return kOrdinalBase + chrono::days{ordinal}; }
+
+/* ISO 8601: 一周从周一开始，包含该年第一个周四的周为第1周 */
+static datetime::IsoCalendarDate reference_isocalendar(chrono::sys_days sd) {
+  int wd = static_cast<int>(chrono::weekday{sd}.iso_encoding());
+  chrono::sys_days thursday = sd + chrono::days{4 - wd};
+  chrono::year iso_year = chrono::year_month_day{thursday}.year();
+  chrono::sys_days first_thursday{iso_year / chrono::January / chrono::Thursday[1]};
+  int week = static_cast<int>((thursday - first_thursday).count() / 7) + 1;
+  return datetime::IsoCalendarDate{static_cast<int>(iso_year), week, wd};
+}
+
+/* 每一天：序数 <-> 年月日、星期、ISO日历、月份天数以及按天加减 */
+static void check_dates(int first, int last) {
+  for (int ordinal = first; ordinal <= last; ++ordinal) {
+    chrono::sys_days sd = to_sys_days(ordinal);
+    chrono::year_month_day ymd{sd};
+    int y = static_cast<int>(ymd.year());
+    int m = static_cast<int>(static_cast<unsigned>(ymd.month()));
+    int d = static_cast<int>(static_cast<unsigned>(ymd.day()));
+    g_test_context = fmt::format("{:04d}-{:02d}-{:02d}", y, m, d);
+
+    auto date = datetime::date::fromordinal(ordinal);
+    EXPECT_EQ(date.year(), y);
+    EXPECT_EQ(date.month(), m);
+    EXPECT_EQ(date.day(), d);
+    EXPECT_EQ(datetime::date(y, m, d).toordinal(), ordinal);
+    EXPECT_EQ(date.weekday(), static_cast<int>(chrono::weekday{sd}.iso_encoding()) - 1);
+
+    if (d == 1) {
+      chrono::year_month_day_last last_day{ymd.year() / ymd.month() / chrono::last};
+      EXPECT_EQ(datetime::days_in_month(y, m),
+                static_cast<int>(static_cast<unsigned>(last_day.day())));
+      EXPECT_EQ(datetime::is_leap(y) != 0, ymd.year().is_leap());
+    }
+
+    auto iso = date.isocalendar();
+    auto ref = reference_isocalendar(sd);
+    EXPECT_EQ(iso.year, ref.year);
+    EXPECT_EQ(iso.week, ref.week);
+    EXPECT_EQ(iso.weekday, ref.weekday);
+    if (ref.year >= datetime::kMinYear && ref.year <= datetime::kMaxYear) {
+      EXPECT_EQ(datetime::date::fromisocalendar(ref).toordinal(), ordinal);
+    }
+
+    for (int n : {1, -1, 31, -365, 146097}) {
+      int target = ordinal + n;
+      if (target >= 1 && target <= datetime::kMaxOrdinal) {
+        EXPECT_EQ((date + datetime::timedelta(n)).toordinal(), target);
+        EXPECT_EQ((date - datetime::timedelta(-n)).toordinal(), target);
+      }
+    }
+
+    /* strftime较慢，只抽样检查与日历相关的格式 */
+    if (ordinal % 61 == 0) {
+      int yday = (sd - chrono::sys_days{ymd.year() / 1 / 1}).count() + 1;
+      int wd = static_cast<int>(chrono::weekday{sd}.c_encoding());
+      /* %U: 以周日为一周的第一天，%W: 以周一为一周的第一天 */
+      int week_u = (yday + 6 - wd) / 7;
+      int week_w = (yday + 6 - (wd + 6) % 7) / 7;
+      EXPECT_EQ(date.strftime("%j %U %W %w"),
+                fmt::format("{:03d} {:02d} {:02d} {}", yday, week_u, week_w, wd));
+    }
+  }
+}
+
+/* 随机采样的datetime：时间戳以及与timedelta的加减(normalize_datetime) */
+static void check_datetimes(uint64_t seed, int count) {
+  using us_time = chrono::sys_time<chrono::microseconds>;
+  const us_time kMin{chrono::sys_days{chrono::year{1} / 1 / 1}};
+  const us_time kMax = us_time{chrono::sys_days{chrono::year{9999} / 12 / 31}} +
+                       chrono::days{1} - chrono::microseconds{1};
+  const long long span = (kMax - kMin).count();
+
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<long long> pos(0, span);
+  std::uniform_int_distribution<int> magnitude(0, 48);
+
+  auto decompose = [](us_time t, int* f) {
+    auto sd = chrono::floor<chrono::days>(t);
+    chrono::year_month_day ymd{sd};
+    chrono::hh_mm_ss<chrono::microseconds> hms{t - sd};
+    f[0] = static_cast<int>(ymd.year());
+    f[1] = static_cast<int>(static_cast<unsigned>(ymd.month()));
+    f[2] = static_cast<int>(static_cast<unsigned>(ymd.day()));
+    f[3] = static_cast<int>(hms.hours().count());
+    f[4] = static_cast<int>(hms.minutes().count());
+    f[5] = static_cast<int>(hms.seconds().count());
+    f[6] = static_cast<int>(hms.subseconds().count());
+  };
+
+  for (int i = 0; i < count; ++i) {
+    us_time t = kMin + chrono::microseconds{pos(rng)};
+    /* 有1/16的样本落在取值范围的两端附近，用于检查越界 */
+    if ((rng() & 15) == 0) {
+      auto offset = chrono::microseconds{static_cast<long long>(rng() % (1ULL << 40))};
+      t = (rng() & 1) ? kMin + offset : kMax - offset;
+    }
+    int f[7];
+    decompose(t, f);
+    datetime::datetime dt(f[0], f[1], f[2], f[3], f[4], f[5], f[6]);
+    g_test_context = dt.str();
+
+    EXPECT_EQ(dt.utctimestamp().count(), t.time_since_epoch().count());
+    EXPECT_EQ(datetime::datetime::utcfromtimestamp(t.time_since_epoch()), dt);
+    EXPECT_EQ(dt.toordinal(), (chrono::floor<chrono::days>(t) - kOrdinalBase).count());
+
+    /* 1us到约9年的随机间隔 */
+    long long us = static_cast<long long>(rng() % (1ULL << magnitude(rng)));
+    if (rng() & 1) {
+      us = -us;
+    }
+    chrono::microseconds delta_us{us};
+    datetime::timedelta delta(delta_us);
+    us_time expected = t + delta_us;
+    g_test_context = fmt::format("{} + {}us", dt.str(), us);
+    if (expected < kMin || expected > kMax) {
+      EXPECT_THROW((void)(dt + delta), std::out_of_range);
+      continue;
+    }
+
+    int g[7];
+    decompose(expected, g);
+    datetime::datetime sum = dt + delta;
+    datetime::datetime ref(g[0], g[1], g[2], g[3], g[4], g[5], g[6]);
+    EXPECT_EQ(sum, ref);
+    EXPECT_EQ(ref - delta, dt);
+    EXPECT_EQ((ref - dt).total_microseconds(), us);
+  }
+}
+
+template <class F>
+static void parallel_for(long first, long last, F&& f) {
+  unsigned n = std::max(1u, std::thread::hardware_concurrency());
+  long chunk = (last - first + n) / n;
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < n; ++i) {
+    long b = first + i * chunk;
+    long e = std::min(last, b + chunk - 1);
+    if (b <= e) {
+      threads.emplace_back([&f, b, e, i] { f(b, e, i); });
+    }
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+int main() {
+  auto start = chrono::steady_clock::now();
+
+  parallel_for(1, datetime::kMaxOrdinal, [](long b, long e, unsigned) {
+    check_dates(static_cast<int>(b), static_cast<int>(e));
+  });
+  auto dates_done = chrono::steady_clock::now();
+
+  constexpr long kDatetimeSamples = 1 << 22;
+  constexpr long kBatch = 1 << 16;
+  parallel_for(0, kDatetimeSamples / kBatch - 1, [](long b, long e, unsigned) {
+    for (long batch = b; batch <= e; ++batch) {
+      check_datetimes(static_cast<uint64_t>(batch), kBatch);
+    }
+  });
+  auto end = chrono::steady_clock::now();
+
+  auto ms = [](auto d) { return chrono::duration_cast<chrono::milliseconds>(d).count(); };
+  std::printf("dates: %d in %lld ms, datetimes: %ld in %lld ms, threads: %u\n",
+              datetime::kMaxOrdinal, static_cast<long long>(ms(dates_done - start)),
+              kDatetimeSamples, static_cast<long long>(ms(end - dates_done)),
+              std::max(1u, std::thread::hardware_concurrency()));
+
+  return test_result("test_calendar_diff");
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+// 测试用的简单检查：失败时打印位置和两边的值并继续执行，
+// main最后返回test_result()，有失败时为1。可以在多个线程中同时使用，
+// g_test_context为当前线程正在检查的对象，非空时一起打印
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+#include "fmt/format.h"
+
+inline std::atomic<long> g_test_failures{0};
+inline std::mutex g_test_mutex;
+inline thread_local std::string g_test_context;
+
+template <class T>
+std::string test_show(const T& value) {
+  if constexpr (requires { value.str(); }) {
+    return std::string(value.str());
+  } else if constexpr (fmt::is_formattable<T>::value) {
+    return fmt::format("{}", value);
+  } else {
+    return "?";
+  }
+}
+
+inline void test_fail(const char* file, int line, const std::string& what) {
+  if (++g_test_failures <= 50) {
+    std::lock_guard<std::mutex> lock(g_test_mutex);
+    if (g_test_context.empty()) {
+      std::fprintf(stderr, "%s:%d: FAILED: %s\n", file, line, what.c_str());
+    } else {
+      std::fprintf(stderr, "%s:%d: FAILED: %s: %s\n", file, line, g_test_context.c_str(),
+                   what.c_str());
+    }
+  }
+}
+
+#define EXPECT_EQ(lhs, rhs)                                                                    \
+  do {                                                                                         \
+    auto&& _l = (lhs);                                                                         \
+    auto&& _r = (rhs);                                                                         \
+    if (!(_l == _r)) {                                                                         \
+      test_fail(__FILE__, __LINE__,                                                            \
+                fmt::format("{} == {} ({} vs {})", #lhs, #rhs, test_show(_l), test_show(_r))); \
+    }                                                                                          \
+  } while (0)
+
+#define EXPECT_TRUE(cond)                   \
+  do {                                      \
+    if (!(cond)) {                          \
+      test_fail(__FILE__, __LINE__, #cond); \
+    }                                       \
+  } while (0)
+
+#define EXPECT_THROW(stmt, exception)                                                \
+  do {                                                                               \
+    bool _thrown = false;                                                            \
+    try {                                                                            \
+      stmt;                                                                          \
+    } catch (const exception&) {                                                     \
+      _thrown = true;                                                                \
+    }                                                                                \
+    if (!_thrown) {                                                                  \
+      test_fail(__FILE__, __LINE__, fmt::format("{} throws {}", #stmt, #exception)); \
+    }                                                                                \
+  } while (0)
+
+inline int test_result(const char* name) {
+  if (g_test_failures != 0) {
+    std::fprintf(stderr, "%s: %ld failures\n", name, g_test_failures.load());
+    return 1;
+  }
+  std::printf("%s: ok\n", name);
+  return 0;
+}
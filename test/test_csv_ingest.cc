@@ -0,0 +1,171 @@
+// csv_ingest在块边界、带引号的字段、CRLF、缺少的列上的结果，以及无法解析的字段对应的行号
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "csv_ingest.h"
+#include "test_check.h"
+
+using datetime::csv_ingest;
+using datetime::CsvIngestResult;
+using datetime::CsvParseError;
+
+namespace datetime {
+/* 通过ADL被std::vector的比较找到 */
+static bool operator==(const CsvParseError& lhs, const CsvParseError& rhs) {
+  return lhs.row == rhs.row && lhs.column == rhs.column;
+}
+}  // namespace datetime
+
+static long long timestamp(const datetime::datetime& dt) { return dt.utctimestamp().count(); }
+
+static void check_small() {
+  /* 时间戳列的顺序与CSV中的顺序相反 */
+  csv_ingest ingest({{2, "%Y-%m-%d"}, {0, "%Y-%m-%d %H:%M:%S"}}, ',', true, 1);
+  auto result = ingest.parse(
+      "time,price,date\n"
+      "2024-01-02 09:30:00,1.5,2024-01-02\r\n"
+      "\"2024-01-02 09:30:01\",\"1,\"\"5\",\"2024-01-03\"\n"
+      "2024-01-02 09:30:02,1.5\n"
+      "\n"
+      "bad,1.5,2024-13-01\n"
+      "2024-01-02 09:30:03,1.5,");
+  EXPECT_EQ(result.rows, std::size_t{6});
+  const std::vector<long long> times = {timestamp(datetime::datetime(2024, 1, 2, 9, 30)),
+                                        timestamp(datetime::datetime(2024, 1, 2, 9, 30, 1)),
+                                        timestamp(datetime::datetime(2024, 1, 2, 9, 30, 2)),
+                                        CsvIngestResult::kInvalidTimestamp,
+                                        CsvIngestResult::kInvalidTimestamp,
+                                        timestamp(datetime::datetime(2024, 1, 2, 9, 30, 3))};
+  const std::vector<long long> dates = {timestamp(datetime::datetime(2024, 1, 2)),
+                                        timestamp(datetime::datetime(2024, 1, 3)),
+                                        CsvIngestResult::kInvalidTimestamp,
+                                        CsvIngestResult::kInvalidTimestamp,
+                                        CsvIngestResult::kInvalidTimestamp,
+                                        CsvIngestResult::kInvalidTimestamp};
+  EXPECT_EQ(result.timestamps.size(), std::size_t{2});
+  EXPECT_TRUE(result.timestamps[0] == dates);
+  EXPECT_TRUE(result.timestamps[1] == times);
+  const std::vector<CsvParseError> errors = {{2, 2}, {3, 0}, {3, 2}, {4, 0}, {4, 2}, {5, 2}};
+  EXPECT_TRUE(result.errors == errors);
+
+  /* 没有表头，分隔符为'\t'，最后一列在行尾 */
+  csv_ingest tsv({{1, "%Y%m%d"}}, '\t', false, 1);
+  result = tsv.parse("a\t20240102\r\nb\t20240103");
+  EXPECT_EQ(result.rows, std::size_t{2});
+  EXPECT_TRUE(result.errors.empty());
+  EXPECT_EQ(result.timestamps[0][1], timestamp(datetime::datetime(2024, 1, 3)));
+
+  /* 只有表头，以及空的输入 */
+  EXPECT_EQ(ingest.parse("time,price,date\n").rows, std::size_t{0});
+  EXPECT_EQ(ingest.parse("time,price,date").rows, std::size_t{0});
+  EXPECT_EQ(ingest.parse("").rows, std::size_t{0});
+  EXPECT_EQ(tsv.parse("").rows, std::size_t{0});
+
+  /* 没有结束的引号吃掉这一行剩下的部分 */
+  result = ingest.parse("h\n\"2024-01-02 09:30:00,1.5,2024-01-02\n");
+  EXPECT_EQ(result.rows, std::size_t{1});
+  EXPECT_EQ(result.errors.size(), std::size_t{2});
+}
+
+struct Expected {
+  std::string csv;
+  std::vector<long long> times;
+  std::vector<long long> dates;
+  std::vector<CsvParseError> errors;
+};
+
+/* 超过多个块大小的数据，各种形式的行混在一起 */
+static Expected make_large(std::size_t num_rows) {
+  Expected e;
+  e.csv = "id,time,price,date\n";
+  auto base = datetime::datetime(2024, 1, 2, 9, 30);
+  for (std::size_t i = 0; i < num_rows; ++i) {
+    auto dt = base + datetime::timedelta(0, 0, static_cast<int>(i % 1000) * 1234567);
+    long long time = timestamp(dt);
+    long long date = timestamp(datetime::datetime::combine(dt.date(), datetime::time()));
+    std::string time_field = dt.strftime("%Y-%m-%d %H:%M:%S.%f");
+    std::string date_field = dt.strftime("%Y-%m-%d");
+
+    if (i % 19 == 0) {
+      /* 空行 */
+      e.csv += i % 2 ? "\r\n" : "\n";
+      e.times.push_back(CsvIngestResult::kInvalidTimestamp);
+      e.dates.push_back(CsvIngestResult::kInvalidTimestamp);
+      e.errors.push_back({i, 1});
+      e.errors.push_back({i, 3});
+      continue;
+    }
+    if (i % 17 == 3) {
+      time_field = "2024-01-02T" + time_field;
+      time = CsvIngestResult::kInvalidTimestamp;
+      e.errors.push_back({i, 1});
+    }
+    if (i % 5 == 0) {
+      time_field = "\"" + time_field + "\"";
+    }
+    std::string price = i % 11 == 0 ? "\"1,\"\"2\"\"\"" : "1.25";
+    e.csv += std::to_string(i) + "," + time_field;
+    if (i % 13 == 5) {
+      /* 缺少后面的列 */
+      date = CsvIngestResult::kInvalidTimestamp;
+      e.errors.push_back({i, 3});
+    } else {
+      e.csv += "," + price + "," + date_field;
+    }
+    if (i + 1 < num_rows) {
+      e.csv += i % 7 == 0 ? "\r\n" : "\n";
+    }
+    e.times.push_back(time);
+    e.dates.push_back(date);
+  }
+  return e;
+}
+
+static void check_large() {
+  const std::size_t num_rows = 30000;
+  Expected e = make_large(num_rows);
+  EXPECT_TRUE(e.csv.size() > 64 * 1024 * 8);
+  std::vector<datetime::CsvTimestampColumn> columns = {{3, "%Y-%m-%d"},
+                                                       {1, "%Y-%m-%d %H:%M:%S.%f"}};
+  for (unsigned threads : {1u, 2u, 3u, 8u, 64u}) {
+    auto result = csv_ingest(columns, ',', true, threads).parse(e.csv);
+    EXPECT_EQ(result.rows, num_rows);
+    EXPECT_TRUE(result.timestamps[0] == e.dates);
+    EXPECT_TRUE(result.timestamps[1] == e.times);
+    EXPECT_TRUE(result.errors == e.errors);
+  }
+
+  /* 块的边界恰好落在各种位置 */
+  for (std::size_t cut = e.csv.size() - 2000; cut < e.csv.size(); cut += 97) {
+    std::string_view data(e.csv.data(), cut);
+    auto single = csv_ingest(columns, ',', true, 1).parse(data);
+    auto multi = csv_ingest(columns, ',', true, 5).parse(data);
+    EXPECT_EQ(multi.rows, single.rows);
+    EXPECT_TRUE(multi.timestamps == single.timestamps);
+    EXPECT_TRUE(multi.errors == single.errors);
+  }
+
+  auto path = std::filesystem::temp_directory_path() / "test_csv_ingest.csv";
+  {
+    std::ofstream ofs(path, std::ios::binary);
+    ofs << e.csv;
+  }
+  auto result = csv_ingest(columns, ',', true, 4).read(path.string());
+  EXPECT_TRUE(result.timestamps[1] == e.times);
+  EXPECT_TRUE(result.errors == e.errors);
+  {
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  }
+  EXPECT_EQ(csv_ingest(columns).read(path.string()).rows, std::size_t{0});
+  std::filesystem::remove(path);
+  EXPECT_THROW(csv_ingest(columns).read(path.string()), std::runtime_error);
+}
+
+int main() {
+  check_small();
+  check_large();
+  return test_result("test_csv_ingest");
+}
@@ -1,3 +1,301 @@
+// datetime.h中的日期时间类型：不经过参数检查构造结果的路径在范围两端的行为、validate_and_build、
+// 批量的isocalendar、key_traits的打包以及与std::chrono之间的转换
 
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <random>
+#include <stdexcept>
+#include <vector>
 
-int main() {}
+#include "datetime.h"
+#include "test_check.h"
+
+namespace chrono = std::chrono;
+
+using datetime::date;
+using datetime::IsoCalendarDate;
+using datetime::timedelta;
+
+static datetime::datetime at(int y, int m, int d, int h = 0, int mi = 0, int s = 0, int us = 0) {
+  return datetime::datetime(y, m, d, h, mi, s, us);
+}
+
+/* 不经过check_date_args构造结果的路径在范围两端的行为 */
+static void check_bounds() {
+  int max = datetime::kMaxOrdinal;
+  EXPECT_EQ(date::fromordinal(max), date::max());
+  EXPECT_EQ(datetime::datetime::fromordinal(max), at(9999, 12, 31));
+  EXPECT_THROW((void)date::fromordinal(max + 1), std::out_of_range);
+  EXPECT_THROW((void)datetime::datetime::fromordinal(max + 1), std::out_of_range);
+
+  /* 9999-12-31是周五，所在ISO周的周六、周日属于10000年 */
+  EXPECT_EQ(date::fromisocalendar(IsoCalendarDate{9999, 52, 5}), date::max());
+  EXPECT_EQ(date::fromisocalendar(IsoCalendarDate{1, 1, 1}), date::min());
+  EXPECT_THROW((void)date::fromisocalendar(IsoCalendarDate{9999, 52, 6}), std::out_of_range);
+  EXPECT_THROW((void)datetime::datetime::fromisocalendar(IsoCalendarDate{9999, 52, 7}),
+               std::out_of_range);
+
+  EXPECT_THROW((void)(date::max() + timedelta(1)), std::out_of_range);
+  EXPECT_THROW((void)(date::min() - timedelta(1)), std::out_of_range);
+  EXPECT_THROW((void)(datetime::datetime::max() + timedelta(0, 0, 1)), std::out_of_range);
+  EXPECT_THROW((void)(datetime::datetime::min() - timedelta(0, 0, 1)), std::out_of_range);
+}
+
+/* 每年每月的月末附近，validate_and_build与year_month_day::ok()的结果相同 */
+static void check_validate_and_build() {
+  std::vector<int> f[7];
+  for (int y = datetime::kMinYear - 1; y <= datetime::kMaxYear + 1; ++y) {
+    for (int m = 0; m <= 13; ++m) {
+      for (int d : {0, 1, 28, 29, 30, 31, 32}) {
+        for (int h : {0, 23, 24, -1}) {
+          int row[7] = {y, m, d, h, 59, 59, 999999};
+          for (int k = 0; k < 7; ++k) {
+            f[k].push_back(row[k]);
+          }
+        }
+      }
+    }
+  }
+  std::size_t n = f[0].size();
+  std::vector<datetime::datetime> out(n, datetime::datetime::max());
+  std::vector<uint8_t> valid((n + 7) / 8);
+  std::size_t num_valid =
+      datetime::validate_and_build(f[0].data(), f[1].data(), f[2].data(), f[3].data(), f[4].data(),
+                                   f[5].data(), f[6].data(), n, out.data(), valid.data());
+
+  std::size_t expected_valid = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    int y = f[0][i];
+    chrono::year_month_day ymd{chrono::year{y}, chrono::month{static_cast<unsigned>(f[1][i])},
+                               chrono::day{static_cast<unsigned>(f[2][i])}};
+    bool ok = y >= datetime::kMinYear && y <= datetime::kMaxYear && ymd.ok() && f[3][i] >= 0 &&
+              f[3][i] <= 23;
+    g_test_context = fmt::format("validate_and_build {}-{}-{} {}h", y, f[1][i], f[2][i], f[3][i]);
+    EXPECT_EQ(static_cast<bool>((valid[i / 8] >> (i % 8)) & 1), ok);
+    if (ok) {
+      EXPECT_EQ(out[i], at(f[0][i], f[1][i], f[2][i], f[3][i], 59, 59, 999999));
+      ++expected_valid;
+    } else {
+      EXPECT_EQ(out[i], datetime::datetime::min());
+    }
+  }
+  g_test_context.clear();
+  EXPECT_EQ(num_valid, expected_valid);
+
+  /* 不可信的输入，每个字段都可能是INT_MIN或INT_MAX */
+  const int good[7] = {2024, 2, 29, 23, 59, 59, 999999};
+  std::vector<int> g[7];
+  for (int k = 0; k < 7; ++k) {
+    for (int bad : {INT_MIN, INT_MIN + 1, INT_MAX, INT_MAX - 1, -1}) {
+      for (int j = 0; j < 7; ++j) {
+        g[j].push_back(j == k ? bad : good[j]);
+      }
+    }
+  }
+  for (int j = 0; j < 7; ++j) {
+    g[j].push_back(good[j]);
+  }
+  n = g[0].size();
+  out.assign(n, datetime::datetime::max());
+  valid.assign((n + 7) / 8, 0xff);
+  EXPECT_EQ(datetime::validate_and_build(g[0].data(), g[1].data(), g[2].data(), g[3].data(),
+                                         g[4].data(), g[5].data(), g[6].data(), n, out.data(),
+                                         valid.data()),
+            std::size_t{1});
+  for (std::size_t i = 0; i + 1 < n; ++i) {
+    EXPECT_EQ((valid[i / 8] >> (i % 8)) & 1, 0);
+    EXPECT_EQ(out[i], datetime::datetime::min());
+  }
+  EXPECT_EQ((valid[(n - 1) / 8] >> ((n - 1) % 8)) & 1, 1);
+  EXPECT_EQ(out[n - 1], at(2024, 2, 29, 23, 59, 59, 999999));
+}
+
+/* 批量的isocalendar与逐个调用date::isocalendar()相同，每次处理的个数不同，覆盖各种余数 */
+static void check_batch_isocalendar() {
+  std::vector<int> ordinals;
+  for (int ordinal = 1; ordinal <= datetime::kMaxOrdinal; ++ordinal) {
+    ordinals.push_back(ordinal);
+  }
+  std::vector<IsoCalendarDate> out(ordinals.size());
+  std::size_t done = 0;
+  for (std::size_t n = 0; done < ordinals.size(); n = (n + 1) % 37) {
+    std::size_t count = std::min(n, ordinals.size() - done);
+    datetime::isocalendar(ordinals.data() + done, count, out.data() + done);
+    done += count;
+  }
+  for (std::size_t i = 0; i < ordinals.size(); ++i) {
+    auto ref = date::fromordinal(ordinals[i]).isocalendar();
+    if (out[i].year != ref.year || out[i].week != ref.week || out[i].weekday != ref.weekday) {
+      test_fail(__FILE__, __LINE__, fmt::format("batch isocalendar ordinal {}", ordinals[i]));
+    }
+  }
+
+  int bad[] = {1, 0, 2};
+  EXPECT_THROW(datetime::isocalendar(bad, 3, out.data()), std::out_of_range);
+  bad[1] = datetime::kMaxOrdinal + 1;
+  EXPECT_THROW(datetime::isocalendar(bad, 3, out.data()), std::out_of_range);
+}
+
+/* 打包后的key可以还原、不为0，且与比较运算的顺序相同 */
+static void check_key_traits() {
+  using date_key = datetime::detail::key_traits<date>;
+  using datetime_key = datetime::detail::key_traits<datetime::datetime>;
+
+  uint64_t prev = 0;
+  for (int ordinal = 1; ordinal <= datetime::kMaxOrdinal; ++ordinal) {
+    auto d = date::fromordinal(ordinal);
+    auto key = date_key::pack(d);
+    if (date_key::unpack(key) != d || key <= prev) {
+      test_fail(__FILE__, __LINE__, fmt::format("key_traits<date> {}", d.str()));
+    }
+    prev = key;
+  }
+
+  std::mt19937_64 rng(41);
+  long long first = datetime::datetime::min().utctimestamp().count();
+  long long last = datetime::datetime::max().utctimestamp().count();
+  std::uniform_int_distribution<long long> us(first, last);
+  auto sample = [&] {
+    return datetime::datetime::utcfromtimestamp(chrono::microseconds{us(rng)});
+  };
+  std::vector<datetime::datetime> values = {datetime::datetime::min(), datetime::datetime::max()};
+  for (int i = 0; i < 1000000; ++i) {
+    auto dt = sample();
+    values.push_back(dt);
+    /* 只差1微秒的相邻值 */
+    if (i % 8 == 0 && dt != datetime::datetime::max()) {
+      values.push_back(dt + timedelta(0, 0, 1));
+    }
+  }
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    const auto& a = values[i];
+    const auto& b = values[(i + 1) % values.size()];
+    auto ka = datetime_key::pack(a);
+    auto kb = datetime_key::pack(b);
+    if (datetime_key::unpack(ka) != a || ka == 0 || (ka < kb) != (a < b) ||
+        (ka == kb) != (a == b)) {
+      test_fail(__FILE__, __LINE__, fmt::format("key_traits<datetime> {} {}", a.str(), b.str()));
+    }
+  }
+}
+
+/* 与std::chrono之间的转换 */
+using sys_us = chrono::sys_time<chrono::microseconds>;
+using namespace std::chrono_literals;
+
+constexpr date kLeapDay{2024y / 2 / 29};
+static_assert(kLeapDay.year() == 2024 && kLeapDay.month() == 2 && kLeapDay.day() == 29);
+static_assert(chrono::sys_days(kLeapDay) == chrono::sys_days{2024y / 2 / 29});
+static_assert(chrono::year_month_day(date{chrono::sys_days{1y / 1 / 1}}) == 1y / 1 / 1);
+static_assert(chrono::year_month_day(date{9999y / 12 / 31}) == 9999y / 12 / 31);
+
+constexpr datetime::datetime kOpen{chrono::sys_days{2024y / 1 / 2} + 9h + 30min + 5us};
+static_assert(kOpen.hour() == 9 && kOpen.minute() == 30 && kOpen.microsecond() == 5);
+static_assert(sys_us(kOpen) == chrono::sys_days{2024y / 1 / 2} + 9h + 30min + 5us);
+static_assert(chrono::local_time<chrono::microseconds>(
+                  datetime::datetime{chrono::local_days{1970y / 1 / 1} - 1us})
+                  .time_since_epoch() == -1us);
+static_assert(datetime::datetime{sys_us{} - 1us}.year() == 1969);
+
+static_assert(static_cast<chrono::microseconds>(timedelta()) == 0us);
+constexpr timedelta kMinusOne{-1us};
+static_assert(kMinusOne.days() == -1 && kMinusOne.seconds() == 86399 &&
+              kMinusOne.microseconds() == 999999);
+static_assert(static_cast<chrono::microseconds>(kMinusOne) == -1us);
+static_assert(static_cast<chrono::microseconds>(timedelta{chrono::microseconds{LLONG_MAX}}) ==
+              chrono::microseconds{LLONG_MAX});
+static_assert(static_cast<chrono::microseconds>(timedelta{chrono::microseconds{LLONG_MIN}}) ==
+              chrono::microseconds{LLONG_MIN});
+
+static void check_chrono() {
+  /* 每一天 */
+  const chrono::sys_days base = chrono::sys_days{1y / 1 / 1} - chrono::days{1};
+  for (int ordinal = 1; ordinal <= datetime::kMaxOrdinal; ++ordinal) {
+    auto d = date::fromordinal(ordinal);
+    chrono::sys_days sd = d;
+    chrono::year_month_day ymd = d;
+    if ((sd - base).count() != ordinal || date(sd) != d || date(ymd) != d ||
+        chrono::sys_days(ymd) != sd) {
+      test_fail(__FILE__, __LINE__, fmt::format("date <-> sys_days {}", d.str()));
+    }
+  }
+  EXPECT_THROW(date{0y / 12 / 31}, std::out_of_range);
+  EXPECT_THROW(date{10000y / 1 / 1}, std::out_of_range);
+  EXPECT_THROW(date{2023y / 2 / 29}, std::out_of_range);
+  EXPECT_THROW(date{2024y / 13 / 1}, std::out_of_range);
+  EXPECT_THROW(date{chrono::sys_days{1y / 1 / 1} - chrono::days{1}}, std::out_of_range);
+
+  /* 随机的datetime，sys_time与utctimestamp相同 */
+  std::mt19937_64 rng(43);
+  const sys_us first = chrono::sys_days{1y / 1 / 1};
+  const sys_us last = chrono::sys_days{9999y / 12 / 31} + chrono::days{1} - 1us;
+  std::uniform_int_distribution<long long> pos(first.time_since_epoch().count(),
+                                               last.time_since_epoch().count());
+  for (int i = 0; i < 1000000; ++i) {
+    sys_us tp{chrono::microseconds{i < 2 ? (i == 0 ? first : last).time_since_epoch().count()
+                                         : pos(rng)}};
+    datetime::datetime dt{tp};
+    chrono::local_time<chrono::microseconds> local = dt;
+    if (sys_us(dt) != tp || dt.utctimestamp().count() != tp.time_since_epoch().count() ||
+        datetime::datetime::utcfromtimestamp(tp.time_since_epoch()) != dt ||
+        local.time_since_epoch() != tp.time_since_epoch() || datetime::datetime{local} != dt) {
+      test_fail(__FILE__, __LINE__, fmt::format("datetime <-> sys_time {}", dt.str()));
+    }
+  }
+  EXPECT_THROW(datetime::datetime{first - 1us}, std::out_of_range);
+  EXPECT_THROW(datetime::datetime{last + 1us}, std::out_of_range);
+  EXPECT_THROW(datetime::datetime{chrono::local_days{10000y / 1 / 1}}, std::out_of_range);
+
+  /* timedelta与microseconds，运行时与编译期的取整方式相同 */
+  for (int i = 0; i < 1000000; ++i) {
+    long long us = static_cast<long long>(rng());
+    if (i % 2 == 0) {
+      us >>= rng() % 64;
+    }
+    timedelta td{chrono::microseconds{us}};
+    if (static_cast<chrono::microseconds>(td).count() != us || td.total_microseconds() != us) {
+      test_fail(__FILE__, __LINE__, fmt::format("timedelta <-> microseconds {}", us));
+    }
+  }
+  timedelta minus_one{-1us};
+  EXPECT_EQ(minus_one.days(), kMinusOne.days());
+  EXPECT_EQ(minus_one.seconds(), kMinusOne.seconds());
+  EXPECT_EQ(minus_one.microseconds(), kMinusOne.microseconds());
+  EXPECT_EQ(timedelta(1, 30) + timedelta(), timedelta{chrono::days{1} + 30s});
+
+  /* 超出int64微秒数的timedelta */
+  const int max_days = 106751991;
+  EXPECT_EQ(static_cast<chrono::microseconds>(timedelta(max_days, 14454, 775807)).count(),
+            LLONG_MAX);
+  EXPECT_THROW((void)static_cast<chrono::microseconds>(timedelta(max_days, 86399, 999999)),
+               std::overflow_error);
+  EXPECT_EQ(static_cast<chrono::microseconds>(timedelta(-max_days)),
+            chrono::microseconds{chrono::days{-max_days}});
+  for (long long us : {LLONG_MAX, LLONG_MAX - 1, LLONG_MIN, LLONG_MIN + 1}) {
+    EXPECT_EQ(static_cast<chrono::microseconds>(timedelta{chrono::microseconds{us}}).count(), us);
+  }
+  /* days为-106751992时只有秒和微秒足够大才在int64范围内 */
+  EXPECT_THROW((void)static_cast<chrono::microseconds>(
+                   timedelta{chrono::microseconds{LLONG_MIN}} - timedelta(0, 0, 1)),
+               std::overflow_error);
+  EXPECT_THROW((void)static_cast<chrono::microseconds>(
+                   timedelta{chrono::microseconds{LLONG_MAX}} + timedelta(0, 0, 1)),
+               std::overflow_error);
+  EXPECT_THROW((void)static_cast<chrono::microseconds>(timedelta(max_days + 1)),
+               std::overflow_error);
+  EXPECT_THROW((void)static_cast<chrono::microseconds>(timedelta(-max_days - 1)),
+               std::overflow_error);
+  EXPECT_THROW((void)static_cast<chrono::microseconds>(timedelta(datetime::kMaxDeltaDays)),
+               std::overflow_error);
+  EXPECT_THROW((void)static_cast<chrono::microseconds>(timedelta::min()), std::overflow_error);
+}
+
+int main() {
+  check_bounds();
+  check_validate_and_build();
+  check_batch_isocalendar();
+  check_key_traits();
+  check_chrono();
+  return test_result("test_datetime");
+}
@@ -0,0 +1,149 @@
+// datetime_hash_map和datetime_flat_map在随机的插入、删除、查找下与std::map比较，
+// 覆盖hash map删除时的向前移动、rehash，以及flat map的lower_bound/upper_bound/erase
+
+#include <iterator>
+#include <map>
+#include <random>
+
+#include "datetime_flat_map.h"
+#include "datetime_hash_map.h"
+#include "test_check.h"
+
+using datetime::datetime_flat_map;
+using datetime::datetime_hash_map;
+
+template <class Key>
+static void check_same(datetime_hash_map<Key, long>& hash, datetime_flat_map<Key, long>& flat,
+                       const std::map<Key, long>& ref) {
+  EXPECT_EQ(hash.size(), ref.size());
+  EXPECT_EQ(flat.size(), ref.size());
+  std::size_t visited = 0;
+  hash.for_each([&](const Key& key, long& value) {
+    auto it = ref.find(key);
+    EXPECT_TRUE(it != ref.end() && it->second == value);
+    ++visited;
+  });
+  EXPECT_EQ(visited, ref.size());
+
+  std::size_t i = 0;
+  for (const auto& [key, value] : ref) {
+    if (i < flat.size()) {
+      EXPECT_EQ(flat.key(i), key);
+      EXPECT_EQ(flat.value(i), value);
+    }
+    ++i;
+  }
+}
+
+/* key(i)在很小的范围内取值，使插入和删除频繁命中已有的key，探测链也较长 */
+template <class Key, class MakeKey>
+static void check_random(uint64_t seed, std::size_t universe, int rounds, MakeKey&& make_key) {
+  std::mt19937_64 rng(seed);
+  datetime_hash_map<Key, long> hash;
+  datetime_flat_map<Key, long> flat;
+  std::map<Key, long> ref;
+
+  for (int round = 0; round < rounds; ++round) {
+    /* 随着轮数变化，在增长和收缩之间切换，使hash map多次rehash */
+    bool growing = (round / (rounds / 8)) % 2 == 0;
+    Key key = make_key(rng() % universe);
+    long value = static_cast<long>(rng() % 1000);
+    int op = static_cast<int>(rng() % 10);
+
+    if (op < (growing ? 4 : 2)) {
+      auto [hp, hi] = hash.try_emplace(key, value);
+      auto [fp, fi] = flat.try_emplace(key, value);
+      auto [it, inserted] = ref.try_emplace(key, value);
+      EXPECT_EQ(hi, inserted);
+      EXPECT_EQ(fi, inserted);
+      EXPECT_EQ(*hp, it->second);
+      EXPECT_EQ(*fp, it->second);
+    } else if (op < 5) {
+      bool inserted = !ref.count(key);
+      ref[key] = value;
+      EXPECT_EQ(hash.insert_or_assign(key, value), inserted);
+      EXPECT_EQ(flat.insert_or_assign(key, value), inserted);
+    } else if (op < 6) {
+      /* 连续访问同一个key */
+      for (int k = 0; k < 3; ++k) {
+        hash[key] += value;
+        flat[key] += value;
+        ref[key] += value;
+      }
+    } else if (op < (growing ? 8 : 9)) {
+      bool erased = ref.erase(key) != 0;
+      EXPECT_EQ(hash.erase(key), erased);
+      EXPECT_EQ(flat.erase(key), erased);
+      EXPECT_TRUE(!hash.contains(key));
+      EXPECT_TRUE(hash.find(key) == nullptr);
+    } else {
+      auto it = ref.find(key);
+      const auto& const_hash = hash;
+      const auto& const_flat = flat;
+      if (it == ref.end()) {
+        EXPECT_TRUE(hash.find(key) == nullptr);
+        EXPECT_TRUE(const_hash.find(key) == nullptr);
+        EXPECT_TRUE(flat.find(key) == nullptr);
+        EXPECT_TRUE(!const_flat.contains(key));
+      } else {
+        EXPECT_TRUE(hash.find(key) != nullptr && *hash.find(key) == it->second);
+        EXPECT_TRUE(const_hash.find(key) != nullptr && *const_hash.find(key) == it->second);
+        EXPECT_TRUE(flat.find(key) != nullptr && *flat.find(key) == it->second);
+        EXPECT_TRUE(const_flat.contains(key));
+      }
+
+      auto lower = static_cast<std::size_t>(std::distance(ref.begin(), ref.lower_bound(key)));
+      auto upper = static_cast<std::size_t>(std::distance(ref.begin(), ref.upper_bound(key)));
+      EXPECT_EQ(flat.lower_bound(key), lower);
+      EXPECT_EQ(flat.upper_bound(key), upper);
+    }
+
+    if (round % 997 == 0) {
+      check_same(hash, flat, ref);
+    }
+  }
+  check_same(hash, flat, ref);
+
+  /* 全部删除后hash map中不应留下任何元素，之后仍可以正常插入 */
+  while (!ref.empty()) {
+    Key key = ref.begin()->first;
+    EXPECT_TRUE(hash.erase(key));
+    EXPECT_TRUE(flat.erase(key));
+    ref.erase(ref.begin());
+  }
+  check_same(hash, flat, ref);
+  EXPECT_TRUE(hash.empty());
+  EXPECT_TRUE(flat.empty());
+  Key key = make_key(0);
+  hash[key] = 1;
+  EXPECT_TRUE(hash.find(key) != nullptr);
+
+  hash.clear();
+  hash.reserve(universe);
+  for (std::size_t i = 0; i < universe; ++i) {
+    hash[make_key(i)] = static_cast<long>(i);
+  }
+  EXPECT_EQ(hash.size(), universe);
+  for (std::size_t i = 0; i < universe; ++i) {
+    EXPECT_TRUE(hash.find(make_key(i)) != nullptr && *hash.find(make_key(i)) == long(i));
+  }
+}
+
+int main() {
+  const datetime::datetime base(2024, 1, 2, 9, 30);
+  /* 相邻的key只相差1微秒或跨越秒、分钟、日期等字段 */
+  check_random<datetime::datetime>(42, 3000, 200000, [&](std::size_t i) {
+    long long us = static_cast<long long>(i % 1000) + static_cast<long long>(i / 1000) * 86399999;
+    return base + datetime::timedelta(std::chrono::microseconds{us});
+  });
+  check_random<datetime::date>(43, 5000, 200000, [](std::size_t i) {
+    return i == 0 ? datetime::date::min()
+                  : i == 1 ? datetime::date::max()
+                           : datetime::date::fromordinal(738000 + static_cast<int>(i));
+  });
+  /* 很小的范围内反复插入删除同一批key */
+  check_random<datetime::datetime>(44, 40, 50000, [&](std::size_t i) {
+    return base + datetime::timedelta(0, static_cast<int>(i));
+  });
+  return test_result("test_datetime_maps");
+}
@@ -0,0 +1,215 @@
+// radix_sort和merge_sorted与std::stable_sort比较，覆盖基数排序与std::sort的切换点、
+// 只需一趟或不需要排序的输入、long long的全部取值范围、空序列，以及多线程的分段
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "datetime.h"
+#include "datetime_sort.h"
+#include "test_check.h"
+
+using datetime::SortedRun;
+
+/* radix_sort中基数排序与std::sort的切换点 */
+static constexpr std::size_t kMinRadixSize = 256;
+
+/* 至少为2 * kMinChunkSize，多线程时会分成多段 */
+static constexpr std::size_t kParallelSize = 300'000;
+
+static const unsigned kThreads[] = {1, 4};
+
+template <class T>
+static void check_radix_sort(const std::vector<T>& input, const std::string& what) {
+  auto expected = input;
+  std::stable_sort(expected.begin(), expected.end());
+  for (unsigned num_threads : kThreads) {
+    auto sorted = input;
+    datetime::radix_sort(sorted.data(), sorted.size(), num_threads);
+    if (sorted != expected) {
+      test_fail(__FILE__, __LINE__,
+                fmt::format("radix_sort {} n={} threads={}", what, input.size(), num_threads));
+    }
+  }
+}
+
+static std::vector<long long> random_timestamps(std::size_t n, std::mt19937_64& rng,
+                                                long long lo, long long hi) {
+  std::uniform_int_distribution<long long> dist(lo, hi);
+  std::vector<long long> v(n);
+  for (auto& t : v) {
+    t = dist(rng);
+  }
+  return v;
+}
+
+static void check_timestamps() {
+  std::mt19937_64 rng(50);
+  const long long day = 86400LL * 1000000;
+  const std::size_t sizes[] = {0,   1,    2,    kMinRadixSize - 1, kMinRadixSize, kMinRadixSize + 1,
+                               1000, 5000, kParallelSize};
+  for (std::size_t n : sizes) {
+    /* 全部取值范围，包括LLONG_MIN和LLONG_MAX */
+    auto full = random_timestamps(n, rng, LLONG_MIN, LLONG_MAX);
+    if (n >= 4) {
+      full[n / 3] = LLONG_MIN;
+      full[n / 2] = LLONG_MAX;
+      full[n - 1] = LLONG_MIN;
+      full[0] = LLONG_MAX;
+    }
+    check_radix_sort(full, "full range");
+    /* 1970年以前，全为负数 */
+    check_radix_sort(random_timestamps(n, rng, -2000 * 365 * day, -1), "negative");
+    /* 跨越0 */
+    check_radix_sort(random_timestamps(n, rng, -day, day), "around epoch");
+    /* 差值不超过11位，只需要一趟 */
+    check_radix_sort(random_timestamps(n, rng, -1000, 1047), "one pass");
+    check_radix_sort(random_timestamps(n, rng, LLONG_MAX - 2047, LLONG_MAX), "one pass at max");
+    /* 大量重复 */
+    check_radix_sort(random_timestamps(n, rng, 0, 3), "duplicates");
+    /* 全部相等，不需要任何一趟 */
+    check_radix_sort(std::vector<long long>(n, -day), "all equal");
+    check_radix_sort(std::vector<long long>(n, LLONG_MIN), "all LLONG_MIN");
+    /* 已排序和逆序 */
+    auto ascending = random_timestamps(n, rng, -day, day);
+    std::sort(ascending.begin(), ascending.end());
+    check_radix_sort(ascending, "ascending");
+    check_radix_sort(std::vector<long long>(ascending.rbegin(), ascending.rend()), "descending");
+  }
+}
+
+static std::vector<datetime::datetime> to_datetimes(const std::vector<long long>& timestamps) {
+  std::vector<datetime::datetime> v;
+  for (long long t : timestamps) {
+    v.push_back(datetime::datetime::utcfromtimestamp(std::chrono::microseconds{t}));
+  }
+  return v;
+}
+
+static void check_datetimes() {
+  std::mt19937_64 rng(51);
+  const long long first = datetime::datetime::min().utctimestamp().count();
+  const long long last = datetime::datetime::max().utctimestamp().count();
+  const long long open = datetime::datetime(2024, 1, 2, 9, 30).utctimestamp().count();
+  const std::size_t sizes[] = {0,    1,    kMinRadixSize - 1, kMinRadixSize, kMinRadixSize + 1,
+                               5000, kParallelSize};
+  for (std::size_t n : sizes) {
+    /* 年份1-9999，包括datetime::min()和datetime::max() */
+    auto all = to_datetimes(random_timestamps(n, rng, first, last));
+    if (n >= 2) {
+      all[n / 2] = datetime::datetime::min();
+      all[n / 3] = datetime::datetime::max();
+    }
+    check_radix_sort(all, "years 1-9999");
+    /* 一天以内 */
+    check_radix_sort(to_datetimes(random_timestamps(n, rng, open, open + 86400LL * 1000000 - 1)),
+                     "one day");
+    /* 只有微秒不同，只需要一趟 */
+    check_radix_sort(to_datetimes(random_timestamps(n, rng, open, open + 999)), "one pass");
+    check_radix_sort(std::vector<datetime::datetime>(n, datetime::datetime::max()), "all equal");
+  }
+}
+
+/* 参考结果：按序列的先后拼接后std::stable_sort，相等的元素按序列的先后以及在序列中的位置输出 */
+template <class T>
+static void check_merge(const std::vector<std::vector<T>>& runs, const std::string& what) {
+  std::vector<std::tuple<T, uint32_t>> expected;
+  std::vector<SortedRun<T>> sorted_runs;
+  for (std::size_t r = 0; r < runs.size(); ++r) {
+    for (const T& value : runs[r]) {
+      expected.emplace_back(value, static_cast<uint32_t>(r));
+    }
+    sorted_runs.push_back({runs[r].data(), runs[r].size()});
+  }
+  std::stable_sort(expected.begin(), expected.end(), [](const auto& lhs, const auto& rhs) {
+    return std::get<0>(lhs) < std::get<0>(rhs);
+  });
+
+  const T sentinel = [] {
+    if constexpr (std::is_same_v<T, long long>) {
+      return 0x5a5a5a5a5a5aLL;
+    } else {
+      return datetime::datetime(1234, 5, 6, 7, 8, 9, 10);
+    }
+  }();
+  for (unsigned num_threads : kThreads) {
+    /* 多写一个元素，检查没有写出界 */
+    std::vector<T> out(expected.size() + 1, sentinel);
+    std::vector<uint32_t> run_index(expected.size() + 1, UINT32_MAX);
+    datetime::merge_sorted(sorted_runs, out.data(), run_index.data(), num_threads);
+    bool ok = out.back() == sentinel && run_index.back() == UINT32_MAX;
+    for (std::size_t i = 0; ok && i < expected.size(); ++i) {
+      ok = out[i] == std::get<0>(expected[i]) && run_index[i] == std::get<1>(expected[i]);
+    }
+    /* 不需要run_index时结果相同 */
+    std::vector<T> values(expected.size(), sentinel);
+    datetime::merge_sorted(sorted_runs, values.data(), nullptr, num_threads);
+    ok = ok && std::equal(values.begin(), values.end(), out.begin());
+    if (!ok) {
+      test_fail(__FILE__, __LINE__,
+                fmt::format("merge_sorted {} k={} n={} threads={}", what, runs.size(),
+                            expected.size(), num_threads));
+    }
+  }
+}
+
+/* 把n个元素随机分给k个序列，每个序列排序 */
+template <class T>
+static std::vector<std::vector<T>> split_runs(const std::vector<T>& values, std::size_t k,
+                                              std::mt19937_64& rng) {
+  std::vector<std::vector<T>> runs(k);
+  for (const T& value : values) {
+    runs[rng() % k].push_back(value);
+  }
+  for (auto& run : runs) {
+    std::sort(run.begin(), run.end());
+  }
+  return runs;
+}
+
+static void check_merges() {
+  std::mt19937_64 rng(52);
+
+  /* 没有序列、空序列和只有一个元素的序列 */
+  check_merge(std::vector<std::vector<long long>>{}, "no runs");
+  check_merge(std::vector<std::vector<long long>>(3), "empty runs");
+  check_merge(std::vector<std::vector<long long>>{{}, {5}, {}, {5}, {-5}, {}}, "single runs");
+  check_merge(std::vector<std::vector<long long>>{{LLONG_MIN, 0, LLONG_MAX}}, "one run");
+  check_merge(std::vector<std::vector<long long>>{{LLONG_MAX}, {LLONG_MIN, LLONG_MAX}, {LLONG_MIN}},
+              "extremes");
+
+  for (std::size_t k : {std::size_t{2}, std::size_t{7}, std::size_t{64}, std::size_t{300}}) {
+    /* 取值很少，跨序列的相等元素很多，检查run_index的稳定性 */
+    check_merge(split_runs(random_timestamps(kParallelSize, rng, -3, 3), k, rng), "ties");
+    check_merge(split_runs(random_timestamps(kParallelSize, rng, LLONG_MIN, LLONG_MAX), k, rng),
+                "full range");
+    check_merge(split_runs(std::vector<long long>(kParallelSize, 7), k, rng), "all equal");
+    check_merge(split_runs(random_timestamps(k * 3, rng, -100, 100), k, rng), "short runs");
+  }
+
+  const long long open = datetime::datetime(2024, 1, 2, 9, 30).utctimestamp().count();
+  for (std::size_t k : {std::size_t{1}, std::size_t{8}, std::size_t{64}}) {
+    /* 精确到秒，10秒以内 */
+    auto seconds = random_timestamps(kParallelSize, rng, 0, 9);
+    for (auto& t : seconds) {
+      t = open + t * 1'000'000;
+    }
+    check_merge(split_runs(to_datetimes(seconds), k, rng), "datetime ties");
+  }
+  const auto min = datetime::datetime::min();
+  const auto max = datetime::datetime::max();
+  check_merge(std::vector<std::vector<datetime::datetime>>{{}, {min, max}, {max}, {min}},
+              "datetime extremes");
+}
+
+int main() {
+  check_timestamps();
+  check_datetimes();
+  check_merges();
+  return test_result("test_datetime_sort");
+}
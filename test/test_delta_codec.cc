@@ -0,0 +1,185 @@
+// delta_encoder/delta_decoder的往返：零差值、每种编码宽度的边界、64位的转义编码以及截断的输入
+
+#include <climits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+#include "delta_codec.h"
+#include "test_check.h"
+
+using datetime::delta_decoder;
+using datetime::delta_encoder;
+
+static std::vector<long long> decode(const std::vector<uint8_t>& bytes) {
+  delta_decoder dec(bytes);
+  std::vector<long long> out;
+  long long us;
+  while (dec.next(&us)) {
+    out.push_back(us);
+  }
+  return out;
+}
+
+static std::vector<uint8_t> encode(const std::vector<long long>& values) {
+  delta_encoder enc;
+  enc.append(values.data(), values.size());
+  return enc.finish();
+}
+
+static void check_round_trip(const std::vector<long long>& values) {
+  auto bytes = encode(values);
+  EXPECT_TRUE(decode(bytes) == values);
+
+  /* 批量解码，每次的个数不同 */
+  delta_decoder dec(bytes);
+  EXPECT_EQ(dec.size(), values.size());
+  std::vector<long long> out(values.size() + 1);
+  std::size_t n = 0;
+  for (std::size_t step = 1; n < values.size(); ++step) {
+    n += dec.next(out.data() + n, step);
+  }
+  EXPECT_EQ(dec.next(out.data() + n, 1), std::size_t{0});
+  out.resize(n);
+  EXPECT_TRUE(out == values);
+}
+
+/* 间隔固定的序列，第二个值之后每个值1位 */
+static void check_zero_deltas() {
+  check_round_trip({});
+  check_round_trip({42});
+  check_round_trip({7, 7, 7, 7, 7});
+
+  std::vector<long long> values;
+  for (long long t = 1'700'000'000'000'000; values.size() < 1001; t += 1000) {
+    values.push_back(t);
+  }
+  check_round_trip(values);
+  /* 头部8字节 + 第一个值64位 + 第二个值z = 2000为'110' + 12位 + 999个'0' */
+  EXPECT_EQ(encode(values).size(), std::size_t{8 + (64 + 15 + 999 + 7) / 8});
+}
+
+/* 两个值[0, d]时只有一个delta-of-delta，即d本身 */
+static void check_widths() {
+  struct Case {
+    long long dod;
+    int bits;
+  };
+  const Case cases[] = {
+      {0, 1},
+      {1, 2 + 7},
+      {-1, 2 + 7},
+      {63, 2 + 7},
+      {-64, 2 + 7},
+      {64, 3 + 12},
+      {-65, 3 + 12},
+      {2047, 3 + 12},
+      {-2048, 3 + 12},
+      {2048, 4 + 20},
+      {(1 << 19) - 1, 4 + 20},
+      {-(1 << 19), 4 + 20},
+      {1 << 19, 5 + 32},
+      {-(1 << 19) - 1, 5 + 32},
+      {(1LL << 31) - 1, 5 + 32},
+      {-(1LL << 31), 5 + 32},
+      {1LL << 31, 5 + 64},
+      {-(1LL << 31) - 1, 5 + 64},
+      {LLONG_MAX, 5 + 64},
+      {LLONG_MIN, 5 + 64},
+  };
+  for (const auto& c : cases) {
+    std::vector<long long> values = {0, c.dod};
+    EXPECT_EQ(encode(values).size(), static_cast<std::size_t>(8 + (64 + c.bits + 7) / 8));
+    check_round_trip(values);
+    /* 非零的第一个值，以及之后再回到固定间隔，与编码一样按64位回绕计算 */
+    auto at = [&](uint64_t k) {
+      return static_cast<long long>(k * static_cast<uint64_t>(c.dod) - 5);
+    };
+    check_round_trip({at(0), at(1), at(2), at(3)});
+  }
+}
+
+/* 差值按64位回绕计算 */
+static void check_escape() {
+  check_round_trip({LLONG_MIN, LLONG_MAX, LLONG_MIN, 0, LLONG_MAX, LLONG_MAX, -1, 1});
+  check_round_trip({LLONG_MAX, LLONG_MIN, LLONG_MAX});
+
+  std::mt19937_64 rng(37);
+  std::vector<long long> values;
+  for (int i = 0; i < 5000; ++i) {
+    /* 在各种宽度之间随机 */
+    int width = static_cast<int>(rng() % 64);
+    uint64_t prev = values.empty() ? 0 : static_cast<uint64_t>(values.back());
+    uint64_t next = i % 7 == 0 ? rng() : prev + (rng() >> width) - (rng() >> width);
+    values.push_back(static_cast<long long>(next));
+  }
+  check_round_trip(values);
+}
+
+static void check_datetime() {
+  std::vector<datetime::datetime> dts = {datetime::datetime::min(), datetime::datetime(2024, 2, 29),
+                                         datetime::datetime::max()};
+  delta_encoder enc;
+  for (const auto& dt : dts) {
+    enc.append(dt);
+  }
+  delta_decoder dec(enc.finish());
+  datetime::datetime dt = datetime::datetime::min();
+  for (const auto& expected : dts) {
+    EXPECT_TRUE(dec.next(&dt));
+    EXPECT_EQ(dt, expected);
+  }
+  EXPECT_TRUE(!dec.next(&dt));
+
+  /* delta_decoder不复制数据，bytes需要比它活得更久 */
+  auto bytes = encode({LLONG_MAX});
+  delta_decoder out_of_range(bytes);
+  EXPECT_THROW(out_of_range.next(&dt), std::out_of_range);
+}
+
+/* 每一种长度的截断都在构造或解码时报错 */
+static void check_truncated() {
+  std::vector<long long> values = {0, 1, 1, 100, 5000, 5000, 1LL << 40, -3, -3, -3};
+  auto bytes = encode(values);
+  for (std::size_t size = 0; size < bytes.size(); ++size) {
+    /* 复制到恰好size字节的缓冲区，越界读会被ASan发现 */
+    std::vector<uint8_t> prefix(bytes.begin(), bytes.begin() + size);
+    std::unique_ptr<delta_decoder> dec;
+    try {
+      dec = std::make_unique<delta_decoder>(prefix);
+    } catch (const std::invalid_argument&) {
+      continue;
+    }
+    long long us;
+    bool thrown = false;
+    try {
+      while (dec->next(&us)) {
+      }
+    } catch (const std::invalid_argument&) {
+      thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+    /* 报错之后再调用仍然报错 */
+    EXPECT_THROW(dec->next(&us), std::invalid_argument);
+    EXPECT_THROW(dec->next(&us), std::invalid_argument);
+    EXPECT_THROW(dec->next(&us, 3), std::invalid_argument);
+  }
+
+  /* 头部声明的个数超出数据长度 */
+  auto header = bytes;
+  header[0] = 0;
+  header[1] = 0x10;
+  EXPECT_THROW(delta_decoder(header.data(), header.size()), std::invalid_argument);
+  header[1] = 0;
+  header[7] = 0x80;
+  EXPECT_THROW(delta_decoder(header.data(), header.size()), std::invalid_argument);
+}
+
+int main() {
+  check_zero_deltas();
+  check_widths();
+  check_escape();
+  check_datetime();
+  check_truncated();
+  return test_result("test_delta_codec");
+}
@@ -0,0 +1,269 @@
+// isoformat/str与fmt::format比较，strftime的每个格式化符号与C库strftime比较，
+// 批量格式化到StringColumn的offsets，以及pmr重载只从给定的memory_resource分配内存
+
+#include <chrono>
+#include <ctime>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "datetime.h"
+#include "test_check.h"
+
+namespace chrono = std::chrono;
+
+/* C locale下的std::strftime，年份不小于1000时与datetime::strftime的结果相同 */
+static std::string reference_strftime(const datetime::datetime& dt, const std::string& format) {
+  chrono::sys_days sd{chrono::year{dt.year()} / dt.month() / dt.day()};
+  std::tm tm{};
+  tm.tm_year = dt.year() - 1900;
+  tm.tm_mon = dt.month() - 1;
+  tm.tm_mday = dt.day();
+  tm.tm_hour = dt.hour();
+  tm.tm_min = dt.minute();
+  tm.tm_sec = dt.second();
+  tm.tm_wday = static_cast<int>(chrono::weekday{sd}.c_encoding());
+  tm.tm_yday = (sd - chrono::sys_days{chrono::year{dt.year()} / 1 / 1}).count();
+  char buf[512];
+  std::size_t n = std::strftime(buf, sizeof(buf), format.c_str(), &tm);
+  return std::string(buf, n);
+}
+
+static const char* const kDirectives[] = {"%a", "%A", "%w", "%d", "%b", "%B", "%m",
+                                          "%y", "%Y", "%H", "%I", "%p", "%M", "%S",
+                                          "%j", "%U", "%W", "%c", "%x", "%X", "%%"};
+
+static std::vector<datetime::datetime> sample_datetimes() {
+  std::vector<datetime::datetime> values;
+  /* 每年的第一周和最后一周，覆盖年初的星期为一周中的每一天 */
+  for (int y = 2000; y <= 2014; ++y) {
+    for (int d = 1; d <= 8; ++d) {
+      values.emplace_back(y, 1, d, (d * 5) % 24, d * 7, d * 3, d * 111111 % 1000000);
+      values.emplace_back(y, 12, 23 + d, (d * 7 + 11) % 24, 59, 59, 999999);
+    }
+  }
+  std::mt19937_64 rng(49);
+  for (int i = 0; i < 5000; ++i) {
+    int y = 1000 + static_cast<int>(rng() % 9000);
+    int m = 1 + static_cast<int>(rng() % 12);
+    int d = 1 + static_cast<int>(rng() % datetime::days_in_month(y, m));
+    values.emplace_back(y, m, d, static_cast<int>(rng() % 24), static_cast<int>(rng() % 60),
+                        static_cast<int>(rng() % 60), static_cast<int>(rng() % 1000000));
+  }
+  values.emplace_back(9999, 12, 31, 23, 59, 59, 999999);
+  values.emplace_back(2024, 2, 29, 0, 0, 0, 0);
+  values.emplace_back(2024, 2, 29, 12, 0, 0, 0);
+  return values;
+}
+
+static void check_directives() {
+  for (const auto& dt : sample_datetimes()) {
+    for (const char* directive : kDirectives) {
+      EXPECT_EQ(dt.strftime(directive), reference_strftime(dt, directive));
+    }
+    EXPECT_EQ(dt.strftime("%f"), fmt::format("{:06d}", dt.microsecond()));
+    EXPECT_EQ(dt.strftime("[%Y-%m-%d %H:%M:%S.%f] %"
+                          "%"),
+              fmt::format("[{}.{:06d}] %", reference_strftime(dt, "%Y-%m-%d %H:%M:%S"),
+                          dt.microsecond()));
+  }
+
+  /* 年份不足4位时补0，%c中的日期不足2位时补空格 */
+  datetime::datetime first(1, 1, 1);
+  EXPECT_EQ(first.strftime("%Y %y %j %U %W %a %w"), "0001 01 001 00 01 Mon 1");
+  EXPECT_EQ(first.strftime("%c"), "Mon Jan  1 00:00:00 0001");
+  EXPECT_EQ(first.strftime("%x %X %I%p"), "01/01/01 00:00:00 12AM");
+  /* 不支持的时区 */
+  EXPECT_EQ(first.strftime("a%zb%Zc"), "abc");
+  EXPECT_EQ(first.strftime(""), "");
+
+  /* 结尾的'%'以及未知的格式化符号 */
+  EXPECT_THROW(first.strftime("%Y%"), std::invalid_argument);
+  EXPECT_THROW(first.strftime("%"), std::invalid_argument);
+  EXPECT_THROW(first.strftime("%Q"), std::invalid_argument);
+  EXPECT_THROW(first.strftime(std::string("%\0", 2)), std::invalid_argument);
+
+  /* date和time的strftime */
+  EXPECT_EQ(datetime::date(2024, 2, 29).strftime("%A %d %B %Y"), "Thursday 29 February 2024");
+  EXPECT_EQ(datetime::time(13, 5, 9, 7).strftime("%I:%M:%S.%f %p"), "01:05:09.000007 PM");
+}
+
+/* 查表格式化的isoformat/str与fmt::format的结果相同，包括年份和微秒的两端 */
+static void check_isoformat() {
+  char buf[datetime::datetime::kMaxStrSize];
+  for (int y : {1, 9, 10, 99, 100, 999, 1000, 1970, 2024, 9999}) {
+    for (int m = 1; m <= 12; ++m) {
+      for (int d : {1, 9, 10, 28, datetime::days_in_month(y, m)}) {
+        datetime::date date(y, m, d);
+        auto expected_date = fmt::format("{:04d}-{:02d}-{:02d}", y, m, d);
+        EXPECT_EQ(date.isoformat(), expected_date);
+        EXPECT_EQ(date.str(), expected_date);
+        EXPECT_EQ(std::string(buf, date.isoformat(buf)), expected_date);
+
+        for (int h : {0, 9, 10, 23}) {
+          for (int mi : {0, 59}) {
+            for (int sec : {0, 59}) {
+              for (int us : {0, 1, 9, 10, 123456, 999999}) {
+                datetime::time t(h, mi, sec, us);
+                std::string expected_time =
+                    us != 0 ? fmt::format("{:02d}:{:02d}:{:02d}.{:06d}", h, mi, sec, us)
+                            : fmt::format("{:02d}:{:02d}:{:02d}", h, mi, sec);
+                EXPECT_EQ(t.isoformat(), expected_time);
+                EXPECT_EQ(t.str(), expected_time);
+                EXPECT_EQ(std::string(buf, t.isoformat(buf)), expected_time);
+
+                auto expected = fmt::format("{}T{}", expected_date, expected_time);
+                datetime::datetime dt(y, m, d, h, mi, sec, us);
+                EXPECT_EQ(dt.str(), expected);
+                EXPECT_EQ(std::string(buf, dt.str(buf)), expected);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/* 超出栈上缓冲区的结果分多次追加 */
+static std::string long_format() {
+  std::string format;
+  for (int i = 0; i < 40; ++i) {
+    format += "%A, %B %d %Y %c|";
+  }
+  return format + std::string(300, 'x') + "%f";
+}
+
+static void check_offsets(const datetime::StringColumn& column,
+                          const std::vector<std::string>& expected) {
+  EXPECT_EQ(column.size(), expected.size());
+  EXPECT_EQ(column.offsets.size(), expected.size() + 1);
+  EXPECT_EQ(column.offsets.empty() ? -1 : column.offsets[0], int64_t{0});
+  EXPECT_EQ(column.offsets.back(), static_cast<int64_t>(column.chars.size()));
+  EXPECT_EQ(column.empty(), expected.empty());
+  int64_t total = 0;
+  for (std::size_t i = 0; i < expected.size() && i < column.size(); ++i) {
+    total += static_cast<int64_t>(expected[i].size());
+    EXPECT_EQ(column.offsets[i + 1], total);
+    EXPECT_EQ(column[i], std::string_view(expected[i]));
+  }
+}
+
+static void check_string_column() {
+  auto values = sample_datetimes();
+  const std::string format = long_format();
+  std::vector<datetime::date> dates;
+  std::vector<datetime::time> times;
+  for (const auto& dt : values) {
+    dates.push_back(dt.date());
+    times.push_back(dt.time());
+  }
+
+  datetime::StringColumn column;
+  check_offsets(column, {});
+  std::vector<std::string> expected;
+
+  /* 追加到同一列中，offsets接着之前的结果 */
+  datetime::str(values.data(), values.size(), &column);
+  for (const auto& dt : values) {
+    expected.push_back(dt.str());
+  }
+  datetime::isoformat(dates.data(), dates.size(), &column);
+  for (const auto& d : dates) {
+    expected.push_back(d.isoformat());
+  }
+  datetime::isoformat(times.data(), times.size(), &column);
+  for (const auto& t : times) {
+    expected.push_back(t.isoformat());
+  }
+  datetime::strftime(values.data(), values.size(), format, &column);
+  for (const auto& dt : values) {
+    expected.push_back(dt.strftime(format));
+  }
+  datetime::strftime(values.data(), 0, format, &column);
+  datetime::strftime(values.data(), values.size(), "", &column);
+  expected.insert(expected.end(), values.size(), "");
+  check_offsets(column, expected);
+
+  /* 不合法的format在中途抛出异常时列不变 */
+  auto chars = column.chars.size();
+  EXPECT_THROW(datetime::strftime(values.data(), values.size(), "%Y%", &column),
+               std::invalid_argument);
+  EXPECT_EQ(column.chars.size(), chars);
+  check_offsets(column, expected);
+
+  column.clear();
+  check_offsets(column, {});
+  datetime::str(values.data(), 1, &column);
+  check_offsets(column, {values[0].str()});
+}
+
+/* 转发到upstream并记录分配次数 */
+class counting_resource : public std::pmr::memory_resource {
+ public:
+  explicit counting_resource(std::pmr::memory_resource* upstream) : upstream_(upstream) {}
+  long allocations = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    return upstream_->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+    upstream_->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource* upstream_;
+};
+
+/* 默认的resource为null_memory_resource，任何不经过给定resource的分配都会抛出std::bad_alloc */
+static void check_pmr() {
+  auto values = sample_datetimes();
+  const std::string format = long_format();
+  const std::string short_format = "%Y-%m-%d %H:%M:%S.%f and some text after it";
+  auto* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+
+  static char storage[16 << 20];
+  std::pmr::monotonic_buffer_resource arena(storage, sizeof(storage),
+                                            std::pmr::null_memory_resource());
+  counting_resource counting(&arena);
+  try {
+    const auto& dt = values[5];
+    EXPECT_EQ(dt.str(&counting), std::pmr::string(dt.str().c_str(), &counting));
+    EXPECT_EQ(dt.strftime(short_format, &counting).size(), dt.strftime(short_format).size());
+    EXPECT_EQ(dt.strftime(format, &counting).size(), dt.strftime(format).size());
+    EXPECT_EQ(dt.date().isoformat(&counting).size(), std::size_t{10});
+    EXPECT_EQ(dt.date().strftime(short_format, &counting).size(),
+              dt.date().strftime(short_format).size());
+    EXPECT_EQ(dt.time().isoformat(&counting).size(), dt.time().isoformat().size());
+    EXPECT_EQ(dt.time().strftime(short_format, &counting).size(),
+              dt.time().strftime(short_format).size());
+    /* 超出短字符串长度的结果都从counting分配 */
+    EXPECT_TRUE(counting.allocations >= 4);
+
+    datetime::StringColumn column(&counting);
+    datetime::str(values.data(), values.size(), &column);
+    datetime::strftime(values.data(), values.size(), short_format, &column);
+    std::vector<datetime::date> dates(1, values[0].date());
+    datetime::isoformat(dates.data(), 0, &column);
+    EXPECT_EQ(column.size(), 2 * values.size());
+    std::pmr::memory_resource* resource = &counting;
+    EXPECT_EQ(column.chars.get_allocator().resource(), resource);
+  } catch (const std::bad_alloc&) {
+    test_fail(__FILE__, __LINE__, "allocated from the default memory resource");
+  }
+  std::pmr::set_default_resource(previous);
+}
+
+int main() {
+  check_isoformat();
+  check_directives();
+  check_string_column();
+  check_pmr();
+  return test_result("test_format");
+}
@@ -0,0 +1,102 @@
+// detail::parse_digits<N>与原来逐字符的解析比较：每一个N位数字串、每个位置上的每个非数字字节
+
+#include <random>
+#include <string>
+
+#include "parse_digits.h"
+#include "test_check.h"
+
+/* SWAR之前的实现 */
+static const char* scalar_parse_digits(const char* ptr, int* var, std::size_t num_digits) {
+  for (std::size_t i = 0; i < num_digits; ++i) {
+    unsigned int tmp = (unsigned int)(*(ptr++) - '0');
+    if (tmp > 9) {
+      return nullptr;
+    }
+    *var *= 10;
+    *var += (signed int)tmp;
+  }
+  return ptr;
+}
+
+template <int N>
+static void compare(const char* p) {
+  int expected = 0;
+  bool expected_ok = scalar_parse_digits(p, &expected, N) != nullptr;
+  int value = -1;
+  bool ok = datetime::detail::parse_digits<N>(p, &value);
+  if (ok != expected_ok || (ok && value != expected)) {
+    std::string bytes;
+    for (int i = 0; i < N; ++i) {
+      bytes += fmt::format("{:02x}", static_cast<unsigned char>(p[i]));
+    }
+    test_fail(__FILE__, __LINE__,
+              fmt::format("parse_digits<{}>({}): {} {} vs {} {}", N, bytes, ok, value, expected_ok,
+                          expected));
+  }
+}
+
+template <int N>
+static void check() {
+  /* 结果只能依赖这N个字节，前后的字节设为会被误当作数字的值 */
+  char buf[N + 2];
+  buf[0] = '9';
+  buf[N + 1] = '9';
+  char* p = buf + 1;
+
+  int limit = 1;
+  for (int i = 0; i < N; ++i) {
+    limit *= 10;
+  }
+  /* 每一个N位数字串，包括前导的0 */
+  for (int n = 0; n < limit; ++n) {
+    int v = n;
+    for (int i = N - 1; i >= 0; --i) {
+      p[i] = static_cast<char>('0' + v % 10);
+      v /= 10;
+    }
+    compare<N>(p);
+  }
+
+  /* 每个位置上的每个字节，其他位置为随机的数字，':'和'/'是与数字相邻的字节 */
+  std::mt19937 rng(46 + N);
+  for (int pos = 0; pos < N; ++pos) {
+    for (int byte = 0; byte < 256; ++byte) {
+      for (int trial = 0; trial < 4; ++trial) {
+        for (int i = 0; i < N; ++i) {
+          p[i] = static_cast<char>('0' + rng() % 10);
+        }
+        p[pos] = static_cast<char>(byte);
+        compare<N>(p);
+      }
+    }
+    for (char c : {':', '/', ' ', '-', '.', '\0'}) {
+      for (int i = 0; i < N; ++i) {
+        p[i] = i == pos ? c : '0';
+      }
+      compare<N>(p);
+      p[N - 1 - (pos == N - 1)] = '9';
+      compare<N>(p);
+    }
+  }
+
+  /* 任意的字节串 */
+  for (int trial = 0; trial < 100000; ++trial) {
+    for (int i = 0; i < N; ++i) {
+      p[i] = static_cast<char>(rng() % 4 ? '0' + rng() % 12 - 1 : rng());
+    }
+    compare<N>(p);
+  }
+}
+
+int main() {
+  check<1>();
+  check<2>();
+  check<3>();
+  check<4>();
+  check<5>();
+  check<6>();
+  check<7>();
+  check<8>();
+  return test_result("test_parse_digits");
+}
@@ -0,0 +1,137 @@
+// resampler的分桶边界、交易时段(含跨越0点的夜盘)以及没有tick的区间，与手算的结果比较
+
+#include <stdexcept>
+
+#include "resampler.h"
+#include "test_check.h"
+
+using datetime::resampler;
+using datetime::timedelta;
+
+static datetime::datetime at(int year, int month, int day, int hour = 0, int minute = 0,
+                             int second = 0, int microsecond = 0) {
+  return datetime::datetime(year, month, day, hour, minute, second, microsecond);
+}
+
+static void expect_bucket(const datetime::ResampleBucket& b, const ::datetime::datetime& start,
+                          const ::datetime::datetime& end, long count) {
+  EXPECT_EQ(b.start_time(), start);
+  EXPECT_EQ(b.end_time(), end);
+  EXPECT_EQ(b.count, count);
+}
+
+/* 没有交易时段：按分钟分桶，没有tick的分钟不会产生bucket */
+static void check_minutes() {
+  resampler r(timedelta(0, 60));
+  EXPECT_TRUE(!r.update(at(2024, 1, 2, 9, 30), 100));
+  EXPECT_TRUE(!r.update(at(2024, 1, 2, 9, 30, 59, 999999), 105));
+  EXPECT_TRUE(r.update(at(2024, 1, 2, 9, 31), 99));
+  const auto& b = r.closed();
+  expect_bucket(b, at(2024, 1, 2, 9, 30), at(2024, 1, 2, 9, 31), 2);
+  EXPECT_EQ(b.first, 100.0);
+  EXPECT_EQ(b.last, 105.0);
+  EXPECT_EQ(b.min, 100.0);
+  EXPECT_EQ(b.max, 105.0);
+  EXPECT_EQ(b.sum, 205.0);
+
+  /* 09:32-09:34没有tick，下一个bucket直接从09:35开始 */
+  EXPECT_TRUE(r.update(at(2024, 1, 2, 9, 35, 10), 101));
+  expect_bucket(r.closed(), at(2024, 1, 2, 9, 31), at(2024, 1, 2, 9, 32), 1);
+  expect_bucket(r.current(), at(2024, 1, 2, 9, 35), at(2024, 1, 2, 9, 36), 1);
+
+  /* advance在到达bucket的结束时间时才关闭 */
+  EXPECT_TRUE(!r.advance(at(2024, 1, 2, 9, 35, 59, 999999)));
+  EXPECT_TRUE(r.advance(at(2024, 1, 2, 9, 36)));
+  expect_bucket(r.closed(), at(2024, 1, 2, 9, 35), at(2024, 1, 2, 9, 36), 1);
+  EXPECT_TRUE(!r.has_current());
+  EXPECT_TRUE(!r.advance(at(2024, 1, 2, 10)));
+  EXPECT_TRUE(!r.flush());
+
+  /* 早于已关闭bucket的tick被丢弃 */
+  EXPECT_TRUE(!r.update(at(2024, 1, 2, 9, 35, 30), 1));
+  EXPECT_EQ(r.dropped(), 1L);
+  EXPECT_TRUE(!r.has_current());
+
+  EXPECT_TRUE(!r.update(at(2024, 1, 2, 9, 40), 1));
+  EXPECT_TRUE(r.flush());
+  expect_bucket(r.closed(), at(2024, 1, 2, 9, 40), at(2024, 1, 2, 9, 41), 1);
+}
+
+/* 不能整除一天的interval以0点对齐，bucket不跨越0点；不小于一天的interval以1970-01-01对齐 */
+static void check_alignment() {
+  resampler r(timedelta(0, 7 * 60));
+  r.update(at(2024, 1, 2, 23, 58), 1);
+  expect_bucket(r.current(), at(2024, 1, 2, 23, 55), at(2024, 1, 3), 1);
+  EXPECT_TRUE(r.update(at(2024, 1, 3, 0, 1), 2));
+  expect_bucket(r.current(), at(2024, 1, 3), at(2024, 1, 3, 0, 7), 1);
+
+  /* 2024-01-02是1970-01-01之后的第19724天 */
+  resampler days(timedelta(2));
+  days.update(at(2024, 1, 2, 8), 1);
+  days.update(at(2024, 1, 3, 23), 2);
+  expect_bucket(days.current(), at(2024, 1, 2), at(2024, 1, 4), 2);
+  EXPECT_TRUE(days.update(at(2024, 1, 4), 3));
+  expect_bucket(days.current(), at(2024, 1, 4), at(2024, 1, 6), 1);
+
+  /* 1970年之前 */
+  resampler hours(timedelta(0, 3600));
+  hours.update(at(1969, 12, 31, 23, 59, 59), 1);
+  expect_bucket(hours.current(), at(1969, 12, 31, 23), at(1970, 1, 1), 1);
+}
+
+/* 日盘09:00-11:30、13:30-15:00，夜盘21:00-02:30，按小时分桶 */
+static void check_sessions() {
+  resampler r(timedelta(0, 3600));
+  r.add_session(datetime::time(9), datetime::time(11, 30));
+  r.add_session(datetime::time(13, 30), datetime::time(15));
+  r.add_session(datetime::time(21), datetime::time(2, 30));
+
+  EXPECT_TRUE(!r.update(at(2024, 1, 2, 8, 59, 59), 1));
+  EXPECT_EQ(r.dropped(), 1L);
+
+  r.update(at(2024, 1, 2, 9), 1);
+  expect_bucket(r.current(), at(2024, 1, 2, 9), at(2024, 1, 2, 10), 1);
+
+  /* 最后一个bucket在收盘时截断 */
+  EXPECT_TRUE(r.update(at(2024, 1, 2, 11, 20), 2));
+  expect_bucket(r.current(), at(2024, 1, 2, 11), at(2024, 1, 2, 11, 30), 1);
+
+  /* 午休的tick关闭当前bucket并被丢弃 */
+  EXPECT_TRUE(r.update(at(2024, 1, 2, 12), 3));
+  expect_bucket(r.closed(), at(2024, 1, 2, 11), at(2024, 1, 2, 11, 30), 1);
+  EXPECT_EQ(r.dropped(), 2L);
+  EXPECT_TRUE(!r.has_current());
+
+  /* 以时段开始时间对齐，而不是整点 */
+  r.update(at(2024, 1, 2, 14, 40), 4);
+  expect_bucket(r.current(), at(2024, 1, 2, 14, 30), at(2024, 1, 2, 15), 1);
+  EXPECT_TRUE(r.update(at(2024, 1, 2, 15), 5));
+  EXPECT_EQ(r.dropped(), 3L);
+
+  /* 夜盘跨越0点，属于开盘的那一天 */
+  r.update(at(2024, 1, 2, 21), 6);
+  expect_bucket(r.current(), at(2024, 1, 2, 21), at(2024, 1, 2, 22), 1);
+  EXPECT_TRUE(r.update(at(2024, 1, 2, 23, 40), 7));
+  expect_bucket(r.current(), at(2024, 1, 2, 23), at(2024, 1, 3), 1);
+  EXPECT_TRUE(r.update(at(2024, 1, 3, 0, 10), 8));
+  expect_bucket(r.closed(), at(2024, 1, 2, 23), at(2024, 1, 3), 1);
+  expect_bucket(r.current(), at(2024, 1, 3), at(2024, 1, 3, 1), 1);
+  EXPECT_TRUE(r.update(at(2024, 1, 3, 2, 29, 59), 9));
+  expect_bucket(r.current(), at(2024, 1, 3, 2), at(2024, 1, 3, 2, 30), 1);
+
+  /* 收盘时间不属于时段 */
+  EXPECT_TRUE(r.update(at(2024, 1, 3, 2, 30), 10));
+  EXPECT_EQ(r.dropped(), 4L);
+  EXPECT_TRUE(!r.has_current());
+
+  EXPECT_THROW(r.add_session(datetime::time(10), datetime::time(10, 30)), std::invalid_argument);
+  EXPECT_THROW(r.add_session(datetime::time(2), datetime::time(3)), std::invalid_argument);
+  EXPECT_THROW(resampler(timedelta(0)), std::invalid_argument);
+}
+
+int main() {
+  check_minutes();
+  check_alignment();
+  check_sessions();
+  return test_result("test_resampler");
+}
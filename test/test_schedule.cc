@@ -0,0 +1,106 @@
+// schedule::next_after：日与星期同时限制时取并集、2月29日以及跨年，与手算的结果比较，
+// 并与逐分钟调用matches()的结果比较
+
+#include <stdexcept>
+
+#include "schedule.h"
+#include "test_check.h"
+
+using datetime::schedule;
+using datetime::timedelta;
+
+static datetime::datetime at(int year, int month, int day, int hour = 0, int minute = 0,
+                             int second = 0) {
+  return datetime::datetime(year, month, day, hour, minute, second);
+}
+
+static void check_day_or_weekday() {
+  /* 每月13日或者每周五 */
+  schedule both("0 0 13 * FRI");
+  EXPECT_EQ(both.next_after(at(2024, 9, 1)), at(2024, 9, 6));
+  EXPECT_EQ(both.next_after(at(2024, 9, 6)), at(2024, 9, 13));
+  EXPECT_EQ(both.next_after(at(2024, 9, 13)), at(2024, 9, 20));
+  /* 2024-10-13为周日 */
+  EXPECT_EQ(both.next_after(at(2024, 10, 11)), at(2024, 10, 13));
+  EXPECT_EQ(both.next_after(at(2024, 10, 13)), at(2024, 10, 18));
+  EXPECT_TRUE(both.matches(at(2024, 10, 13, 0, 0, 30)));
+  EXPECT_TRUE(!both.matches(at(2024, 10, 14)));
+
+  schedule day_only("0 0 13 * *");
+  EXPECT_EQ(day_only.next_after(at(2024, 9, 13)), at(2024, 10, 13));
+  schedule weekday_only("0 0 * * FRI");
+  EXPECT_EQ(weekday_only.next_after(at(2024, 10, 11)), at(2024, 10, 18));
+  /* 0和7都表示星期日 */
+  EXPECT_EQ(schedule("0 0 * * 7").next_after(at(2024, 10, 11)), at(2024, 10, 13));
+  EXPECT_EQ(schedule("0 0 * * 0").next_after(at(2024, 10, 11)), at(2024, 10, 13));
+
+  EXPECT_EQ(schedule("*/15 9-15 * * MON-FRI").next_after(at(2021, 8, 31, 15, 59, 55)),
+            at(2021, 9, 1, 9));
+}
+
+static void check_feb29() {
+  schedule leap("0 12 29 2 *");
+  EXPECT_EQ(leap.next_after(at(2021, 3, 1)), at(2024, 2, 29, 12));
+  EXPECT_EQ(leap.next_after(at(2024, 2, 29, 11, 59)), at(2024, 2, 29, 12));
+  EXPECT_EQ(leap.next_after(at(2024, 2, 29, 12)), at(2028, 2, 29, 12));
+  /* 2100年不是闰年 */
+  EXPECT_EQ(leap.next_after(at(2096, 3, 1)), at(2104, 2, 29, 12));
+
+  /* 同时限制星期时，2月的每个周一也会触发 */
+  schedule leap_or_monday("0 0 29 2 MON");
+  EXPECT_EQ(leap_or_monday.next_after(at(2024, 2, 26)), at(2024, 2, 29));
+  EXPECT_EQ(leap_or_monday.next_after(at(2024, 3, 1)), at(2025, 2, 3));
+
+  EXPECT_THROW(schedule("0 0 30 2 *"), std::invalid_argument);
+  EXPECT_THROW(schedule("0 0 31 4,6 *"), std::invalid_argument);
+  EXPECT_EQ(schedule("0 0 31 4,6,7 *").next_after(at(2024, 1, 1)), at(2024, 7, 31));
+}
+
+static void check_rollover() {
+  EXPECT_EQ(schedule("59 23 31 12 *").next_after(at(2024, 12, 31, 23, 59)),
+            at(2025, 12, 31, 23, 59));
+  EXPECT_EQ(schedule("0 0 1 1 *").next_after(at(2024, 12, 31, 23, 59)), at(2025, 1, 1));
+  EXPECT_EQ(schedule("@yearly").next_after(at(2025, 1, 1)), at(2026, 1, 1));
+  EXPECT_EQ(schedule("* * * * *").next_after(at(2024, 12, 31, 23, 59, 30)), at(2025, 1, 1));
+  EXPECT_EQ(schedule("30 8 * JAN MON").next_after(at(2024, 12, 31)), at(2025, 1, 6, 8, 30));
+  EXPECT_EQ(schedule("0 0 1 1 *").next_after(at(9998, 6, 1)), at(9999, 1, 1));
+  EXPECT_THROW(schedule("0 0 1 1 *").next_after(at(9999, 6, 1)), std::out_of_range);
+
+  EXPECT_THROW(schedule("60 * * * *"), std::invalid_argument);
+  EXPECT_THROW(schedule("* * * *"), std::invalid_argument);
+  EXPECT_THROW(schedule("* * * * * *"), std::invalid_argument);
+}
+
+/* 逐分钟查找第一个matches()的时间 */
+static datetime::datetime scan_next(const schedule& s, const datetime::datetime& dt) {
+  auto t = datetime::datetime(dt.year(), dt.month(), dt.day(), dt.hour(), dt.minute());
+  do {
+    t += timedelta(0, 60);
+  } while (!s.matches(t));
+  return t;
+}
+
+static void check_against_scan() {
+  const std::vector<std::string> exprs = {"0 0 13 * FRI", "*/7 3 * 2 MON", "15 10 29 2 *",
+                                          "0 9-17/4 1,15 * SAT,SUN", "@monthly"};
+  std::vector<schedule> schedules;
+  for (const auto& expr : exprs) {
+    schedules.emplace_back(expr);
+  }
+  for (auto dt = at(2023, 11, 30, 23, 58, 7); dt < at(2025, 3, 1); dt += timedelta(23, 3 * 3600)) {
+    auto batch = schedule::next_after(schedules, dt);
+    for (std::size_t i = 0; i < schedules.size(); ++i) {
+      auto next = schedules[i].next_after(dt);
+      EXPECT_EQ(next, scan_next(schedules[i], dt));
+      EXPECT_EQ(batch[i], next);
+    }
+  }
+}
+
+int main() {
+  check_day_or_weekday();
+  check_feb29();
+  check_rollover();
+  check_against_scan();
+  return test_result("test_schedule");
+}
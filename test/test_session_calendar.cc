@@ -0,0 +1,134 @@
+// session_calendar在时段边界上的查询以及跨越0点的交易时长，与手算的结果比较
+
+#include <stdexcept>
+
+#include "session_calendar.h"
+#include "test_check.h"
+
+using datetime::business_calendar;
+using datetime::date;
+using datetime::session_calendar;
+using datetime::timedelta;
+using datetime::TradingSession;
+
+static datetime::datetime at(int year, int month, int day, int hour = 0, int minute = 0,
+                             int second = 0, int microsecond = 0) {
+  return datetime::datetime(year, month, day, hour, minute, second, microsecond);
+}
+
+static timedelta minutes(int n) { return timedelta(0, n * 60); }
+
+/* 日盘09:00-11:30、13:30-15:00，夜盘21:00-02:30，每个交易日共9.5小时 */
+static const std::vector<TradingSession> kSessions = {
+    {datetime::time(21), datetime::time(2, 30)},
+    {datetime::time(9), datetime::time(11, 30)},
+    {datetime::time(13, 30), datetime::time(15)},
+};
+
+/* 2024-12-30(周一)至2025-01-03，2025-01-01休市，因此12-31的夜盘之后直到01-02 09:00没有时段 */
+static session_calendar make_calendar() {
+  business_calendar holidays({date(2025, 1, 1)});
+  return session_calendar(date(2024, 12, 30), date(2025, 1, 3), kSessions, holidays);
+}
+
+static void check_in_session() {
+  auto cal = make_calendar();
+  EXPECT_EQ(cal.size(), std::size_t{12});
+  EXPECT_EQ(session_calendar(date(2024, 12, 30), date(2025, 1, 3), kSessions).size(),
+            std::size_t{15});
+
+  /* open属于时段，close不属于 */
+  EXPECT_TRUE(!cal.in_session(at(2024, 12, 30, 8, 59, 59, 999999)));
+  EXPECT_TRUE(cal.in_session(at(2024, 12, 30, 9)));
+  EXPECT_TRUE(cal.in_session(at(2024, 12, 30, 11, 29, 59, 999999)));
+  EXPECT_TRUE(!cal.in_session(at(2024, 12, 30, 11, 30)));
+  EXPECT_TRUE(!cal.in_session(at(2024, 12, 30, 13, 29, 59, 999999)));
+  EXPECT_TRUE(cal.in_session(at(2024, 12, 30, 13, 30)));
+  EXPECT_TRUE(!cal.in_session(at(2024, 12, 30, 15)));
+
+  /* 夜盘跨越0点 */
+  EXPECT_TRUE(cal.in_session(at(2024, 12, 30, 21)));
+  EXPECT_TRUE(cal.in_session(at(2024, 12, 31)));
+  EXPECT_TRUE(cal.in_session(at(2025, 1, 1, 2, 29, 59, 999999)));
+  EXPECT_TRUE(!cal.in_session(at(2025, 1, 1, 2, 30)));
+
+  /* 休市日没有日盘和夜盘 */
+  EXPECT_TRUE(!cal.in_session(at(2025, 1, 1, 10)));
+  EXPECT_TRUE(!cal.in_session(at(2025, 1, 1, 21)));
+  EXPECT_TRUE(!cal.in_session(at(2025, 1, 2, 1)));
+
+  /* 范围之外 */
+  EXPECT_TRUE(!cal.in_session(at(2024, 12, 30, 1)));
+  EXPECT_TRUE(cal.in_session(at(2025, 1, 4, 2)));
+  EXPECT_TRUE(!cal.in_session(at(2025, 1, 4, 9)));
+}
+
+static void check_next_open_close() {
+  auto cal = make_calendar();
+  EXPECT_EQ(cal.next_open(at(2024, 12, 30, 8)), at(2024, 12, 30, 9));
+  /* 不含dt本身 */
+  EXPECT_EQ(cal.next_open(at(2024, 12, 30, 9)), at(2024, 12, 30, 13, 30));
+  EXPECT_EQ(cal.next_open(at(2024, 12, 30, 8, 59, 59, 999999)), at(2024, 12, 30, 9));
+  EXPECT_EQ(cal.next_open(at(2024, 12, 31, 23)), at(2025, 1, 2, 9));
+  EXPECT_EQ(cal.next_open(at(2025, 1, 3, 20)), at(2025, 1, 3, 21));
+  EXPECT_THROW(cal.next_open(at(2025, 1, 3, 21)), std::out_of_range);
+
+  EXPECT_EQ(cal.next_close(at(2024, 12, 30, 9)), at(2024, 12, 30, 11, 30));
+  EXPECT_EQ(cal.next_close(at(2024, 12, 30, 11, 29, 59, 999999)), at(2024, 12, 30, 11, 30));
+  EXPECT_EQ(cal.next_close(at(2024, 12, 30, 11, 30)), at(2024, 12, 30, 15));
+  EXPECT_EQ(cal.next_close(at(2024, 12, 30, 12)), at(2024, 12, 30, 15));
+  EXPECT_EQ(cal.next_close(at(2024, 12, 30, 23)), at(2024, 12, 31, 2, 30));
+  EXPECT_EQ(cal.next_close(at(2025, 1, 1, 2, 30)), at(2025, 1, 2, 11, 30));
+  EXPECT_EQ(cal.next_close(at(2024, 12, 1)), at(2024, 12, 30, 11, 30));
+  EXPECT_EQ(cal.next_close(at(2025, 1, 4, 2)), at(2025, 1, 4, 2, 30));
+  EXPECT_THROW(cal.next_close(at(2025, 1, 4, 2, 30)), std::out_of_range);
+}
+
+static void check_trading_time_between() {
+  auto cal = make_calendar();
+  /* 跨越0点 */
+  EXPECT_EQ(cal.trading_time_between(at(2024, 12, 30, 23), at(2024, 12, 31, 1)), minutes(120));
+  EXPECT_EQ(cal.trading_time_between(at(2024, 12, 30, 21), at(2024, 12, 31, 2, 30)),
+            minutes(330));
+  EXPECT_EQ(cal.trading_time_between(at(2024, 12, 31, 1), at(2024, 12, 30, 23)), minutes(-120));
+  /* 10:00-11:30, 13:30-15:00, 21:00-02:30, 09:00-10:00 */
+  EXPECT_EQ(cal.trading_time_between(at(2024, 12, 30, 10), at(2024, 12, 31, 10)), minutes(570));
+  /* 跨越休市日：12-31 22:00-02:30, 01-02 09:00-10:00 */
+  EXPECT_EQ(cal.trading_time_between(at(2024, 12, 31, 22), at(2025, 1, 2, 10)), minutes(330));
+
+  /* 端点在时段之外或恰好在时段边界上 */
+  EXPECT_EQ(cal.trading_time_between(at(2024, 12, 30, 12), at(2024, 12, 30, 14)), minutes(30));
+  EXPECT_EQ(cal.trading_time_between(at(2024, 12, 30, 11, 30), at(2024, 12, 30, 13, 30)),
+            minutes(0));
+  EXPECT_EQ(cal.trading_time_between(at(2024, 12, 30, 9), at(2024, 12, 30, 11, 30)),
+            minutes(150));
+  EXPECT_EQ(cal.trading_time_between(at(2024, 12, 30, 9), at(2024, 12, 30, 9)), minutes(0));
+  EXPECT_EQ(cal.trading_time_between(at(2024, 12, 30, 9), at(2024, 12, 30, 9, 0, 0, 1)),
+            timedelta(0, 0, 1));
+  EXPECT_EQ(cal.trading_time_between(at(2024, 12, 1), at(2024, 12, 30, 9, 30)), minutes(30));
+  EXPECT_EQ(cal.trading_time_between(at(2024, 12, 1), at(2025, 2, 1)), minutes(4 * 570));
+}
+
+static void check_invalid() {
+  EXPECT_THROW(session_calendar(date(2025, 1, 2), date(2025, 1, 1), kSessions),
+               std::invalid_argument);
+  EXPECT_THROW(session_calendar(date(2025, 1, 1), date(2025, 1, 1),
+                                {{datetime::time(9), datetime::time(11, 30)},
+                                 {datetime::time(11), datetime::time(12)}}),
+               std::invalid_argument);
+  /* 夜盘与第二天的日盘重叠 */
+  std::vector<TradingSession> sessions = {{datetime::time(21), datetime::time(9, 30)},
+                                          {datetime::time(9), datetime::time(11, 30)}};
+  session_calendar one_day(date(2025, 1, 1), date(2025, 1, 1), sessions);
+  EXPECT_EQ(one_day.size(), std::size_t{2});
+  EXPECT_THROW(session_calendar(date(2025, 1, 1), date(2025, 1, 2), sessions),
+               std::invalid_argument);
+}
+
+int main() {
+  check_in_session();
+  check_next_open_close();
+  check_trading_time_between();
+  check_invalid();
+  return test_result("test_session_calendar");
+}
@@ -0,0 +1,138 @@
+// 多线程压力测试，配合-DDATETIME_TSAN=ON使用ThreadSanitizer检查数据竞争
+// 先在单线程下算出每个样本的结果，然后多个线程以不同的顺序并发调用同一组函数，
+// 结果必须与单线程一致。覆盖依赖localtime_r等共享状态的now()、today()、fromtimestamp()、
+// timestamp()，以及strftime/strptime这类会用到全局locale的格式化函数。
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "datetime.h"
+
+static constexpr int kSamples = 2048;
+static constexpr int kRounds = 8;
+static constexpr int kMaxReports = 20;
+
+static std::atomic<long> g_failures{0};
+static std::mutex g_report_mutex;
+
+static void report(const std::string& what) {
+  if (g_failures.fetch_add(1) < kMaxReports) {
+    std::lock_guard<std::mutex> lock(g_report_mutex);
+    std::fprintf(stderr, "MISMATCH: %s\n", what.c_str());
+  }
+}
+
+struct Sample {
+  std::chrono::microseconds ts;
+  datetime::datetime local;
+  datetime::date local_date;
+  std::chrono::microseconds local_ts;
+  datetime::datetime utc;
+  std::string formatted;
+};
+
+static const char* kFormat = "%Y-%m-%d %H:%M:%S.%f";
+
+static Sample make_sample(std::chrono::microseconds ts) {
+  auto local = datetime::datetime::fromtimestamp(ts);
+  return Sample{ts,
+                local,
+                datetime::date::fromtimestamp(ts),
+                local.timestamp(),
+                datetime::datetime::utcfromtimestamp(ts),
+                local.strftime(kFormat)};
+}
+
+static void check_sample(const Sample& s) {
+  auto local = datetime::datetime::fromtimestamp(s.ts);
+  if (local != s.local) {
+    report("fromtimestamp: " + local.str() + " vs " + s.local.str());
+  }
+  if (datetime::date::fromtimestamp(s.ts) != s.local_date) {
+    report("date::fromtimestamp: " + s.local.str());
+  }
+  if (local.timestamp() != s.local_ts) {
+    report("timestamp: " + s.local.str());
+  }
+  if (datetime::datetime::utcfromtimestamp(s.ts) != s.utc) {
+    report("utcfromtimestamp: " + s.utc.str());
+  }
+  if (local.strftime(kFormat) != s.formatted) {
+    report("strftime: " + s.formatted);
+  }
+  if (datetime::datetime::strptime(s.formatted, kFormat) != s.local) {
+    report("strptime: " + s.formatted);
+  }
+}
+
+static void worker(const std::vector<Sample>& samples, unsigned seed) {
+  std::vector<int> order(samples.size());
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    order[i] = static_cast<int>(i);
+  }
+  std::mt19937 rng(seed);
+
+  for (int round = 0; round < kRounds; ++round) {
+    std::shuffle(order.begin(), order.end(), rng);
+    for (int i : order) {
+      check_sample(samples[i]);
+
+      if (i % 64 == 0) {
+        /* today()与now()分别调用，中间可能恰好跨过午夜 */
+        auto today = datetime::date::today();
+        auto now = datetime::datetime::now();
+        if (now.date() != today && now.date() - today != datetime::timedelta(1)) {
+          report("today/now: " + today.str() + " vs " + now.str());
+        }
+      }
+    }
+  }
+}
+
+int main() {
+  /* 使用有夏令时的时区，让timestamp()走到local_to_seconds中处理夏令时的分支 */
+  setenv("TZ", "America/New_York", 1);
+  tzset();
+
+  std::vector<Sample> samples;
+  std::mt19937_64 rng(2024);
+  long long first = datetime::datetime(1971, 1, 1).utctimestamp().count();
+  long long last = datetime::datetime(2100, 1, 1).utctimestamp().count();
+  std::uniform_int_distribution<long long> us(first, last);
+  for (int i = 0; i < kSamples; ++i) {
+    samples.push_back(make_sample(std::chrono::microseconds{us(rng)}));
+  }
+
+  /* 单核机器上也用多个线程，依靠抢占制造交错 */
+  unsigned num_threads = std::max(8u, 2 * std::thread::hardware_concurrency());
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < num_threads; ++i) {
+    threads.emplace_back(worker, std::cref(samples), i);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+  std::printf("threads: %u, calls: %ld in %lld ms\n", num_threads,
+              static_cast<long>(num_threads) * kRounds * kSamples * 6, static_cast<long long>(ms));
+
+
+  long failures = g_failures.load();
+  if (failures != 0) {
+    std::fprintf(stderr, "%ld mismatches\n", failures);
+    return 1;
+  }
+  return 0;
+}
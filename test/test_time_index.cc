@@ -0,0 +1,181 @@
+// time_index_writer生成的索引项，以及time_index::seek在第一个、最后一个、不存在和重复的时间上的结果
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+
+#include "test_check.h"
+#include "time_index.h"
+
+using datetime::time_index;
+using datetime::time_index_writer;
+
+struct Record {
+  long long timestamp;
+  uint64_t offset;
+};
+
+static std::string index_path() {
+  return (std::filesystem::temp_directory_path() / "test_time_index.idx").string();
+}
+
+static time_index build(const std::vector<Record>& records, uint64_t block_size) {
+  time_index_writer writer(index_path(), block_size);
+  for (const auto& r : records) {
+    writer.add(r.timestamp, r.offset);
+  }
+  writer.close();
+  return time_index(index_path());
+}
+
+/* seek的结果是一个索引项的偏移，之前的记录都早于ts，第一条不早于ts的记录不晚于下一个索引项 */
+static void check_seek(const time_index& index, const std::vector<Record>& records, long long ts) {
+  uint64_t offset = index.seek(ts);
+  std::size_t entry = 0;
+  while (entry < index.size() && index.offset(entry) != offset) {
+    ++entry;
+  }
+  EXPECT_TRUE(entry < index.size());
+  auto first = std::find_if(records.begin(), records.end(),
+                            [&](const Record& r) { return r.timestamp >= ts; });
+  for (auto it = records.begin(); it != records.end() && it->offset < offset; ++it) {
+    EXPECT_TRUE(it->timestamp < ts);
+  }
+  if (first != records.end() && entry + 1 < index.size()) {
+    EXPECT_TRUE(first->offset <= index.offset(entry + 1));
+  }
+}
+
+/* block_size为100时，偏移0、120、230、330的记录生成索引项 */
+static void check_builder() {
+  const std::vector<Record> records = {{1000, 0},   {1010, 40},  {1020, 80},  {1030, 120},
+                                       {1030, 160}, {1030, 200}, {1030, 230}, {1050, 330}};
+  auto index = build(records, 100);
+  EXPECT_EQ(index.size(), std::size_t{4});
+  EXPECT_EQ(index.block_size(), uint64_t{100});
+  const Record entries[] = {{1000, 0}, {1030, 120}, {1030, 230}, {1050, 330}};
+  for (std::size_t i = 0; i < std::size(entries) && i < index.size(); ++i) {
+    EXPECT_EQ(index.timestamp(i), entries[i].timestamp);
+    EXPECT_EQ(index.offset(i), entries[i].offset);
+  }
+  EXPECT_EQ(index.time(0), datetime::datetime(1970, 1, 1, 0, 0, 0, 1000));
+
+  /* 第一个时间以及更早的时间 */
+  EXPECT_EQ(index.seek(1000), uint64_t{0});
+  EXPECT_EQ(index.seek(-5), uint64_t{0});
+  /* 不存在的时间 */
+  EXPECT_EQ(index.seek(1015), uint64_t{0});
+  EXPECT_EQ(index.seek(1040), uint64_t{230});
+  /* 重复的时间跨越了两个块，从第一个块之前开始 */
+  EXPECT_EQ(index.seek(1030), uint64_t{0});
+  EXPECT_EQ(index.lower_bound(1030), std::size_t{1});
+  /* 最后一个时间以及更晚的时间 */
+  EXPECT_EQ(index.seek(1050), uint64_t{230});
+  EXPECT_EQ(index.seek(1051), uint64_t{330});
+  EXPECT_EQ(index.lower_bound(1051), std::size_t{4});
+  for (long long ts = 990; ts <= 1060; ++ts) {
+    check_seek(index, records, ts);
+  }
+
+  /* 每条记录都有索引项 */
+  auto dense = build(records, 0);
+  EXPECT_EQ(dense.size(), records.size());
+  EXPECT_EQ(dense.seek(1030), uint64_t{80});
+  EXPECT_EQ(dense.seek(datetime::datetime(1970, 1, 1, 0, 0, 0, 1050)), uint64_t{230});
+
+  auto empty = build({}, 100);
+  EXPECT_EQ(empty.size(), std::size_t{0});
+  EXPECT_EQ(empty.seek(0), uint64_t{0});
+
+  time_index_writer writer(index_path(), 100);
+  writer.add(1000, 100);
+  EXPECT_THROW(writer.add(999, 200), std::invalid_argument);
+  EXPECT_THROW(writer.add(1000, 99), std::invalid_argument);
+  writer.add(1000, 100);
+  EXPECT_EQ(writer.size(), std::size_t{1});
+}
+
+/* 时间成簇分布并且有大量重复，插值和二分交替进行 */
+static void check_random() {
+  std::mt19937_64 rng(39);
+  std::vector<Record> records;
+  long long ts = -1'000'000'000;
+  uint64_t offset = 0;
+  for (int i = 0; i < 200000; ++i) {
+    int kind = static_cast<int>(rng() % 100);
+    ts += kind < 30 ? 0 : kind < 99 ? static_cast<long long>(rng() % 1000) : 1LL << 40;
+    records.push_back({ts, offset});
+    offset += rng() % 200 + 1;
+  }
+  auto index = build(records, 4096);
+  EXPECT_TRUE(index.size() > 1000);
+
+  std::vector<long long> timestamps;
+  for (std::size_t i = 0; i < index.size(); ++i) {
+    timestamps.push_back(index.timestamp(i));
+  }
+  for (int i = 0; i < 2000; ++i) {
+    /* 存在的时间，或者范围内外的任意时间 */
+    uint64_t range = static_cast<uint64_t>(ts - records.front().timestamp + 20);
+    long long q = i % 2 ? records[rng() % records.size()].timestamp
+                        : records.front().timestamp - 10 + static_cast<long long>(rng() % range);
+    auto expected = std::lower_bound(timestamps.begin(), timestamps.end(), q) - timestamps.begin();
+    EXPECT_EQ(index.lower_bound(q), static_cast<std::size_t>(expected));
+    if (i % 20 == 0) {
+      check_seek(index, records, q);
+    }
+  }
+}
+
+static void write_file(const std::vector<uint8_t>& bytes) {
+  FILE* f = std::fopen(index_path().c_str(), "wb");
+  std::fwrite(bytes.data(), 1, bytes.size(), f);
+  std::fclose(f);
+}
+
+static void check_invalid_file() {
+  build({{1, 0}, {2, 100}}, 100);
+  std::vector<uint8_t> bytes(24 + 32);
+  {
+    FILE* f = std::fopen(index_path().c_str(), "rb");
+    EXPECT_EQ(std::fread(bytes.data(), 1, bytes.size(), f), bytes.size());
+    std::fclose(f);
+  }
+
+  auto bad = bytes;
+  bad[0] = 'X';
+  write_file(bad);
+  EXPECT_THROW(time_index{index_path()}, std::invalid_argument);
+  /* 个数与文件长度不一致 */
+  bad = bytes;
+  bad[16] = 3;
+  write_file(bad);
+  EXPECT_THROW(time_index{index_path()}, std::invalid_argument);
+  /* 截断的索引项 */
+  bad = bytes;
+  bad.pop_back();
+  write_file(bad);
+  EXPECT_THROW(time_index{index_path()}, std::invalid_argument);
+  /* 截断的头部 */
+  bad.resize(23);
+  write_file(bad);
+  EXPECT_THROW(time_index{index_path()}, std::invalid_argument);
+
+  write_file(bytes);
+  time_index index(index_path());
+  time_index moved(std::move(index));
+  EXPECT_EQ(moved.size(), std::size_t{2});
+  EXPECT_EQ(index.size(), std::size_t{0});
+
+  std::filesystem::remove(index_path());
+  EXPECT_THROW(time_index{index_path()}, std::runtime_error);
+}
+
+int main() {
+  check_builder();
+  check_random();
+  check_invalid_file();
+  return test_result("test_time_index");
+}
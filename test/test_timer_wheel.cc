@@ -0,0 +1,177 @@
+// timer_wheel在各层的放置、跨层轮转、轮转前后的取消以及恰好在当前tick到期的定时器，
+// 并在随机的add/cancel/advance下与按到期tick排序的std::multimap比较
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <stdexcept>
+
+#include "test_check.h"
+#include "timer_wheel.h"
+
+using datetime::timedelta;
+using datetime::timer_wheel;
+
+static const datetime::datetime kStart(2024, 1, 2, 9, 30);
+
+/* resolution为1ms，第n个tick的时间 */
+static datetime::datetime at_tick(long long n, long long extra_us = 0) {
+  return kStart + timedelta(std::chrono::microseconds{n * 1000 + extra_us});
+}
+
+/* 每层的第一个和最后一个槽，以及超出最高层范围的定时器，都恰好在到期的tick到期 */
+static void check_levels() {
+  const long long delays[] = {1,       2,         255,         256,         257,
+                              65535,   65536,     65537,       (1LL << 24) - 1,
+                              1 << 24, (1 << 24) + 5, (1LL << 26) + 3};
+  for (long long delay : delays) {
+    timer_wheel wheel(kStart, timedelta(0, 0, 1000));
+    /* 从不对齐的位置开始 */
+    std::vector<uint64_t> expired;
+    wheel.advance(at_tick(77), &expired);
+    wheel.add(at_tick(77 + delay), static_cast<uint64_t>(delay));
+    EXPECT_EQ(wheel.size(), std::size_t{1});
+
+    EXPECT_EQ(wheel.advance(at_tick(77 + delay - 1, 999), &expired), std::size_t{0});
+    EXPECT_EQ(wheel.current_time(), at_tick(77 + delay - 1));
+    EXPECT_EQ(wheel.advance(at_tick(77 + delay), &expired), std::size_t{1});
+    EXPECT_EQ(expired, std::vector<uint64_t>{static_cast<uint64_t>(delay)});
+    EXPECT_TRUE(wheel.empty());
+  }
+}
+
+static void check_cancel() {
+  timer_wheel wheel(kStart, timedelta(0, 0, 1000));
+  std::vector<uint64_t> expired;
+
+  /* 第1层的定时器在轮转之前取消 */
+  auto before = wheel.add(at_tick(300), 1);
+  /* 在tick 256被轮转到第0层之后取消 */
+  auto after = wheel.add(at_tick(300), 2);
+  /* 第2层的定时器在轮转到第1层、再到第0层之后取消 */
+  auto level2 = wheel.add(at_tick(70000), 3);
+  auto kept = wheel.add(at_tick(70000), 4);
+
+  EXPECT_TRUE(wheel.cancel(before));
+  EXPECT_TRUE(!wheel.cancel(before));
+  wheel.advance(at_tick(256), &expired);
+  EXPECT_TRUE(wheel.cancel(after));
+  EXPECT_EQ(wheel.advance(at_tick(300), &expired), std::size_t{0});
+
+  wheel.advance(at_tick(65536), &expired);
+  wheel.advance(at_tick(69888), &expired);
+  EXPECT_TRUE(wheel.cancel(level2));
+  EXPECT_EQ(wheel.size(), std::size_t{1});
+  EXPECT_EQ(wheel.advance(at_tick(70000), &expired), std::size_t{1});
+  EXPECT_EQ(expired, std::vector<uint64_t>{4});
+
+  /* 已经到期的定时器 */
+  EXPECT_TRUE(!wheel.cancel(kept));
+
+  /* 节点被重用后，旧的id不能取消新的定时器 */
+  auto reused = wheel.add(timedelta(0, 1), 5);
+  EXPECT_TRUE(!wheel.cancel(kept));
+  EXPECT_TRUE(!wheel.cancel(level2));
+  EXPECT_EQ(wheel.size(), std::size_t{1});
+  EXPECT_TRUE(wheel.cancel(reused));
+  EXPECT_TRUE(!wheel.cancel(0xdeadbeef));
+}
+
+static void check_expire_on_now() {
+  timer_wheel wheel(kStart, timedelta(0, 0, 1000));
+  std::vector<uint64_t> expired;
+  wheel.add(at_tick(5), 1);
+  /* 不足1ms的部分向上取整到下一个tick */
+  wheel.add(at_tick(5, 1), 2);
+  EXPECT_EQ(wheel.advance(at_tick(4, 999), &expired), std::size_t{0});
+  EXPECT_EQ(wheel.advance(at_tick(5), &expired), std::size_t{1});
+  EXPECT_EQ(wheel.advance(at_tick(5, 999), &expired), std::size_t{0});
+  EXPECT_EQ(wheel.advance(at_tick(6), &expired), std::size_t{1});
+  EXPECT_EQ(expired, (std::vector<uint64_t>{1, 2}));
+
+  /* deadline为当前tick或已经过去的定时器在下一个tick到期 */
+  expired.clear();
+  wheel.add(wheel.current_time(), 3);
+  wheel.add(at_tick(1), 4);
+  wheel.add(timedelta(0), 5);
+  wheel.add(timedelta(0, 0, -1), 6);
+  EXPECT_EQ(wheel.size(), std::size_t{4});
+  EXPECT_EQ(wheel.advance(at_tick(6), &expired), std::size_t{0});
+  EXPECT_EQ(wheel.advance(at_tick(7), &expired), std::size_t{4});
+  std::sort(expired.begin(), expired.end());
+  EXPECT_EQ(expired, (std::vector<uint64_t>{3, 4, 5, 6}));
+
+  /* 时间倒退时不推进 */
+  EXPECT_EQ(wheel.advance(kStart - timedelta(1), &expired), std::size_t{0});
+  EXPECT_EQ(wheel.current_time(), at_tick(7));
+
+  EXPECT_THROW(timer_wheel(kStart, timedelta(0)), std::invalid_argument);
+}
+
+/* 随机的add/cancel/advance，到期的定时器与multimap中到期tick <= 目标tick的定时器一致 */
+static void check_random() {
+  std::mt19937_64 rng(30);
+  timer_wheel wheel(kStart, timedelta(0, 0, 1000));
+  /* 到期tick -> data */
+  std::multimap<long long, uint64_t> expected;
+  std::map<uint64_t, std::pair<timer_wheel::timer_id, long long>> pending;
+  long long now = 0;
+  uint64_t next_data = 0;
+  std::vector<uint64_t> expired;
+
+  for (int round = 0; round < 20000; ++round) {
+    int op = static_cast<int>(rng() % 8);
+    if (op < 4) {
+      /* 延迟在各层之间按指数分布，最长超出最高层的范围 */
+      long long delay = static_cast<long long>(rng() % (1ULL << (rng() % 27)));
+      long long expire = std::max(now + delay, now + 1);
+      auto id = wheel.add(at_tick(now + delay), next_data);
+      expected.emplace(expire, next_data);
+      pending[next_data] = {id, expire};
+      ++next_data;
+    } else if (op < 5 && !pending.empty()) {
+      auto it = pending.lower_bound(rng() % next_data);
+      if (it == pending.end()) {
+        it = pending.begin();
+      }
+      EXPECT_TRUE(wheel.cancel(it->second.first));
+      auto [lo, hi] = expected.equal_range(it->second.second);
+      for (; lo != hi; ++lo) {
+        if (lo->second == it->first) {
+          expected.erase(lo);
+          break;
+        }
+      }
+      pending.erase(it);
+    } else {
+      now += static_cast<long long>(rng() % (1ULL << (rng() % 20)));
+      expired.clear();
+      wheel.advance(at_tick(now), &expired);
+
+      std::vector<std::pair<long long, uint64_t>> actual;
+      for (uint64_t data : expired) {
+        actual.emplace_back(pending.count(data) ? pending[data].second : -1, data);
+        pending.erase(data);
+      }
+      /* 按到期的tick顺序，同一tick内的顺序不确定 */
+      EXPECT_TRUE(std::is_sorted(actual.begin(), actual.end(),
+                                 [](auto& a, auto& b) { return a.first < b.first; }));
+      std::sort(actual.begin(), actual.end());
+
+      std::vector<std::pair<long long, uint64_t>> want(expected.begin(),
+                                                       expected.upper_bound(now));
+      expected.erase(expected.begin(), expected.upper_bound(now));
+      std::sort(want.begin(), want.end());
+      EXPECT_TRUE(actual == want);
+    }
+    EXPECT_EQ(wheel.size(), expected.size());
+  }
+}
+
+int main() {
+  check_levels();
+  check_cancel();
+  check_expire_on_now();
+  check_random();
+  return test_result("test_timer_wheel");
+}
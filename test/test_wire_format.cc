@@ -0,0 +1,136 @@
+// wire_format的往返、字节布局、编码的顺序，以及超出范围的编码和截断的输入
+
+#include <climits>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+#include "test_check.h"
+#include "wire_format.h"
+
+using datetime::date;
+using datetime::from_bytes;
+using datetime::kWireSize;
+using datetime::timedelta;
+using datetime::to_bytes;
+
+template <class T>
+static void check_round_trip(const T& value) {
+  uint8_t buf[kWireSize<T> + 1];
+  buf[kWireSize<T>] = 0xa5;
+  to_bytes(value, buf);
+  EXPECT_EQ(buf[kWireSize<T>], 0xa5);
+  EXPECT_EQ(from_bytes<T>(buf), value);
+  EXPECT_EQ(from_bytes<T>(buf, kWireSize<T>), value);
+  EXPECT_THROW(from_bytes<T>(buf, kWireSize<T> - 1), std::invalid_argument);
+  EXPECT_THROW(from_bytes<T>(buf, 0), std::invalid_argument);
+}
+
+static void check_values() {
+  std::mt19937_64 rng(38);
+  check_round_trip(date::min());
+  check_round_trip(date::max());
+  check_round_trip(datetime::time::min());
+  check_round_trip(datetime::time::max());
+  check_round_trip(datetime::datetime::min());
+  check_round_trip(datetime::datetime::max());
+  check_round_trip(datetime::datetime(1969, 12, 31, 23, 59, 59, 999999));
+  check_round_trip(timedelta::min());
+  check_round_trip(timedelta(datetime::kMaxDeltaDays, 86399, 999999));
+  check_round_trip(timedelta(0, 0, -1));
+  for (int i = 0; i < 10000; ++i) {
+    auto d = date::fromordinal(static_cast<int>(rng() % datetime::kMaxOrdinal) + 1);
+    datetime::time t(static_cast<int>(rng() % 24), static_cast<int>(rng() % 60),
+                     static_cast<int>(rng() % 60), static_cast<int>(rng() % 1000000));
+    check_round_trip(d);
+    check_round_trip(t);
+    check_round_trip(datetime::datetime::combine(d, t));
+    check_round_trip(timedelta(static_cast<int>(rng() % 2000001) - 1000000,
+                               static_cast<int>(rng() % 86400), static_cast<int>(rng() % 1000000)));
+  }
+}
+
+/* 小端，与平台无关 */
+static void check_layout() {
+  uint8_t buf[12];
+  to_bytes(date(1, 1, 1), buf);
+  EXPECT_TRUE(std::memcmp(buf, "\x01\x00\x00\x00", 4) == 0);
+  to_bytes(datetime::time(0, 0, 1, 2), buf);
+  EXPECT_TRUE(std::memcmp(buf, "\x42\x42\x0f\x00\x00\x00\x00\x00", 8) == 0);
+  to_bytes(datetime::datetime(1970, 1, 1), buf);
+  EXPECT_TRUE(std::memcmp(buf, "\x00\x00\x00\x00\x00\x00\x00\x00", 8) == 0);
+  to_bytes(datetime::datetime(1969, 12, 31, 23, 59, 59, 999999), buf);
+  EXPECT_TRUE(std::memcmp(buf, "\xff\xff\xff\xff\xff\xff\xff\xff", 8) == 0);
+  /* -1us为-1天 + 86399秒 + 999999微秒 */
+  to_bytes(timedelta(0, 0, -1), buf);
+  EXPECT_TRUE(std::memcmp(buf, "\xff\xff\xff\xff\x7f\x51\x01\x00\x3f\x42\x0f\x00", 12) == 0);
+}
+
+/* datetime的编码作为有符号整数比较的顺序与值一致，datetime_view直接比较编码 */
+static void check_order() {
+  const datetime::datetime values[] = {
+      datetime::datetime::min(), datetime::datetime(1969, 12, 31, 23, 59, 59, 999999),
+      datetime::datetime(1970, 1, 1), datetime::datetime(1970, 1, 1, 0, 0, 0, 1),
+      datetime::datetime(2024, 2, 29, 12), datetime::datetime::max()};
+  uint8_t buf[std::size(values)][8];
+  for (std::size_t i = 0; i < std::size(values); ++i) {
+    to_bytes(values[i], buf[i]);
+  }
+  for (std::size_t i = 0; i < std::size(values); ++i) {
+    datetime::datetime_view view(buf[i]);
+    EXPECT_EQ(view.value(), values[i]);
+    EXPECT_TRUE(view == values[i]);
+    for (std::size_t j = 0; j < std::size(values); ++j) {
+      datetime::datetime_view other(buf[j]);
+      EXPECT_TRUE((view <=> other) == (i <=> j));
+      EXPECT_TRUE((view <=> values[j]) == (i <=> j));
+    }
+  }
+}
+
+/* 超出范围或者没有规范化的编码 */
+static void check_invalid() {
+  uint8_t buf[12];
+  auto store = [&](std::size_t offset, uint64_t v, int n) {
+    for (int i = 0; i < n; ++i) {
+      buf[offset + i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+  };
+
+  for (long long ordinal : {0LL, -1LL, datetime::kMaxOrdinal + 1LL, LLONG_MIN}) {
+    store(0, static_cast<uint64_t>(ordinal), 4);
+    EXPECT_THROW(from_bytes<date>(buf), std::out_of_range);
+    EXPECT_THROW(from_bytes<date>(buf, 4), std::out_of_range);
+  }
+  for (long long us : {-1LL, 86400LL * 1000000, LLONG_MAX}) {
+    store(0, static_cast<uint64_t>(us), 8);
+    EXPECT_THROW(from_bytes<datetime::time>(buf), std::out_of_range);
+  }
+  const long long max_us = datetime::datetime::max().utctimestamp().count();
+  const long long min_us = datetime::datetime::min().utctimestamp().count();
+  for (long long us : {max_us + 1, min_us - 1, LLONG_MIN}) {
+    store(0, static_cast<uint64_t>(us), 8);
+    EXPECT_THROW(from_bytes<datetime::datetime>(buf), std::out_of_range);
+  }
+
+  const long long deltas[][3] = {{0, 86400, 0},
+                                 {0, -1, 0},
+                                 {0, 0, 1000000},
+                                 {0, 0, -1},
+                                 {datetime::kMaxDeltaDays + 1LL, 0, 0},
+                                 {-datetime::kMaxDeltaDays - 1LL, 0, 0}};
+  for (const auto& [days, seconds, us] : deltas) {
+    store(0, static_cast<uint64_t>(days), 4);
+    store(4, static_cast<uint64_t>(seconds), 4);
+    store(8, static_cast<uint64_t>(us), 4);
+    EXPECT_THROW(from_bytes<timedelta>(buf), std::out_of_range);
+  }
+}
+
+int main() {
+  check_values();
+  check_layout();
+  check_order();
+  check_invalid();
+  return test_result("test_wire_format");
+}
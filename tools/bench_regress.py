@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+"""Benchmark regression check for datetime_bench.
+
+Runs datetime_bench with repetitions, reduces every benchmark to the median
+and the median absolute deviation (MAD) of its per-iteration CPU time, and
+compares the medians against a committed baseline.  A benchmark regresses
+when its median is slower than the baseline by more than both the relative
+threshold and the combined noise (MAD) of the two measurements.
+
+Usage:
+    # compare against bench/baseline.json, exit 1 on regression
+    tools/bench_regress.py --bench build/bin/datetime_bench
+
+    # record a new baseline
+    tools/bench_regress.py --bench build/bin/datetime_bench --update
+
+    # compare a previously saved Google Benchmark JSON file instead of running
+    tools/bench_regress.py --input results.json
+
+A tracked benchmark that is absent from the run fails the check as well,
+unless --allow-missing is given.  --report-only prints the table and always
+exits 0.
+"""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_BASELINE = os.path.join(ROOT, "bench", "baseline.json")
+# the core library operations in bench_datetime.cc
+DEFAULT_FILTER = "^BM_(Date|Time|Datetime|Timedelta)[A-Z]"
+
+TIME_UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def run_bench(bench, bench_filter, repetitions, min_time):
+    cmd = [
+        bench,
+        "--benchmark_filter=" + bench_filter,
+        "--benchmark_repetitions=%d" % repetitions,
+        "--benchmark_min_time=%s" % min_time,
+        "--benchmark_format=json",
+    ]
+    print("running: " + " ".join(cmd), file=sys.stderr)
+    out = subprocess.run(cmd, check=True, stdout=subprocess.PIPE).stdout
+    return json.loads(out)
+
+
+def summarize(results):
+    """name -> {"median": ns, "mad": ns, "runs": n} from individual repetitions."""
+    samples = {}
+    for b in results["benchmarks"]:
+        if b.get("run_type", "iteration") != "iteration":
+            continue
+        name = b.get("run_name", b["name"])
+        ns = b["cpu_time"] * TIME_UNITS[b.get("time_unit", "ns")]
+        samples.setdefault(name, []).append(ns)
+
+    summary = {}
+    for name, values in samples.items():
+        median = statistics.median(values)
+        mad = statistics.median([abs(v - median) for v in values])
+        summary[name] = {"median": median, "mad": mad, "runs": len(values)}
+    return summary
+
+
+def check_context(context, baseline_context=None):
+    """Warn about measurements that are not comparable with a release baseline."""
+    if context.get("library_build_type") == "debug":
+        print("warning: Google Benchmark is a debug build, timings include its assertions",
+              file=sys.stderr)
+    if baseline_context and baseline_context.get("host_name") != context.get("host_name"):
+        print("warning: baseline was recorded on %s, running on %s" %
+              (baseline_context.get("host_name"), context.get("host_name")), file=sys.stderr)
+
+
+def compare(baseline, current, threshold, noise_factor, allow_missing):
+    regressions = []
+    rows = []
+    for name in sorted(baseline):
+        base = baseline[name]
+        if name not in current:
+            # a renamed or deleted benchmark must not pass silently
+            rows.append((name, base["median"], None, None, "missing"))
+            if not allow_missing:
+                regressions.append(name)
+            continue
+        cur = current[name]
+        change = cur["median"] / base["median"] - 1.0
+        noise = noise_factor * (base["mad"] + cur["mad"]) / base["median"]
+        limit = max(threshold, noise)
+        if change > limit:
+            status = "REGRESSED"
+            regressions.append(name)
+        elif change < -limit:
+            status = "improved"
+        else:
+            status = "ok"
+        rows.append((name, base["median"], cur["median"], change, status, limit))
+
+    width = max([len(r[0]) for r in rows] + [9])
+    print("%-*s %12s %12s %9s %9s  %s" % (width, "benchmark", "base(ns)", "cur(ns)", "change",
+                                          "limit", "status"))
+    for r in rows:
+        if r[2] is None:
+            print("%-*s %12.2f %12s %9s %9s  %s" % (width, r[0], r[1], "-", "-", "-", r[4]))
+        else:
+            print("%-*s %12.2f %12.2f %+8.1f%% %8.1f%%  %s" %
+                  (width, r[0], r[1], r[2], r[3] * 100, r[5] * 100, r[4]))
+    for name in sorted(set(current) - set(baseline)):
+        print("%-*s %12s %12.2f %9s %9s  %s" % (width, name, "-", current[name]["median"], "-",
+                                                "-", "new"))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--bench", help="path of the datetime_bench executable")
+    parser.add_argument("--input", help="Google Benchmark JSON output to use instead of running")
+    parser.add_argument("--baseline", default=DEFAULT_BASELINE)
+    parser.add_argument("--filter", default=DEFAULT_FILTER, help="benchmarks to track")
+    parser.add_argument("--repetitions", type=int, default=9)
+    parser.add_argument("--min-time", default="0.1", help="seconds per repetition")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="relative slowdown always tolerated (default: 0.10)")
+    parser.add_argument("--noise-factor", type=float, default=3.0,
+                        help="tolerated slowdown in units of the combined MAD (default: 3)")
+    parser.add_argument("--allow-missing", action="store_true",
+                        help="do not fail when a baseline benchmark is absent from the run")
+    parser.add_argument("--report-only", action="store_true",
+                        help="print the comparison but always exit 0")
+    parser.add_argument("--update", action="store_true", help="write the results as the baseline")
+    args = parser.parse_args()
+
+    if args.input:
+        with open(args.input) as f:
+            results = json.load(f)
+    elif args.bench:
+        results = run_bench(args.bench, args.filter, args.repetitions, args.min_time)
+    else:
+        parser.error("one of --bench or --input is required")
+    current = summarize(results)
+    context = results.get("context", {})
+
+    if args.update:
+        check_context(context)
+        baseline = {
+            "context": {k: context.get(k) for k in ("host_name", "num_cpus", "mhz_per_cpu",
+                                                    "library_build_type")},
+            "benchmarks": current,
+        }
+        with open(args.baseline, "w") as f:
+            json.dump(baseline, f, indent=2, sort_keys=True)
+            f.write("\n")
+        print("baseline written to %s (%d benchmarks)" % (args.baseline, len(current)))
+        return 0
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    check_context(context, baseline.get("context"))
+    regressions = compare(baseline["benchmarks"], current, args.threshold, args.noise_factor,
+                          args.allow_missing)
+    if regressions:
+        print("\n%d benchmark(s) regressed or missing: %s" %
+              (len(regressions), ", ".join(regressions)))
+        return 0 if args.report_only else 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())